@@ -1,11 +1,15 @@
+#include <cstdio>
 #include "Game.h"
 #include "src/Config.h"
 #include "src/Utils/Math.h"
+#include "src/Utils/Profiler.h"
 #include "src/Utils/Texture.h"
 
-Game::Game() {
+Game::Game() : timestep(Config::Simulation::TICK_RATE, Config::Simulation::MAX_TICKS_PER_FRAME) {
     sf::ContextSettings settings;
     settings.depthBits = Config::Window::DEPTH_BITS; // Depth buffer
+    settings.majorVersion = Config::Window::OPENGL_MAJOR; // The world renderer needs GL 3.3 (compatibility profile)
+    settings.minorVersion = Config::Window::OPENGL_MINOR;
     window.create(sf::VideoMode(Config::Window::WIDTH, Config::Window::HEIGHT), Config::Window::TITLE, sf::Style::Default, settings);
     window.setFramerateLimit(Config::Window::FPS);
 
@@ -17,46 +21,99 @@ Game::Game() {
 void Game::run() {
     Texture::loadTextures();
 
+    Profiler::setThreadName("main");
+    Profiler::setEnabled(Config::Profiling::START_ENABLED);
+
     // Main game loop
     sf::Clock clock;
 
     running = true;
 
     while (window.isOpen()) {
+        PROFILE_ZONE("Game::run frame");
         window.clear(sf::Color::Black);
 
-        float deltaTime = clock.restart().asSeconds();
-
-        sf::Event event{};
+        float frameTime = clock.restart().asSeconds();
 
         // Process events (SFML still handles the window and input)
-        while (window.pollEvent(event)) {
-            switch (event.type) {
-                case sf::Event::Closed: {
-                    window.close();
-                    break;
-                }
-                case sf::Event::MouseButtonPressed: {
-                    if (event.mouseButton.button == sf::Mouse::Left)
-                        currentScene->onClick(window.mapPixelToCoords({event.mouseButton.x, event.mouseButton.y}));
-                    break;
-                }
-                case sf::Event::Resized: {
-                    currentScene->onResize(event.size.width, event.size.height);
-                    break;
+        {
+            PROFILE_ZONE("Game::run events");
+            sf::Event event{};
+            while (window.pollEvent(event)) {
+                switch (event.type) {
+                    case sf::Event::Closed: {
+                        currentScene->onClose();
+                        window.close();
+                        break;
+                    }
+                    case sf::Event::MouseButtonPressed: {
+                        if (event.mouseButton.button == sf::Mouse::Left)
+                            currentScene->onClick(window.mapPixelToCoords({event.mouseButton.x, event.mouseButton.y}));
+                        break;
+                    }
+                    case sf::Event::Resized: {
+                        currentScene->onResize(event.size.width, event.size.height);
+                        break;
+                    }
+                    case sf::Event::KeyPressed: {
+                        if (event.key.code == sf::Keyboard::F9) {
+                            toggleProfiler();
+                        } else {
+                            currentScene->onKeyPress(event.key.code);
+                        }
+                        break;
+                    }
+                    default:
+                        break;
                 }
-                default:
-                    break;
             }
         }
 
-        // Update game state
-        currentScene->update(deltaTime);
+        // Update game state in fixed ticks, as many as the real time since the last frame holds
+        int ticks = timestep.advance(frameTime);
+        for (int tick = 0; tick < ticks; tick++) {
+            PROFILE_ZONE("Game::run tick");
+            float deltaTime = timestep.getTickTime();
+            currentScene->update(deltaTime);
+        }
+
+        // Stream and integrate chunks once per frame, however many ticks ran
+        currentScene->frame(frameTime);
 
-        // Render your current scene (OpenGL rendering inside the scene)
-        currentScene->render();
+        // Render your current scene (OpenGL rendering inside the scene), between the last two ticks
+        currentScene->render(timestep.getAlpha());
+        reportRates();
 
         // Swap the buffers and display the rendered frame
+        PROFILE_ZONE("Game::run display");
         window.display();
     }
-}
\ No newline at end of file
+}
+
+void Game::reportRates() {
+    // The rates change once per second, the title only then
+    float tickRate = timestep.getMeasuredTickRate();
+    float frameRate = timestep.getMeasuredFrameRate();
+    if (tickRate == shownTickRate && frameRate == shownFrameRate) return;
+
+    shownTickRate = tickRate;
+    shownFrameRate = frameRate;
+
+    char rates[64];
+    std::snprintf(rates, sizeof(rates), " - %.0f ticks/s, %.0f fps", tickRate, frameRate);
+    window.setTitle(Config::Window::TITLE + rates);
+}
+
+void Game::toggleProfiler() {
+    // Start a fresh recording, or stop it and write what it recorded
+    if (!Profiler::isEnabled()) {
+        Profiler::clear();
+        Profiler::setEnabled(true);
+        return;
+    }
+
+    Profiler::setEnabled(false);
+    if (!Profiler::writeChromeTrace(Config::Profiling::TRACE_FILE)) {
+        std::fprintf(stderr, "Could not write the profile to %s\n", Config::Profiling::TRACE_FILE.c_str());
+    }
+}
@@ -3,12 +3,22 @@
 
 #include <SFML/Graphics.hpp>
 #include "src/UI/Scene.h"
+#include "src/Utils/FixedTimestep.h"
 #include <SFML/OpenGL.hpp>
 
 class Game {
 private:
     sf::RenderWindow window;
     Scene* currentScene;
+    FixedTimestep timestep;  // Ticks of the simulation, apart from the frames
+    float shownTickRate = 0.0f;
+    float shownFrameRate = 0.0f;
+
+    // Show the measured tick and frame rates in the window title
+    void reportRates();
+
+    // Start recording the profiler zones, or stop and write them to Config::Profiling::TRACE_FILE
+    void toggleProfiler();
 
 public:
     Game();
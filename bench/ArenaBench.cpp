@@ -0,0 +1,293 @@
+// Runs the mesh arena suballocation on the CPU with a synthetic churn of chunk loads and unloads: a player
+// walking in a straight line loads a column of chunks ahead and unloads one behind every step, while a few
+// sections are remeshed to a different size. Mesh sizes are taken from the sections of generated terrain.
+// It runs once from a small arena that grows as the chunks load, and once from an arena barely larger than
+// the loaded meshes, which has to compact.
+// Each arena is backed by a CPU buffer tagged with the owner of every element, the moves of each compaction
+// are applied to it and the tags are checked, so a wrong move or an overlap fails the bench.
+// Usage: arena_bench [radius in chunks] [steps] (defaults 12 and 400). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "../src/Config.h"
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Core/LightEngine.h"
+#include "../src/Utils/ArenaAllocator.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Same page size as the vertex arena of MeshArena
+    const std::size_t PAGE_VERTICES = 16;
+
+    // An allocator and the buffer it suballocates, with the fit policy of MeshArena:
+    // compact when the free space is enough once gathered, grow to twice the size otherwise
+    struct Arena {
+        ArenaAllocator allocator;
+        std::vector<std::uint32_t> buffer;  // Tag of the allocation owning every element
+        long long compactions = 0, growths = 0, movedElements = 0;
+        double allocateTime = 0.0, freeTime = 0.0, compactTime = 0.0;
+        long long allocations = 0, frees = 0;
+        long long requested = 0;  // Elements asked for, before the alignment
+        long long allocated = 0;  // Elements handed out, after it
+        double fragmentationSum = 0.0;
+        float worstFragmentation = 0.0f;
+
+        Arena(std::size_t capacity, std::size_t alignment) : allocator(capacity, alignment), buffer(allocator.getCapacity(), 0) {}
+
+        ArenaAllocator::Handle allocate(std::size_t count, std::uint32_t tag) {
+            auto start = std::chrono::steady_clock::now();
+            std::optional<ArenaAllocator::Handle> handle = allocator.allocate(count);
+            allocateTime += Bench::secondsSince(start);
+
+            if (!handle) {
+                start = std::chrono::steady_clock::now();
+                if (allocator.getCapacity() - allocator.getUsed() >= count) {
+                    for (const ArenaAllocator::Move& move : allocator.compact()) {
+                        std::memmove(&buffer[move.to], &buffer[move.from], move.size * sizeof(std::uint32_t));
+                        movedElements += static_cast<long long>(move.size);
+                    }
+                    compactions++;
+                    handle = allocator.allocate(count);
+                }
+                if (!handle) {
+                    allocator.grow(std::max(2 * allocator.getCapacity(), allocator.getUsed() + 2 * count));
+                    buffer.resize(allocator.getCapacity(), 0);
+                    growths++;
+                    handle = allocator.allocate(count);
+                }
+                compactTime += Bench::secondsSince(start);
+            }
+
+            std::fill_n(buffer.begin() + static_cast<std::ptrdiff_t>(allocator.getOffset(*handle)), allocator.getSize(*handle), tag);
+            allocations++;
+            requested += static_cast<long long>(count);
+            allocated += static_cast<long long>(allocator.getSize(*handle));
+            return *handle;
+        }
+
+        void free(ArenaAllocator::Handle handle) {
+            auto start = std::chrono::steady_clock::now();
+            allocator.free(handle);
+            freeTime += Bench::secondsSince(start);
+            frees++;
+        }
+
+        void sample() {
+            float fragmentation = allocator.getFragmentation();
+            fragmentationSum += fragmentation;
+            worstFragmentation = std::max(worstFragmentation, fragmentation);
+        }
+
+        // Check that every element of an allocation still holds its tag
+        [[nodiscard]] bool holds(ArenaAllocator::Handle handle, std::uint32_t tag) const {
+            std::size_t offset = allocator.getOffset(handle);
+            return std::all_of(buffer.begin() + static_cast<std::ptrdiff_t>(offset),
+                               buffer.begin() + static_cast<std::ptrdiff_t>(offset + allocator.getSize(handle)),
+                               [tag](std::uint32_t value) { return value == tag; });
+        }
+    };
+
+    // Vertex and index counts of one render layer of a section mesh
+    struct LayerSize {
+        std::size_t vertices;
+        std::size_t indices;
+    };
+
+    // A render layer of a loaded chunk in both arenas
+    struct LayerAllocation {
+        ArenaAllocator::Handle vertices;
+        ArenaAllocator::Handle indices;
+        std::uint32_t tag;
+    };
+
+    // Section layer sizes of generated chunks, one list per chunk
+    std::vector<std::vector<LayerSize>> sampleChunks() {
+        const int radius = 3;
+        const int width = 2 * radius + 1;
+        const int chunkSize = ChunkStorage::SIZE;
+        PerlinNoise noiseGenerator(1337);
+        std::vector<Chunk> chunks(width * width);
+        auto at = [&](int x, int z) -> Chunk& { return chunks[(x + radius) * width + (z + radius)]; };
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) at(x, z).generate(x * chunkSize, z * chunkSize, noiseGenerator);
+        }
+
+        // Lit like World does, since the shading of the faces decides which of them merge
+        LightEngine lightEngine;
+        for (Chunk& chunk : chunks) lightEngine.lightChunk(chunk);
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) {
+                LightEngine::Neighbourhood neighbourhood{};
+                for (int dz = -1; dz <= 1; dz++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        bool inside = std::abs(x + dx) <= radius && std::abs(z + dz) <= radius;
+                        neighbourhood[(dz + 1) * 3 + dx + 1] = inside ? &at(x + dx, z + dz) : nullptr;
+                    }
+                }
+                lightEngine.stitch(neighbourhood);
+            }
+        }
+
+        std::vector<std::vector<LayerSize>> samples;
+        for (int x = 1 - radius; x < radius; x++) {
+            for (int z = 1 - radius; z < radius; z++) {
+                ChunkMesher::Neighbours neighbours = {&at(x - 1, z).getStorage(), &at(x + 1, z).getStorage(),
+                                                      &at(x, z - 1).getStorage(), &at(x, z + 1).getStorage()};
+                ChunkMesher::Light light{&at(x, z).getLight(), {&at(x - 1, z).getLight(), &at(x + 1, z).getLight(),
+                                                                &at(x, z - 1).getLight(), &at(x, z + 1).getLight()}};
+                std::vector<LayerSize>& sizes = samples.emplace_back();
+                for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                    if (at(x, z).getStorage().isSectionEmpty(section)) continue;
+
+                    ChunkMeshData mesh = ChunkMesher::build(ChunkMesher::gather(at(x, z).getStorage(), neighbours, section, 0, light), section);
+                    for (const MeshData& layer : mesh.layers) {
+                        if (!layer.indices.empty()) sizes.push_back({layer.vertices.size(), layer.indices.size()});
+                    }
+                }
+            }
+        }
+        return samples;
+    }
+
+    // Result of a churn run
+    struct Churn {
+        bool intact = true;
+        long long compactions = 0;
+        double stepTime = 0.0;
+    };
+
+    // Load the chunks around the player, walk and remesh for a number of steps, print a row per arena
+    Churn churn(const std::vector<std::vector<LayerSize>>& samples, int radius, int steps, std::size_t vertexCapacity,
+                std::size_t indexCapacity, const char* label) {
+        std::mt19937 generator(99);
+        std::uniform_int_distribution<std::size_t> pickSample(0, samples.size() - 1);
+
+        Arena vertexArena(vertexCapacity, PAGE_VERTICES);
+        Arena indexArena(indexCapacity, 1);
+
+        const int width = 2 * radius + 1;
+        std::vector<std::vector<LayerAllocation>> loaded;  // Columns of chunks around the player, reused as a ring
+        std::uint32_t nextTag = 1;
+
+        auto loadChunk = [&]() {
+            std::vector<LayerAllocation> layers;
+            for (const LayerSize& size : samples[pickSample(generator)]) {
+                std::uint32_t tag = nextTag++;
+                layers.push_back({vertexArena.allocate(size.vertices, tag), indexArena.allocate(size.indices, tag), tag});
+            }
+            return layers;
+        };
+        auto unloadChunk = [&](std::vector<LayerAllocation>& layers) {
+            for (const LayerAllocation& layer : layers) {
+                vertexArena.free(layer.vertices);
+                indexArena.free(layer.indices);
+            }
+            layers.clear();
+        };
+        auto checkLoaded = [&]() {
+            for (const std::vector<LayerAllocation>& chunk : loaded) {
+                for (const LayerAllocation& layer : chunk) {
+                    if (!vertexArena.holds(layer.vertices, layer.tag) || !indexArena.holds(layer.indices, layer.tag)) return false;
+                }
+            }
+            return true;
+        };
+
+        Churn result;
+        for (int i = 0; i < width * width; i++) loaded.push_back(loadChunk());
+        result.intact = checkLoaded();
+
+        // Walk: the column behind is unloaded, the one ahead loaded, and a few sections are remeshed
+        std::uniform_int_distribution<std::size_t> pickChunk(0, loaded.size() - 1);
+        const int remeshesPerStep = 8;
+        auto start = std::chrono::steady_clock::now();
+        for (int step = 0; step < steps; step++) {
+            int column = step % width;
+            for (int z = 0; z < width; z++) {
+                std::vector<LayerAllocation>& chunk = loaded[column * width + z];
+                unloadChunk(chunk);
+                chunk = loadChunk();
+            }
+
+            for (int i = 0; i < remeshesPerStep; i++) {
+                std::vector<LayerAllocation>& chunk = loaded[pickChunk(generator)];
+                if (chunk.empty()) continue;
+
+                LayerAllocation& layer = chunk[generator() % chunk.size()];
+                const std::vector<LayerSize>& sample = samples[pickSample(generator)];
+                const LayerSize& size = sample[generator() % sample.size()];
+                vertexArena.free(layer.vertices);
+                indexArena.free(layer.indices);
+                layer.tag = nextTag++;
+                layer.vertices = vertexArena.allocate(size.vertices, layer.tag);
+                layer.indices = indexArena.allocate(size.indices, layer.tag);
+            }
+
+            vertexArena.sample();
+            indexArena.sample();
+            if (step % 50 == 49) result.intact = result.intact && checkLoaded();
+        }
+        result.stepTime = Bench::secondsSince(start) / steps;
+        result.intact = result.intact && checkLoaded();
+        result.compactions = vertexArena.compactions + indexArena.compactions;
+
+        for (const auto& [name, arena] : {std::pair<const char*, const Arena*>{"vertices", &vertexArena}, {"indices", &indexArena}}) {
+            const ArenaAllocator& allocator = arena->allocator;
+            long long operations = arena->allocations + arena->frees;
+            std::printf("%-7s %-8s %9zu %8.1f%% %8.1f%% %7.1f%% %6lld %9lld %9lld %11.3f %10.2f\n", label, name,
+                        allocator.getCapacity(), 100.0 * allocator.getUsed() / allocator.getCapacity(),
+                        100.0 * arena->fragmentationSum / steps, 100.0 * arena->worstFragmentation, arena->growths,
+                        arena->compactions, arena->movedElements,
+                        arena->compactions + arena->growths > 0 ? arena->compactTime * 1e3 / (arena->compactions + arena->growths) : 0.0,
+                        operations / (arena->allocateTime + arena->freeTime) / 1e6);
+        }
+        std::printf("%-7s churn %.2f ms/step (with the CPU copies of the compactions), page alignment waste %.1f%% of the vertices\n",
+                    label, result.stepTime * 1e3,
+                    100.0 * (1.0 - static_cast<double>(vertexArena.requested) / static_cast<double>(vertexArena.allocated)));
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int radius = argc > 1 ? std::atoi(argv[1]) : 12;
+    const int steps = argc > 2 ? std::atoi(argv[2]) : 400;
+    if (radius < 1 || steps < 1) {
+        std::fprintf(stderr, "usage: %s [radius in chunks] [steps]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::vector<LayerSize>> samples = sampleChunks();
+
+    // Elements of the chunks in range on average, to size an arena that barely holds them
+    std::size_t vertices = 0, indices = 0;
+    for (const std::vector<LayerSize>& sample : samples) {
+        for (const LayerSize& size : sample) {
+            vertices += (size.vertices + PAGE_VERTICES - 1) / PAGE_VERTICES * PAGE_VERTICES;
+            indices += size.indices;
+        }
+    }
+    const std::size_t loadedChunks = static_cast<std::size_t>(2 * radius + 1) * (2 * radius + 1);
+    vertices = vertices * loadedChunks / samples.size();
+    indices = indices * loadedChunks / samples.size();
+
+    std::printf("radius %d chunks (%zu loaded), %d steps, 8 remeshes per step, %zu sampled chunks\n", radius, loadedChunks,
+                steps, samples.size());
+    std::printf("%-7s %-8s %9s %9s %9s %8s %6s %9s %9s %11s %10s\n", "start", "arena", "capacity", "utilized", "avg frag",
+                "max frag", "grows", "compacts", "moved", "ms/relocate", "Mops/s");
+
+    // From a small arena, growing as the chunks load; then from one 5% larger than the chunks need, which
+    // has to compact to make room
+    Churn small = churn(samples, radius, steps, Config::World::MESH_ARENA_VERTICES / 16, Config::World::MESH_ARENA_INDICES / 16, "small");
+    Churn tight = churn(samples, radius, steps, vertices * 21 / 20, indices * 21 / 20, "tight");
+
+    Bench::check(small.intact && tight.intact, "every loaded mesh keeps its data through allocations, frees and compactions");
+    Bench::check(tight.compactions > 0, "the tight arena compacts");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
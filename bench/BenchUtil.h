@@ -0,0 +1,53 @@
+#ifndef MINECRAFTCLONE_BENCHUTIL_H
+#define MINECRAFTCLONE_BENCHUTIL_H
+
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "../src/Core/World.h"
+
+// Helpers shared by the benches: the failed check counter, timing, and loading a world before measuring it
+namespace Bench {
+    // Checks that failed so far (a bench returns nonzero if there is any)
+    inline int failures = 0;
+
+    // Print a check that does not hold and count it
+    inline void check(bool condition, const char* description) {
+        if (!condition) {
+            std::printf("FAILED: %s\n", description);
+            failures++;
+        }
+    }
+
+    // Get the seconds elapsed since a point in time
+    inline double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Load the chunks within a radius (in chunks) of the player's chunk, updating the world until the workers
+    // generated them all, and return their positions
+    inline std::vector<sf::Vector2i> loadChunksAround(World& world, const sf::Vector3f& player, int radius) {
+        const float chunkSize = static_cast<float>(world.getChunkSize());
+        sf::Vector2i center(static_cast<int>(std::floor(player.x / chunkSize)), static_cast<int>(std::floor(player.z / chunkSize)));
+
+        std::vector<sf::Vector2i> positions;
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) {
+                if (x * x + z * z > radius * radius) continue;
+                sf::Vector2i position = center + sf::Vector2i(x, z);
+                while (!world.getChunk(position)) {
+                    world.update(0.0f, player);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                positions.push_back(position);
+            }
+        }
+        return positions;
+    }
+}
+
+
+#endif
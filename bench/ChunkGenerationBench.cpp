@@ -0,0 +1,121 @@
+// Measures chunk generation time with the BlockRegistry (voxels are plain type ids) against the
+// previous path, where every generated voxel built a Block through string-keyed texture lookups.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include "../src/Core/Chunk.h"
+#include "../src/Config.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Block layout and texture lookup used before the registry
+    struct LegacyBlock {
+        BlockType type = BlockType::AIR;
+        sf::Vector3i position;
+        bool isVisible = false;
+        bool isOpaque = false;
+        bool isSolid = false;
+        std::vector<sf::IntRect> textures;
+        std::vector<int> textureRotation;
+    };
+
+    sf::IntRect legacyTextureCoords(const std::string& name) {
+        const int tileSize = 16;
+
+        if (name == "dirt") return {0, 0, tileSize, tileSize};
+        else if (name == "grass_side") return {16, 0, tileSize, tileSize};
+        else if (name == "grass") return {32, 0, tileSize, tileSize};
+        else if (name == "stone") return {48, 0, tileSize, tileSize};
+        else if (name == "cobblestone") return {64, 0, tileSize, tileSize};
+        else if (name == "planks") return {80, 0, tileSize, tileSize};
+        else if (name == "log") return {96, 0, tileSize, tileSize};
+        else if (name == "log_top") return {112, 0, tileSize, tileSize};
+        else if (name == "leaves") return {0, 16, tileSize, tileSize};
+        else return {112, 112, tileSize, tileSize};
+    }
+
+    LegacyBlock legacyBlock(BlockType type, const sf::Vector3i& position) {
+        LegacyBlock block;
+        block.type = type;
+        block.position = position;
+        block.isVisible = block.isOpaque = block.isSolid = true;
+
+        if (type == BlockType::GRASS) {
+            block.textures = {legacyTextureCoords("grass_side"), legacyTextureCoords("grass_side"),
+                              legacyTextureCoords("dirt"), legacyTextureCoords("grass"),
+                              legacyTextureCoords("grass_side"), legacyTextureCoords("grass_side")};
+            block.textureRotation = {0, 90, 0, 0, 90, 0};
+        } else {
+            std::string name = type == BlockType::DIRT ? "dirt" : "stone";
+            block.textures = std::vector<sf::IntRect>(6, legacyTextureCoords(name));
+            block.textureRotation = {180, -90, 0, 0, -90, 180};
+        }
+        return block;
+    }
+
+    // Same terrain as Chunk::generate, stored the way chunks were stored before
+    void legacyGenerate(std::unordered_map<sf::Vector3i, LegacyBlock>& blocks, int xOffset, int zOffset,
+                        const PerlinNoise& noiseGenerator) {
+        const int chunkSize = Config::World::CHUNK_SIZE;
+
+        for (int x = 0; x < chunkSize; x++) {
+            for (int z = 0; z < chunkSize; z++) {
+                int worldX = xOffset + x;
+                int worldZ = zOffset + z;
+
+                float noiseValue = 0.0f;
+                float amplitude = 1.0f;
+                float maxValue = 0.0f;
+                for (int octave = 0; octave < 4; octave++) {
+                    float freq = 0.05f * std::pow(2.0f, octave);
+                    noiseValue += noiseGenerator.noise(worldX * freq, worldZ * freq, 0.5f) * amplitude;
+                    maxValue += amplitude;
+                    amplitude *= 0.5f;
+                }
+                int groundHeight = static_cast<int>(noiseValue / maxValue * 20.0f);
+
+                for (int y = 0; y < groundHeight; y++) {
+                    sf::Vector3i blockPos(worldX, y, worldZ);
+                    BlockType type = y == groundHeight - 1 ? BlockType::GRASS
+                                   : y >= groundHeight - 4 ? BlockType::DIRT : BlockType::STONE;
+                    blocks[blockPos] = legacyBlock(type, blockPos);
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    const int regionSize = 8;  // Chunks per side
+    const int chunkSize = Config::World::CHUNK_SIZE;
+    const int chunkCount = regionSize * regionSize;
+    PerlinNoise noiseGenerator(1337);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int cx = 0; cx < regionSize; cx++) {
+        for (int cz = 0; cz < regionSize; cz++) {
+            std::unordered_map<sf::Vector3i, LegacyBlock> blocks;
+            legacyGenerate(blocks, cx * chunkSize, cz * chunkSize, noiseGenerator);
+        }
+    }
+    double legacyTime = Bench::secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int cx = 0; cx < regionSize; cx++) {
+        for (int cz = 0; cz < regionSize; cz++) {
+            Chunk chunk;
+            chunk.generate(cx * chunkSize, cz * chunkSize, noiseGenerator);
+        }
+    }
+    double registryTime = Bench::secondsSince(start);
+
+    std::printf("Generated %d chunks\n", chunkCount);
+    std::printf("%-22s %12s\n", "path", "ms/chunk");
+    std::printf("%-22s %12.3f\n", "per-block textures", legacyTime * 1000.0 / chunkCount);
+    std::printf("%-22s %12.3f\n", "block registry", registryTime * 1000.0 / chunkCount);
+    return 0;
+}
@@ -0,0 +1,276 @@
+// Meshes generated terrain headlessly and reports faces emitted, vertices per chunk and
+// meshing time, compared with the six faces per block the immediate mode path submitted.
+// Also times remeshing after a single block edit: the whole chunk against only the edited section,
+// and checks that the section meshes add up to the faces of the whole chunk mesh. The packed vertex format
+// is checked to round trip every attribute over its whole range, and its size compared with float vertices.
+// The chunks are lit and meshed with their light: the cost of gathering it is timed against gathering blocks
+// only, and the ambient occlusion and quad diagonals are checked on a block standing on a floor. Last, the
+// section with the most faces (a 3D checkerboard) is checked to fit the 16-bit indices of MeshData.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Core/LightEngine.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Size of the vertex before it was packed: position, texture coordinates and tile as floats
+    const std::size_t FLOAT_VERTEX_BYTES = 6 * sizeof(float);
+
+    // Pack and unpack every position with the other attributes varied over their whole range
+    int checkVertexRoundTrip() {
+        int wrong = 0;
+        for (int x = 0; x <= ChunkStorage::SIZE; x++) {
+            for (int y = 0; y <= ChunkStorage::HEIGHT; y++) {
+                for (int z = 0; z <= ChunkStorage::SIZE; z++) {
+                    int face = (x + y + z) % BlockRegistry::FACE_COUNT;
+                    int tile = (x * 31 + y * 7 + z) % 256;
+                    int u = (y * 3 + x) % (ChunkStorage::HEIGHT + 1);
+                    int v = (ChunkStorage::HEIGHT - y + z * 5) % (ChunkStorage::HEIGHT + 1);
+                    int ao = (x + z) % 4;
+                    int sky = y % (LightStorage::MAX_LEVEL + 1);
+                    int block = (x * 3 + z) % (LightStorage::MAX_LEVEL + 1);
+
+                    ChunkVertex vertex = ChunkVertex::pack(x, y, z, face, tile, u, v, ao, sky, block);
+                    if (vertex.x() != x || vertex.y() != y || vertex.z() != z || vertex.face() != face ||
+                        vertex.tile() != tile || vertex.u() != u || vertex.v() != v || vertex.ao() != ao ||
+                        vertex.sky() != sky || vertex.block() != block) wrong++;
+                }
+            }
+        }
+        return wrong;
+    }
+
+    // Check that the vertices of a mesh unpack to positions in the chunk and repack to the same bits
+    int checkMeshVertices(const ChunkMeshData& mesh) {
+        int wrong = 0;
+        for (const MeshData& layer : mesh.layers) {
+            for (const ChunkVertex& vertex : layer.vertices) {
+                ChunkVertex repacked = ChunkVertex::pack(vertex.x(), vertex.y(), vertex.z(), vertex.face(), vertex.tile(),
+                                                         vertex.u(), vertex.v(), vertex.ao(), vertex.sky(), vertex.block());
+                if (repacked.position != vertex.position || repacked.texture != vertex.texture ||
+                    vertex.x() > ChunkStorage::SIZE || vertex.z() > ChunkStorage::SIZE ||
+                    vertex.face() >= BlockRegistry::FACE_COUNT) wrong++;
+            }
+        }
+        return wrong;
+    }
+
+    // Brightness of a vertex the way the mesher orders corners: occlusion first, then light
+    int brightness(const ChunkVertex& vertex) {
+        return vertex.ao() * 64 + vertex.sky() + vertex.block();
+    }
+
+    // Mesh a stone block standing on a stone floor and check the occlusion it casts on the floor, and that every
+    // quad is split along the diagonal joining its brighter corners. Returns the number of failed checks.
+    // Mesh the section with the most faces and check its indices stay within the vertices of their layer
+    int checkWorstCaseSection() {
+        ChunkMesher::Volume volume(0, ChunkStorage::SECTION_HEIGHT);
+        for (int y = 0; y < ChunkStorage::SECTION_HEIGHT; y++) {
+            for (int z = 0; z < ChunkStorage::SIZE; z++) {
+                for (int x = 0; x < ChunkStorage::SIZE; x++) {
+                    if ((x + y + z) % 2 == 0) volume.set(x, y, z, BlockType::STONE);
+                }
+            }
+        }
+        ChunkMeshData mesh = ChunkMesher::build(volume, 0);
+
+        int failures = 0;
+        for (const MeshData& layer : mesh.layers) {
+            for (MeshData::Index index : layer.indices) {
+                if (index >= layer.vertices.size()) failures++;
+            }
+        }
+        std::printf("%-34s %12zu\n", "worst case section vertices", mesh.vertexCount());
+        if (mesh.vertexCount() != 49152 || failures > 0) {
+            std::printf("FAILED: the checkerboard section has %zu vertices and %d indices past them\n", mesh.vertexCount(), failures);
+            failures++;
+        }
+        return failures;
+    }
+
+    int checkAmbientOcclusion() {
+        ChunkMesher::Volume volume(0, ChunkStorage::SECTION_HEIGHT);
+        for (int z = 0; z < ChunkStorage::SIZE; z++) {
+            for (int x = 0; x < ChunkStorage::SIZE; x++) volume.set(x, 4, z, BlockType::STONE);
+        }
+        volume.set(8, 5, 8, BlockType::STONE);
+        ChunkMeshData mesh = ChunkMesher::build(volume);
+
+        int failures = 0;
+        int occludedNearBlock = 0, occludedElsewhere = 0;
+        const MeshData& data = mesh.layers[BlockRegistry::OPAQUE];
+        for (const ChunkVertex& vertex : data.vertices) {
+            if (vertex.face() != BlockRegistry::TOP || vertex.y() != 5) continue;
+
+            bool nearBlock = vertex.x() >= 8 && vertex.x() <= 9 && vertex.z() >= 8 && vertex.z() <= 9;
+            if (vertex.ao() < 3) (nearBlock ? occludedNearBlock : occludedElsewhere)++;
+        }
+        if (occludedNearBlock == 0 || occludedElsewhere > 0) {
+            std::printf("FAILED: the block occludes %d floor corners around it and %d elsewhere\n", occludedNearBlock,
+                        occludedElsewhere);
+            failures++;
+        }
+
+        // The first and third index of a quad are the ends of its shared diagonal
+        int wrongDiagonals = 0;
+        for (std::size_t i = 0; i < data.indices.size(); i += 6) {
+            std::uint32_t base = data.indices[i] - data.indices[i] % 4;
+            int diagonal = brightness(data.vertices[data.indices[i]]) + brightness(data.vertices[data.indices[i + 2]]);
+            int other = 0;
+            for (std::uint32_t corner = base; corner < base + 4; corner++) {
+                if (corner != data.indices[i] && corner != data.indices[i + 2]) other += brightness(data.vertices[corner]);
+            }
+            if (diagonal < other) wrongDiagonals++;
+        }
+        if (wrongDiagonals > 0) {
+            std::printf("FAILED: %d quads are split along their darker diagonal\n", wrongDiagonals);
+            failures++;
+        }
+        return failures;
+    }
+}
+
+int main() {
+    const int regionSize = 6;  // Chunks per side; only the inner chunks (with all neighbours) are meshed
+    const int chunkSize = ChunkStorage::SIZE;
+    const int iterations = 5;
+    PerlinNoise noiseGenerator(1337);
+
+    std::vector<Chunk> chunks(regionSize * regionSize);
+    for (int x = 0; x < regionSize; x++) {
+        for (int z = 0; z < regionSize; z++) {
+            chunks[x * regionSize + z].generate(x * chunkSize, z * chunkSize, noiseGenerator);
+        }
+    }
+
+    auto storageAt = [&](int x, int z) { return &chunks[x * regionSize + z].getStorage(); };
+
+    // Light the region the way World does: every chunk on its own, then stitched to its neighbours
+    LightEngine lightEngine;
+    for (Chunk& chunk : chunks) lightEngine.lightChunk(chunk);
+    for (int x = 0; x < regionSize; x++) {
+        for (int z = 0; z < regionSize; z++) {
+            LightEngine::Neighbourhood neighbourhood{};
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    bool inside = x + dx >= 0 && x + dx < regionSize && z + dz >= 0 && z + dz < regionSize;
+                    neighbourhood[(dz + 1) * 3 + dx + 1] = inside ? &chunks[(x + dx) * regionSize + z + dz] : nullptr;
+                }
+            }
+            lightEngine.stitch(neighbourhood);
+        }
+    }
+    auto lightAt = [&](int x, int z) {
+        return ChunkMesher::Light{&chunks[x * regionSize + z].getLight(),
+                                  {&chunks[(x - 1) * regionSize + z].getLight(), &chunks[(x + 1) * regionSize + z].getLight(),
+                                   &chunks[x * regionSize + z - 1].getLight(), &chunks[x * regionSize + z + 1].getLight()}};
+    };
+
+    long long blocks = 0, visibleFaces = 0, quads = 0, vertices = 0, indices = 0, badVertices = 0;
+    double gatherTime = 0.0, gatherBlocksTime = 0.0, buildTime = 0.0;
+    int meshedChunks = 0;
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (int x = 1; x < regionSize - 1; x++) {
+            for (int z = 1; z < regionSize - 1; z++) {
+                ChunkMesher::Neighbours neighbours = {storageAt(x - 1, z), storageAt(x + 1, z),
+                                                      storageAt(x, z - 1), storageAt(x, z + 1)};
+
+                auto start = std::chrono::steady_clock::now();
+                ChunkMesher::Volume unlit = ChunkMesher::gather(*storageAt(x, z), neighbours);
+                gatherBlocksTime += Bench::secondsSince(start);
+
+                start = std::chrono::steady_clock::now();
+                ChunkMesher::Volume volume = ChunkMesher::gather(*storageAt(x, z), neighbours, lightAt(x, z));
+                gatherTime += Bench::secondsSince(start);
+
+                start = std::chrono::steady_clock::now();
+                ChunkMeshData mesh = ChunkMesher::build(volume);
+                buildTime += Bench::secondsSince(start);
+
+                if (iteration == 0) {
+                    for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+                        for (int bz = 0; bz < chunkSize; bz++) {
+                            for (int bx = 0; bx < chunkSize; bx++) {
+                                if (storageAt(x, z)->get(bx, y, bz) != BlockType::AIR) blocks++;
+                            }
+                        }
+                    }
+                    visibleFaces += mesh.visibleFaces;
+                    quads += mesh.quads;
+                    vertices += static_cast<long long>(mesh.vertexCount());
+                    badVertices += checkMeshVertices(mesh);
+                    for (const MeshData& layer : mesh.layers) indices += static_cast<long long>(layer.indices.size());
+                    meshedChunks++;
+                }
+            }
+        }
+    }
+
+    double perChunk = static_cast<double>(meshedChunks);
+    double meshCount = perChunk * iterations;
+
+    std::printf("Meshed %d chunks (%d iterations)\n", meshedChunks, iterations);
+    std::printf("%-34s %12.1f\n", "blocks per chunk", blocks / perChunk);
+    std::printf("%-34s %12.1f\n", "faces submitted before (6/block)", 6.0 * blocks / perChunk);
+    std::printf("%-34s %12.1f\n", "faces after culling", visibleFaces / perChunk);
+    std::printf("%-34s %12.1f\n", "quads after greedy merging", quads / perChunk);
+    std::printf("%-34s %12.1f\n", "vertices per chunk", vertices / perChunk);
+    std::printf("%-34s %12.1f\n", "vertex bytes per chunk (floats)", vertices * FLOAT_VERTEX_BYTES / perChunk);
+    std::printf("%-34s %12.1f  (%.1fx smaller)\n", "vertex bytes per chunk (packed)", vertices * sizeof(ChunkVertex) / perChunk,
+                static_cast<double>(FLOAT_VERTEX_BYTES) / sizeof(ChunkVertex));
+    double floatMeshBytes = static_cast<double>(vertices * FLOAT_VERTEX_BYTES + indices * sizeof(std::uint32_t));
+    double packedMeshBytes = static_cast<double>(vertices * sizeof(ChunkVertex) + indices * sizeof(MeshData::Index));
+    std::printf("%-34s %12.1f\n", "mesh bytes per chunk (floats, u32)", floatMeshBytes / perChunk);
+    std::printf("%-34s %12.1f  (%.1fx smaller)\n", "mesh bytes per chunk (packed, u16)", packedMeshBytes / perChunk,
+                floatMeshBytes / packedMeshBytes);
+    std::printf("%-34s %12.3f\n", "gather ms per chunk (blocks only)", gatherBlocksTime * 1000.0 / meshCount);
+    std::printf("%-34s %12.3f\n", "gather ms per chunk (with light)", gatherTime * 1000.0 / meshCount);
+    std::printf("%-34s %12.3f\n", "mesh ms per chunk", buildTime * 1000.0 / meshCount);
+
+    // Remesh after breaking one surface block of every inner chunk
+    double chunkRemeshTime = 0.0, sectionRemeshTime = 0.0;
+    int mismatches = 0;
+    for (int x = 1; x < regionSize - 1; x++) {
+        for (int z = 1; z < regionSize - 1; z++) {
+            Chunk& chunk = chunks[x * regionSize + z];
+            int surface = ChunkStorage::HEIGHT - 1;
+            while (surface > 0 && chunk.getStorage().get(8, surface, 8) == BlockType::AIR) surface--;
+            chunk.removeBlockAt({x * chunkSize + 8, surface, z * chunkSize + 8});
+
+            ChunkMesher::Neighbours neighbours = {storageAt(x - 1, z), storageAt(x + 1, z),
+                                                  storageAt(x, z - 1), storageAt(x, z + 1)};
+
+            auto start = std::chrono::steady_clock::now();
+            ChunkMeshData whole = ChunkMesher::build(ChunkMesher::gather(*storageAt(x, z), neighbours, lightAt(x, z)));
+            chunkRemeshTime += Bench::secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            int section = surface / ChunkStorage::SECTION_HEIGHT;
+            ChunkMesher::build(ChunkMesher::gather(*storageAt(x, z), neighbours, section, 0, lightAt(x, z)), section);
+            sectionRemeshTime += Bench::secondsSince(start);
+
+            // Faces are only merged within a section, but the same faces must be visible
+            int sectionFaces = 0;
+            for (int i = 0; i < ChunkStorage::SECTION_COUNT; i++) {
+                sectionFaces += ChunkMesher::build(ChunkMesher::gather(*storageAt(x, z), neighbours, i, 0, lightAt(x, z)), i).visibleFaces;
+            }
+            if (sectionFaces != whole.visibleFaces) mismatches++;
+        }
+    }
+
+    int edits = (regionSize - 2) * (regionSize - 2);
+    std::printf("%-34s %12.3f\n", "edit: chunk remesh ms", chunkRemeshTime * 1000.0 / edits);
+    std::printf("%-34s %12.3f\n", "edit: section remesh ms", sectionRemeshTime * 1000.0 / edits);
+
+    int occlusionFailures = checkAmbientOcclusion();
+    int indexFailures = checkWorstCaseSection();
+    int roundTripFailures = checkVertexRoundTrip();
+    if (roundTripFailures > 0) std::printf("FAILED: %d packed vertices do not unpack to their attributes\n", roundTripFailures);
+    if (badVertices > 0) std::printf("FAILED: %lld mesh vertices do not repack to the same bits\n", badVertices);
+    if (mismatches > 0) std::printf("FAILED: %d chunks have different faces when meshed by section\n", mismatches);
+    return mismatches > 0 || roundTripFailures > 0 || badVertices > 0 || occlusionFailures > 0 || indexFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// Compares the dense palette storage of a chunk with the previous unordered_map<sf::Vector3i, Block>
+// layout: memory per chunk, fill throughput and random lookup throughput.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+#include "../src/Core/ChunkStorage.h"
+#include "../src/Utils/Math.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Layout of a block before the dense storage: position, flags and per-instance texture vectors
+    struct LegacyBlock {
+        BlockType type = BlockType::AIR;
+        sf::Vector3i position;
+        bool isVisible = false;
+        bool isOpaque = false;
+        bool isSolid = false;
+        std::vector<sf::IntRect> textures;
+        std::vector<int> textureRotation;
+    };
+
+    using LegacyChunk = std::unordered_map<sf::Vector3i, LegacyBlock>;
+
+    const int SIZE = ChunkStorage::SIZE;
+    const int GROUND_HEIGHT = 64;  // Typical terrain: stone, a few layers of dirt and a grass top
+
+    BlockType terrainAt(int y) {
+        if (y == GROUND_HEIGHT - 1) return BlockType::GRASS;
+        if (y >= GROUND_HEIGHT - 4) return BlockType::DIRT;
+        return BlockType::STONE;
+    }
+
+    // Estimate the heap used by the map: nodes, bucket array and the two vectors of every block
+    std::size_t legacyMemoryUsage(const LegacyChunk& chunk) {
+        const std::size_t allocationOverhead = 16;
+        std::size_t nodeSize = sizeof(void*) + sizeof(std::size_t) + sizeof(LegacyChunk::value_type) + allocationOverhead;
+        std::size_t total = sizeof(LegacyChunk) + chunk.bucket_count() * sizeof(void*) + chunk.size() * nodeSize;
+
+        for (const auto& [position, block] : chunk) {
+            total += block.textures.capacity() * sizeof(sf::IntRect) + allocationOverhead;
+            total += block.textureRotation.capacity() * sizeof(int) + allocationOverhead;
+        }
+        return total;
+    }
+
+    void fillLegacy(LegacyChunk& chunk) {
+        for (int x = 0; x < SIZE; x++) {
+            for (int z = 0; z < SIZE; z++) {
+                for (int y = 0; y < GROUND_HEIGHT; y++) {
+                    sf::Vector3i position(x, y, z);
+                    LegacyBlock block;
+                    block.type = terrainAt(y);
+                    block.position = position;
+                    block.isVisible = block.isOpaque = block.isSolid = true;
+                    block.textures.assign(6, sf::IntRect(0, 0, 16, 16));
+                    block.textureRotation.assign(6, 0);
+                    chunk[position] = std::move(block);
+                }
+            }
+        }
+    }
+
+    void fillDense(ChunkStorage& storage) {
+        for (int x = 0; x < SIZE; x++) {
+            for (int z = 0; z < SIZE; z++) {
+                for (int y = 0; y < GROUND_HEIGHT; y++) {
+                    storage.set(x, y, z, terrainAt(y));
+                }
+            }
+        }
+    }
+}
+
+int main() {
+    const int fillIterations = 50;
+    const int lookupCount = 5000000;
+    const int voxelsPerFill = SIZE * SIZE * GROUND_HEIGHT;
+
+    // Random lookup positions covering the full column (air included)
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<int> horizontal(0, SIZE - 1);
+    std::uniform_int_distribution<int> vertical(0, ChunkStorage::HEIGHT - 1);
+    std::vector<sf::Vector3i> lookups(lookupCount);
+    for (sf::Vector3i& position : lookups) {
+        position = {horizontal(generator), vertical(generator), horizontal(generator)};
+    }
+
+    // Fill throughput
+    auto start = std::chrono::steady_clock::now();
+    LegacyChunk legacy;
+    for (int i = 0; i < fillIterations; i++) {
+        legacy = LegacyChunk();
+        fillLegacy(legacy);
+    }
+    double legacyFill = Bench::secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    ChunkStorage dense;
+    for (int i = 0; i < fillIterations; i++) {
+        dense = ChunkStorage();
+        fillDense(dense);
+    }
+    double denseFill = Bench::secondsSince(start);
+
+    // Lookup throughput
+    start = std::chrono::steady_clock::now();
+    std::size_t legacyHits = 0;
+    for (const sf::Vector3i& position : lookups) {
+        auto it = legacy.find(position);
+        if (it != legacy.end() && it->second.isSolid) legacyHits++;
+    }
+    double legacyLookup = Bench::secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    std::size_t denseHits = 0;
+    for (const sf::Vector3i& position : lookups) {
+        if (dense.get(position.x, position.y, position.z) != BlockType::AIR) denseHits++;
+    }
+    double denseLookup = Bench::secondsSince(start);
+
+    std::printf("Chunk %dx%dx%d, terrain height %d (%d voxels filled)\n",
+                SIZE, ChunkStorage::HEIGHT, SIZE, GROUND_HEIGHT, voxelsPerFill);
+    std::printf("%-14s %14s %18s %18s\n", "storage", "bytes/chunk", "fill (Mvoxel/s)", "lookup (M/s)");
+    std::printf("%-14s %14zu %18.2f %18.2f\n", "unordered_map", legacyMemoryUsage(legacy),
+                voxelsPerFill * fillIterations / legacyFill / 1e6, lookupCount / legacyLookup / 1e6);
+    std::printf("%-14s %14zu %18.2f %18.2f\n", "palette", dense.memoryUsage(),
+                voxelsPerFill * fillIterations / denseFill / 1e6, lookupCount / denseLookup / 1e6);
+
+    if (legacyHits != denseHits) {
+        std::printf("Mismatch: %zu map hits, %zu palette hits\n", legacyHits, denseHits);
+        return 1;
+    }
+    return 0;
+}
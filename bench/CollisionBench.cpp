@@ -0,0 +1,116 @@
+// Measures player-sized collision queries as the number of loaded chunks grows: the old scan over
+// every block of every chunk, the per-chunk scan over all chunks, and the voxel rasterized query.
+
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/VoxelQuery.h"
+#include "BenchUtil.h"
+
+namespace {
+    int floorDiv(int value, int divisor) {
+        return (value < 0) ? (value - divisor + 1) / divisor : value / divisor;
+    }
+
+    // The collision check before it was clipped: an AABB for every block of every chunk
+    bool legacyCheck(const std::unordered_map<sf::Vector2i, Chunk>& chunks, const Math::AABB& box) {
+        const int chunkSize = ChunkStorage::SIZE;
+        for (const auto& [chunkPos, chunk] : chunks) {
+            for (int x = 0; x < chunkSize; x++) {
+                for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+                    for (int z = 0; z < chunkSize; z++) {
+                        sf::Vector3i position(chunkPos.x * chunkSize + x, y, chunkPos.y * chunkSize + z);
+                        if (chunk.getBlockTypeAt(position) != BlockType::AIR &&
+                            Block::getAABB(position).intersects(box)) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Asking every chunk, each clipping the box to its own blocks
+    bool perChunkCheck(const std::unordered_map<sf::Vector2i, Chunk>& chunks, const Math::AABB& box) {
+        for (const auto& [chunkPos, chunk] : chunks) {
+            if (chunk.checkCollision(box)) return true;
+        }
+        return false;
+    }
+}
+
+int main() {
+    const int chunkSize = ChunkStorage::SIZE;
+    PerlinNoise noiseGenerator(1337);
+
+    std::printf("%8s %16s %16s %16s %16s\n", "chunks", "legacy us/query", "per-chunk ns", "voxel ns", "sweep ns");
+
+    for (int radius : {1, 2, 4, 8}) {
+        std::unordered_map<sf::Vector2i, Chunk> chunks;
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) {
+                chunks[{x, z}].generate(x * chunkSize, z * chunkSize, noiseGenerator);
+            }
+        }
+
+        auto isSolid = [&chunks](const sf::Vector3i& cell) {
+            auto it = chunks.find({floorDiv(cell.x, chunkSize), floorDiv(cell.z, chunkSize)});
+            return it != chunks.end() && BlockRegistry::get(it->second.getBlockTypeAt(cell)).solid;
+        };
+
+        // Player boxes on a diagonal through the terrain, at the height of the surface so some collide
+        const int queries = 20000;
+        std::vector<Math::AABB> boxes;
+        for (int i = 0; i < queries; i++) {
+            float x = static_cast<float>(i % (2 * chunkSize)) - chunkSize + 0.5f;
+            float y = 8.0f + static_cast<float>(i % 16);
+            boxes.push_back({{x - 0.3f, y, x - 0.3f}, {x + 0.3f, y + 1.8f, x + 0.3f}});
+        }
+
+        // Every strategy must agree on every query
+        int collisions = 0;
+        for (const Math::AABB& box : boxes) {
+            bool voxel = VoxelQuery::overlapsSolid(box, isSolid);
+            if (voxel != perChunkCheck(chunks, box)) {
+                std::printf("mismatch between the voxel and per-chunk queries\n");
+                return 1;
+            }
+            collisions += voxel;
+        }
+
+        const int legacyQueries = 20;
+        auto start = std::chrono::steady_clock::now();
+        int legacyCollisions = 0;
+        for (int i = 0; i < legacyQueries; i++) legacyCollisions += legacyCheck(chunks, boxes[i]);
+        double legacyTime = Bench::secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        int perChunkCollisions = 0;
+        for (const Math::AABB& box : boxes) perChunkCollisions += perChunkCheck(chunks, box);
+        double perChunkTime = Bench::secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        int voxelCollisions = 0;
+        for (const Math::AABB& box : boxes) voxelCollisions += VoxelQuery::overlapsSolid(box, isSolid);
+        double voxelTime = Bench::secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        float sweptTime = 0.0f;
+        for (const Math::AABB& box : boxes) sweptTime += VoxelQuery::sweep(box, {0.0f, -4.0f, 0.0f}, isSolid).time;
+        double sweepTime = Bench::secondsSince(start);
+
+        std::printf("%8zu %16.1f %16.1f %16.1f %16.1f\n", chunks.size(),
+                    legacyTime * 1e6 / legacyQueries, perChunkTime * 1e9 / queries,
+                    voxelTime * 1e9 / queries, sweepTime * 1e9 / queries);
+
+        // Keep the results alive so the loops are not optimized away
+        if (perChunkCollisions != collisions || voxelCollisions != collisions || legacyCollisions < 0 || sweptTime < 0.0f) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Runs a world through a full day and night, headless: the chunks around the player are loaded first, then
+// each frame updates the world and looks for sections to remesh the way WorldRenderer does, by comparing the
+// section revisions against the ones last meshed. Reports the CPU time per frame for each eighth of the day
+// and checks that the day costs no remesh at all, since the time of day only changes the sky color and the
+// skyLight uniform of the chunk shader.
+// Usage: day_cycle_bench [seed] [frames per day] (defaults 1337 and 24000). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../src/Config.h"
+#include "../src/Core/World.h"
+#include "BenchUtil.h"
+
+namespace {
+    const int PERIODS = 8;  // The day is reported in eighths, the first one starting at midnight
+
+    bool sameColor(const sf::Vector3f& a, const sf::Vector3f& b) {
+        return std::abs(a.x - b.x) < 1e-4f && std::abs(a.y - b.y) < 1e-4f && std::abs(a.z - b.z) < 1e-4f;
+    }
+
+    // Section revisions of the loaded chunks around the player, as WorldRenderer last meshed them
+    struct MeshedRevisions {
+        std::vector<sf::Vector2i> positions;
+        std::vector<std::uint32_t> revisions;
+
+        // Count the sections whose revision changed since they were last meshed, and mark them meshed
+        int collectDirty(const World& world) {
+            int dirty = 0;
+            for (std::size_t i = 0; i < positions.size(); i++) {
+                const Chunk* chunk = world.getChunk(positions[i]);
+                for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                    std::uint32_t& revision = revisions[i * ChunkStorage::SECTION_COUNT + section];
+                    if (chunk->getSectionRevision(section) != revision) {
+                        revision = chunk->getSectionRevision(section);
+                        dirty++;
+                    }
+                }
+            }
+            return dirty;
+        }
+    };
+
+    double median(std::vector<double> values) {
+        if (values.empty()) return 0.0;
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const int frames = argc > 2 ? std::atoi(argv[2]) : 24000;
+    if (frames < PERIODS) {
+        std::fprintf(stderr, "usage: %s [seed] [frames per day, at least %d]\n", argv[0], PERIODS);
+        return 1;
+    }
+
+    // The clock follows the sky: noon is the day sky at full sky light, midnight the night sky
+    World world(seed);
+    world.setTimeOfDay(0.5f);
+    Bench::check(sameColor(world.getSkyColor(), Config::World::SKY_COLOR) && world.getSkyLight() == 1.0f, "day sky at noon");
+    world.setTimeOfDay(1.0f);
+    Bench::check(world.getTimeOfDay() == 0.0f, "the time of day wraps around");
+    Bench::check(sameColor(world.getSkyColor(), Config::World::NIGHT_SKY_COLOR) &&
+                 world.getSkyLight() == Config::World::NIGHT_SKY_LIGHT, "night sky at midnight");
+
+    // Load the chunks around the player before the day starts
+    const sf::Vector3f player = Config::Player::POSITION;
+    world.init(player);
+    MeshedRevisions meshed;
+    auto start = std::chrono::steady_clock::now();
+    meshed.positions = Bench::loadChunksAround(world, player, world.getLoadRadius());
+    meshed.revisions.assign(meshed.positions.size() * ChunkStorage::SECTION_COUNT, 0);
+    int loadSections = meshed.collectDirty(world);
+    std::printf("seed %u, %zu chunks loaded in %.1f ms (%d sections to mesh), %d frames per day\n", seed,
+                meshed.positions.size(), Bench::secondsSince(start) * 1000.0, loadSections, frames);
+
+    // One full day from midnight, a fixed step per frame
+    world.setTimeOfDay(0.0f);
+    const float deltaTime = Config::World::DAY_LENGTH / static_cast<float>(frames);
+    std::vector<std::vector<double>> frameTimes(PERIODS);
+    std::vector<float> lowestSkyLight(PERIODS, 1.0f), highestSkyLight(PERIODS, 0.0f);
+    long long dayRemeshes = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        int period = frame * PERIODS / frames;
+        auto frameStart = std::chrono::steady_clock::now();
+
+        world.tick(deltaTime);
+        world.update(deltaTime, player);
+        float skyLight = world.getSkyLight();
+        dayRemeshes += meshed.collectDirty(world);
+
+        frameTimes[period].push_back(Bench::secondsSince(frameStart) * 1e6);
+        lowestSkyLight[period] = std::min(lowestSkyLight[period], skyLight);
+        highestSkyLight[period] = std::max(highestSkyLight[period], skyLight);
+    }
+
+    std::printf("%-13s %11s %12s %12s\n", "time of day", "sky light", "us/frame", "max us");
+    double fastest = 0.0, slowest = 0.0;
+    for (int period = 0; period < PERIODS; period++) {
+        double frameTime = median(frameTimes[period]);
+        double maxTime = *std::max_element(frameTimes[period].begin(), frameTimes[period].end());
+        std::printf("%5.3f-%5.3f   %4.2f-%4.2f %12.2f %12.2f\n", static_cast<double>(period) / PERIODS,
+                    static_cast<double>(period + 1) / PERIODS, lowestSkyLight[period], highestSkyLight[period],
+                    frameTime, maxTime);
+        fastest = period == 0 ? frameTime : std::min(fastest, frameTime);
+        slowest = period == 0 ? frameTime : std::max(slowest, frameTime);
+    }
+    std::printf("slowest eighth / fastest eighth  %.2f, sections remeshed over the day  %lld\n",
+                fastest > 0.0 ? slowest / fastest : 0.0, dayRemeshes);
+
+    Bench::check(loadSections > 0, "the loaded chunks have sections to mesh");
+    Bench::check(dayRemeshes == 0, "a full day remeshes no section");
+    Bench::check(std::abs(world.getTimeOfDay()) < 1e-3f || std::abs(world.getTimeOfDay() - 1.0f) < 1e-3f,
+                 "the frames add up to one day");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
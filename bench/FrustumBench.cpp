@@ -0,0 +1,162 @@
+// Checks the frustum culling math against a clip space reference and measures it on the chunk sections
+// around a camera turning in place: boxes tested per second and the share of sections culled.
+// Usage: frustum_bench [radius in chunks] (default 8). Returns nonzero if a check fails.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/Core/ChunkStorage.h"
+#include "../src/Utils/Math.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Camera of GameScene: the projection set in its constructor and the eye height of a standing player
+    const float FOV = Config::Player::FOV;
+    const float ASPECT_RATIO = static_cast<float>(Config::Window::WIDTH) / static_cast<float>(Config::Window::HEIGHT);
+    const float NEAR_PLANE = 0.1f;
+    const float FAR_PLANE = 100.0f;
+
+    Math::Frustum cameraFrustum(const sf::Vector3f& eye, float yaw, float pitch) {
+        Math::Matrix4 projection = Math::perspectiveMatrix(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE);
+        return Math::Frustum::fromMatrix(Math::multiply(projection, Math::viewMatrix(eye, yaw, pitch)));
+    }
+
+    // Clip space reference: -1 if every corner of the box is outside the same clip plane, 1 if a corner
+    // is inside the clip volume by more than the margin, 0 if it is too close to call
+    int classify(const Math::Matrix4& viewProjection, const Math::AABB& box, float margin) {
+        int outsideCounts[6] = {};
+        bool cornerInside = false;
+
+        for (int corner = 0; corner < 8; corner++) {
+            float point[4] = {corner & 1 ? box.max.x : box.min.x, corner & 2 ? box.max.y : box.min.y,
+                              corner & 4 ? box.max.z : box.min.z, 1.0f};
+            float clip[4] = {};
+            for (int row = 0; row < 4; row++) {
+                for (int i = 0; i < 4; i++) clip[row] += viewProjection[i * 4 + row] * point[i];
+            }
+
+            bool inside = true;
+            for (int axis = 0; axis < 3; axis++) {
+                if (clip[axis] < -clip[3] - margin) outsideCounts[axis * 2]++;
+                if (clip[axis] > clip[3] + margin) outsideCounts[axis * 2 + 1]++;
+                if (std::fabs(clip[axis]) > clip[3] - margin) inside = false;
+            }
+            cornerInside = cornerInside || inside;
+        }
+
+        for (int count : outsideCounts) {
+            if (count == 8) return -1;
+        }
+        return cornerInside ? 1 : 0;
+    }
+
+    void checkMatrices() {
+        // The projection is glFrustum with the bounds of Projection::setPerspectiveMatrix
+        Math::Matrix4 projection = Math::perspectiveMatrix(90.0f, 2.0f, 1.0f, 11.0f);
+        Bench::check(std::fabs(projection[0] - 0.5f) < 1e-5f && std::fabs(projection[5] - 1.0f) < 1e-5f,
+                     "perspective scale");
+        Bench::check(std::fabs(projection[10] + 1.2f) < 1e-5f && projection[11] == -1.0f &&
+                     std::fabs(projection[14] + 2.2f) < 1e-5f, "perspective depth");
+
+        // Without rotation the view only moves the world by the opposite of the eye
+        Math::Matrix4 view = Math::viewMatrix({1.0f, 2.0f, 3.0f}, 0.0f, 0.0f);
+        Bench::check(view[0] == 1.0f && view[5] == 1.0f && view[10] == 1.0f && view[12] == -1.0f && view[13] == -2.0f &&
+                     view[14] == -3.0f, "view translation");
+    }
+
+    void checkKnownBoxes() {
+        const sf::Vector3f eye(0.0f, 0.0f, 0.0f);
+
+        // Yaw 0 looks down -z, yaw 90 looks down +x, pitch 90 looks down
+        Math::Frustum forward = cameraFrustum(eye, 0.0f, 0.0f);
+        Bench::check(forward.intersects({{-1, -1, -11}, {1, 1, -9}}), "box ahead is kept");
+        Bench::check(!forward.intersects({{-1, -1, 9}, {1, 1, 11}}), "box behind is culled");
+        Bench::check(!forward.intersects({{-1, -1, -211}, {1, 1, -209}}), "box past the far plane is culled");
+        Bench::check(!forward.intersects({{50, -1, -11}, {52, 1, -9}}), "box to the side is culled");
+        Bench::check(forward.intersects({{-5, -5, -5}, {5, 5, 5}}), "box around the camera is kept");
+        Bench::check(forward.intersects({{-100, -1, -11}, {100, 1, -9}}), "box crossing the view with no corner inside is kept");
+
+        Math::Frustum right = cameraFrustum(eye, 90.0f, 0.0f);
+        Bench::check(right.intersects({{9, -1, -1}, {11, 1, 1}}), "turned camera keeps the box it faces");
+        Bench::check(!right.intersects({{-1, -1, -11}, {1, 1, -9}}), "turned camera culls the box it turned from");
+
+        Math::Frustum down = cameraFrustum(eye, 0.0f, 90.0f);
+        Bench::check(down.intersects({{-1, -11, -1}, {1, -9, 1}}), "camera looking down keeps the box below");
+        Bench::check(!down.intersects({{-1, 9, -1}, {1, 11, 1}}), "camera looking down culls the box above");
+    }
+
+    void checkRandomBoxes() {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+        std::uniform_real_distribution<float> pitch(-89.0f, 89.0f);
+        std::uniform_real_distribution<float> coordinate(-120.0f, 120.0f);
+        std::uniform_real_distribution<float> extent(0.1f, 16.0f);
+
+        int wrong = 0;
+        for (int i = 0; i < 200000; i++) {
+            sf::Vector3f eye(coordinate(generator) * 0.1f, coordinate(generator) * 0.1f, coordinate(generator) * 0.1f);
+            float yaw = angle(generator), tilt = pitch(generator);
+            Math::Matrix4 viewProjection = Math::multiply(Math::perspectiveMatrix(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE),
+                                                          Math::viewMatrix(eye, yaw, tilt));
+            Math::Frustum frustum = Math::Frustum::fromMatrix(viewProjection);
+
+            sf::Vector3f min(coordinate(generator), coordinate(generator), coordinate(generator));
+            Math::AABB box(min, min + sf::Vector3f(extent(generator), extent(generator), extent(generator)));
+
+            // Visible boxes must never be culled, boxes outside one plane must always be
+            int expected = classify(viewProjection, box, 1e-3f);
+            if ((expected == 1 && !frustum.intersects(box)) || (expected == -1 && frustum.intersects(box))) wrong++;
+        }
+        Bench::check(wrong == 0, "random boxes agree with the clip space reference");
+    }
+}
+
+int main(int argc, char** argv) {
+    const int radius = argc > 1 ? std::atoi(argv[1]) : 8;
+    if (radius < 0) {
+        std::fprintf(stderr, "usage: %s [radius in chunks]\n", argv[0]);
+        return 1;
+    }
+
+    checkMatrices();
+    checkKnownBoxes();
+    checkRandomBoxes();
+
+    // Section boxes of the chunks around a standing player
+    const int chunkSize = ChunkStorage::SIZE;
+    const int sectionHeight = ChunkStorage::SECTION_HEIGHT;
+    std::vector<Math::AABB> sections;
+    for (int x = -radius; x <= radius; x++) {
+        for (int z = -radius; z <= radius; z++) {
+            for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                sections.emplace_back(x * chunkSize, section * sectionHeight, z * chunkSize, chunkSize, sectionHeight, chunkSize);
+            }
+        }
+    }
+    const sf::Vector3f eye(8.0f, 20.0f + Config::Player::NORMAL_HEIGHT, 8.0f);
+
+    // One frame per degree of a full turn
+    const int frames = 360;
+    long long drawn = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        Math::Frustum frustum = cameraFrustum(eye, static_cast<float>(frame), 10.0f);
+        for (const Math::AABB& box : sections) {
+            drawn += frustum.intersects(box);
+        }
+    }
+    double cullTime = Bench::secondsSince(start);
+
+    long long considered = static_cast<long long>(sections.size()) * frames;
+    std::printf("radius %d chunks, %zu sections per frame, %d frames turning in place\n", radius, sections.size(), frames);
+    std::printf("sections drawn per frame   %10.1f\n", static_cast<double>(drawn) / frames);
+    std::printf("sections culled per frame  %10.1f  (%.1f%%)\n", static_cast<double>(considered - drawn) / frames,
+                100.0 * (considered - drawn) / considered);
+    std::printf("culling                    %10.2f Mboxes/s  (%.3f ms/frame)\n", considered / cullTime / 1e6,
+                cullTime * 1e3 / frames);
+
+    return Bench::failures > 0 ? 1 : 0;
+}
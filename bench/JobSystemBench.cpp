@@ -0,0 +1,78 @@
+// Generates and meshes chunks on the job system and reports how chunks/sec scales with
+// 1, 2, 4 and one worker per hardware thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Utils/CompletionQueue.h"
+#include "../src/Utils/JobSystem.h"
+
+namespace {
+    struct Result {
+        sf::Vector2i position;
+        std::size_t vertices = 0;
+    };
+
+    double chunksPerSecond(unsigned int workers, int regionSize, const PerlinNoise& noiseGenerator) {
+        const int chunkSize = ChunkStorage::SIZE;
+        const int chunkCount = regionSize * regionSize;
+        CompletionQueue<Result> completed;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            JobSystem jobSystem(workers);
+
+            for (int x = 0; x < regionSize; x++) {
+                for (int z = 0; z < regionSize; z++) {
+                    jobSystem.submit([&completed, &noiseGenerator, x, z, chunkSize] {
+                        Chunk chunk;
+                        chunk.generate(x * chunkSize, z * chunkSize, noiseGenerator);
+                        ChunkMeshData mesh = ChunkMesher::build(ChunkMesher::gather(chunk.getStorage(), {}));
+                        completed.push({{x, z}, mesh.vertexCount()});
+                    });
+                }
+            }
+
+            // Drain on this thread like the main loop does
+            int received = 0;
+            Result result;
+            while (received < chunkCount) {
+                if (completed.tryPop(result)) {
+                    received++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return chunkCount / seconds;
+    }
+}
+
+int main() {
+    const int regionSize = 16;
+    PerlinNoise noiseGenerator(1337);
+
+    unsigned int hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned int> workerCounts = {1, 2, 4};
+    if (std::find(workerCounts.begin(), workerCounts.end(), hardwareThreads) == workerCounts.end()) {
+        workerCounts.push_back(hardwareThreads);
+    }
+
+    std::printf("Generating and meshing %d chunks, %u hardware threads\n", regionSize * regionSize, hardwareThreads);
+    std::printf("%8s %14s %10s\n", "workers", "chunks/sec", "speedup");
+
+    double baseline = 0.0;
+    for (unsigned int workers : workerCounts) {
+        double rate = chunksPerSecond(workers, regionSize, noiseGenerator);
+        if (baseline == 0.0) baseline = rate;
+        std::printf("%8u %14.1f %9.2fx\n", workers, rate, rate / baseline);
+    }
+    return 0;
+}
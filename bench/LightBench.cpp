@@ -0,0 +1,245 @@
+// Measures the light engine on generated terrain: the time to light a fresh chunk and to stitch it to its
+// neighbours, then light updates per second on mass edits (digging tunnels, lighting them, roofing the ground
+// over and taking it all down again), and checks that the incrementally updated light is exactly the light
+// computed from scratch.
+// Usage: light_bench [seed] [region size in chunks] (defaults 1337 and 5). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/LightEngine.h"
+#include "../src/Utils/PerlinNoise.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Square region of chunks, chunk (0, 0) of the region starts at the world origin
+    struct Region {
+        int size;
+        std::vector<Chunk> chunks;
+
+        [[nodiscard]] Chunk* chunkAt(int chunkX, int chunkZ) {
+            if (chunkX < 0 || chunkZ < 0 || chunkX >= size || chunkZ >= size) return nullptr;
+            return &chunks[chunkZ * size + chunkX];
+        }
+
+        [[nodiscard]] LightEngine::Neighbourhood neighbourhood(int chunkX, int chunkZ) {
+            LightEngine::Neighbourhood result{};
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    result[(dz + 1) * 3 + dx + 1] = chunkAt(chunkX + dx, chunkZ + dz);
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]] BlockType get(int x, int y, int z) {
+            Chunk* chunk = chunkAt(x / ChunkStorage::SIZE, z / ChunkStorage::SIZE);
+            return chunk ? chunk->getBlockTypeAt({x, y, z}) : BlockType::AIR;
+        }
+
+        [[nodiscard]] int light(LightStorage::Channel channel, int x, int y, int z) {
+            Chunk* chunk = chunkAt(x / ChunkStorage::SIZE, z / ChunkStorage::SIZE);
+            return chunk->getLight().get(channel, x % ChunkStorage::SIZE, y, z % ChunkStorage::SIZE);
+        }
+
+        // Light every chunk on its own, then stitch every chunk to its neighbours
+        void lightAll(LightEngine& engine) {
+            for (Chunk& chunk : chunks) engine.lightChunk(chunk);
+            for (int chunkZ = 0; chunkZ < size; chunkZ++) {
+                for (int chunkX = 0; chunkX < size; chunkX++) engine.stitch(neighbourhood(chunkX, chunkZ));
+            }
+        }
+    };
+
+    // Edits of one kind and the light work they caused
+    struct EditTotals {
+        const char* name;
+        long long edits = 0;
+        long long voxels = 0;
+        long long maxVoxels = 0;
+        double seconds = 0.0;
+    };
+
+    // Replace a block and update the light around it, the way World does
+    void edit(Region& region, LightEngine& engine, int x, int y, int z, BlockType type, EditTotals& totals) {
+        int chunkX = x / ChunkStorage::SIZE, chunkZ = z / ChunkStorage::SIZE;
+        Chunk& chunk = *region.chunkAt(chunkX, chunkZ);
+        BlockType previous = chunk.getBlockTypeAt({x, y, z});
+        if (previous == type) return;
+
+        std::uint64_t voxels = engine.getUpdatedVoxels();
+        auto start = std::chrono::steady_clock::now();
+        chunk.setBlockAt({x, y, z}, type);
+        engine.blockChanged(region.neighbourhood(chunkX, chunkZ), x % ChunkStorage::SIZE, y, z % ChunkStorage::SIZE, previous, type);
+        totals.seconds += Bench::secondsSince(start);
+
+        long long written = static_cast<long long>(engine.getUpdatedVoxels() - voxels);
+        totals.edits++;
+        totals.voxels += written;
+        totals.maxVoxels = std::max(totals.maxVoxels, written);
+    }
+
+    // Highest block of a column
+    int surfaceAt(Region& region, int x, int z) {
+        int y = ChunkStorage::HEIGHT - 1;
+        while (y > 0 && region.get(x, y, z) == BlockType::AIR) y--;
+        return y;
+    }
+
+    // Check that two regions have the same light everywhere
+    bool sameLight(Region& a, Region& b) {
+        for (int z = 0; z < a.size * ChunkStorage::SIZE; z++) {
+            for (int x = 0; x < a.size * ChunkStorage::SIZE; x++) {
+                for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+                    if (a.light(LightStorage::SKY, x, y, z) != b.light(LightStorage::SKY, x, y, z) ||
+                        a.light(LightStorage::BLOCK, x, y, z) != b.light(LightStorage::BLOCK, x, y, z)) {
+                        std::printf("light differs at %d %d %d: sky %d / %d, block %d / %d\n", x, y, z,
+                                    a.light(LightStorage::SKY, x, y, z), b.light(LightStorage::SKY, x, y, z),
+                                    a.light(LightStorage::BLOCK, x, y, z), b.light(LightStorage::BLOCK, x, y, z));
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const int regionSize = argc > 2 ? std::atoi(argv[2]) : 5;
+    if (regionSize < 3) {
+        std::fprintf(stderr, "usage: %s [seed] [region size in chunks, at least 3]\n", argv[0]);
+        return 1;
+    }
+
+    const int chunkSize = ChunkStorage::SIZE;
+    PerlinNoise noiseGenerator(seed);
+
+    Region region{regionSize, std::vector<Chunk>(regionSize * regionSize)};
+    for (int chunkZ = 0; chunkZ < regionSize; chunkZ++) {
+        for (int chunkX = 0; chunkX < regionSize; chunkX++) {
+            region.chunkAt(chunkX, chunkZ)->generate(chunkX * chunkSize, chunkZ * chunkSize, noiseGenerator);
+        }
+    }
+
+    // Fresh chunks: lit on their own (on a worker in the game), then stitched when they enter the world
+    LightEngine engine;
+    const int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round++) {
+        for (Chunk& chunk : region.chunks) engine.lightChunk(chunk);
+    }
+    double lightTime = Bench::secondsSince(start) / rounds;
+
+    start = std::chrono::steady_clock::now();
+    for (int chunkZ = 0; chunkZ < regionSize; chunkZ++) {
+        for (int chunkX = 0; chunkX < regionSize; chunkX++) engine.stitch(region.neighbourhood(chunkX, chunkZ));
+    }
+    double stitchTime = Bench::secondsSince(start);
+
+    std::size_t memory = 0;
+    int uniformSections = 0;
+    for (const Chunk& chunk : region.chunks) {
+        memory += chunk.getLight().memoryUsage();
+        for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) uniformSections += chunk.getLight().isSectionUniform(section);
+    }
+
+    int chunkCount = regionSize * regionSize;
+    std::printf("seed %u, %d x %d chunks\n", seed, regionSize, regionSize);
+    std::printf("light chunk   %8.3f ms/chunk\n", lightTime * 1e3 / chunkCount);
+    std::printf("stitch        %8.3f ms/chunk\n", stitchTime * 1e3 / chunkCount);
+    std::printf("light memory  %8.1f KiB/chunk  (%d of %d sections uniform)\n", memory / 1024.0 / chunkCount, uniformSections,
+                chunkCount * ChunkStorage::SECTION_COUNT);
+
+    // The open sky reaches the ground, and nothing reaches inside it
+    int centerX = regionSize / 2 * chunkSize + chunkSize / 2, centerZ = centerX;
+    int surface = surfaceAt(region, centerX, centerZ);
+    Bench::check(region.light(LightStorage::SKY, centerX, surface + 1, centerZ) == LightStorage::MAX_LEVEL, "full sky light on the ground");
+    Bench::check(surface < 2 || region.light(LightStorage::SKY, centerX, surface - 1, centerZ) == 0, "no sky light underground");
+
+    // A single edit deep in the ground changes no light at all
+    EditTotals buried{"buried"};
+    if (surface > 4) {
+        edit(region, engine, centerX, 1, centerZ, BlockType::COBBLESTONE, buried);
+        Bench::check(buried.voxels == 0, "a buried edit writes no light");
+    }
+
+    // Mass edits inside the inner chunks, so every neighbourhood is complete
+    std::mt19937 random(seed);
+    const int low = chunkSize, high = (regionSize - 1) * chunkSize;
+    std::uniform_int_distribution<int> coordinate(low, high - 1);
+
+    // Tunnels: random walks through the ground, two blocks high
+    EditTotals dig{"dig"};
+    std::vector<std::array<int, 3>> tunnels;
+    for (int tunnel = 0; tunnel < 60; tunnel++) {
+        int x = coordinate(random), z = coordinate(random);
+        int y = std::max(surfaceAt(region, x, z), 3);
+        for (int step = 0; step < 80; step++) {
+            edit(region, engine, x, y, z, BlockType::AIR, dig);
+            edit(region, engine, x, y + 1, z, BlockType::AIR, dig);
+            tunnels.push_back({x, y, z});
+
+            int direction = static_cast<int>(random() % 6);
+            if (direction == 0) x = std::min(x + 1, high - 1);
+            else if (direction == 1) x = std::max(x - 1, low);
+            else if (direction == 2) z = std::min(z + 1, high - 1);
+            else if (direction == 3) z = std::max(z - 1, low);
+            else if (direction == 4) y = std::max(y - 1, 2);
+        }
+    }
+
+    // Light sources along the tunnels
+    EditTotals place{"lights"};
+    std::vector<std::array<int, 3>> lights;
+    for (std::size_t i = 0; i < tunnels.size(); i += 12) {
+        edit(region, engine, tunnels[i][0], tunnels[i][1], tunnels[i][2], BlockType::LIT_FURNACE, place);
+        lights.push_back(tunnels[i]);
+    }
+
+    // Roofs over the ground, cutting the sky light off large areas
+    EditTotals roof{"roof"};
+    std::vector<std::array<int, 3>> roofs;
+    for (int count = 0; count < 12; count++) {
+        int x0 = coordinate(random), z0 = coordinate(random), y = 32 + static_cast<int>(random() % 8);
+        for (int x = x0; x < std::min(x0 + 10, high); x++) {
+            for (int z = z0; z < std::min(z0 + 10, high); z++) {
+                edit(region, engine, x, y, z, BlockType::PLANKS, roof);
+                roofs.push_back({x, y, z});
+            }
+        }
+    }
+
+    // Everything taken down again, lights first
+    EditTotals remove{"remove"};
+    for (const std::array<int, 3>& light : lights) edit(region, engine, light[0], light[1], light[2], BlockType::AIR, remove);
+    for (const std::array<int, 3>& block : roofs) edit(region, engine, block[0], block[1], block[2], BlockType::AIR, remove);
+
+    std::printf("\nedits      count    edits/s   Mupdates/s   voxels/edit   max voxels\n");
+    for (const EditTotals& totals : {dig, place, roof, remove}) {
+        std::printf("%-6s  %8lld  %9.0f   %10.2f   %11.1f   %10lld\n", totals.name, totals.edits, totals.edits / totals.seconds,
+                    totals.voxels / totals.seconds / 1e6, static_cast<double>(totals.voxels) / totals.edits, totals.maxVoxels);
+    }
+
+    // The light after all the edits is the light of the edited blocks lit from scratch
+    Region reference = region;
+    LightEngine referenceEngine;
+    start = std::chrono::steady_clock::now();
+    reference.lightAll(referenceEngine);
+    double relightTime = Bench::secondsSince(start);
+    std::printf("\nrelight the region from scratch: %.2f ms\n", relightTime * 1e3);
+
+    Bench::check(dig.voxels > 0 && place.voxels > 0 && roof.voxels > 0, "edits change the light");
+    long long editVoxels = dig.voxels + place.voxels + roof.voxels + remove.voxels;
+    long long edits = dig.edits + place.edits + roof.edits + remove.edits;
+    Bench::check(editVoxels / edits < 9LL * ChunkStorage::SIZE * ChunkStorage::SIZE * ChunkStorage::HEIGHT / 100,
+                 "an edit touches a small part of its neighbourhood");
+    Bench::check(sameLight(region, reference), "incremental light matches the light computed from scratch");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,159 @@
+// Measures the section meshes of generated chunks at every level of detail: vertices and bytes per chunk,
+// and the total mesh budget of the rings of Config::World at several render distances against meshing
+// every chunk at full resolution. Then the rings ChunkMesher::lodRingsFor chooses within the vertex budget
+// at each render distance, and checks the per chunk estimates of Config::World are within ESTIMATE_TOLERANCE
+// of the measured meshes.
+// Usage: lod_bench [seed] [radius of the sample in chunks] (defaults 1337 and 3). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Utils/PerlinNoise.h"
+#include "BenchUtil.h"
+
+namespace {
+    const double ESTIMATE_TOLERANCE = 0.1;  // Largest share Config::World::LOD_CHUNK_VERTICES may be off the measurement
+
+    // Size of the meshes of the sampled chunks at one level of detail
+    struct LodTotals {
+        long long vertices = 0;
+        long long bytes = 0;
+        long long quads = 0;
+        double seconds = 0.0;
+    };
+
+    // Mesh every section of a chunk the way WorldRenderer does at a level of detail
+    void meshChunk(const ChunkStorage& chunk, const ChunkMesher::Neighbours& neighbours, int lod, LodTotals& totals) {
+        // Above level 0 the mesher closes the sides of the chunk and never reads the neighbours
+        ChunkMesher::Neighbours used = lod > 0 ? ChunkMesher::Neighbours{} : neighbours;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+            if (chunk.isSectionEmpty(section)) continue;
+
+            ChunkMeshData mesh = ChunkMesher::build(ChunkMesher::gather(chunk, used, section, lod), section, lod);
+            totals.quads += mesh.quads;
+            for (const MeshData& layer : mesh.layers) {
+                totals.vertices += static_cast<long long>(layer.vertices.size());
+                totals.bytes += static_cast<long long>(layer.vertices.size() * sizeof(ChunkVertex) +
+                                                       layer.indices.size() * sizeof(MeshData::Index));
+            }
+        }
+        totals.seconds += Bench::secondsSince(start);
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const int radius = argc > 2 ? std::atoi(argv[2]) : 3;
+    if (radius < 1) {
+        std::fprintf(stderr, "usage: %s [seed] [radius of the sample in chunks]\n", argv[0]);
+        return 1;
+    }
+
+    // Generate the sample, its outer ring only serves as neighbours
+    const int chunkSize = ChunkStorage::SIZE;
+    const int width = 2 * radius + 1;
+    PerlinNoise noiseGenerator(seed);
+    std::vector<Chunk> chunks(static_cast<std::size_t>(width) * width);
+    auto at = [&](int x, int z) -> Chunk& { return chunks[(x + radius) * width + (z + radius)]; };
+    for (int x = -radius; x <= radius; x++) {
+        for (int z = -radius; z <= radius; z++) at(x, z).generate(x * chunkSize, z * chunkSize, noiseGenerator);
+    }
+
+    std::vector<LodTotals> totals(ChunkMesher::LOD_COUNT);
+    LodTotals closed;  // Level 0 with every side closed, as on the border of the first ring
+    int sampled = 0;
+    for (int x = 1 - radius; x < radius; x++) {
+        for (int z = 1 - radius; z < radius; z++) {
+            ChunkMesher::Neighbours neighbours = {&at(x - 1, z).getStorage(), &at(x + 1, z).getStorage(),
+                                                  &at(x, z - 1).getStorage(), &at(x, z + 1).getStorage()};
+            for (int lod = 0; lod < ChunkMesher::LOD_COUNT; lod++) meshChunk(at(x, z).getStorage(), neighbours, lod, totals[lod]);
+            meshChunk(at(x, z).getStorage(), ChunkMesher::Neighbours{}, 0, closed);
+            sampled++;
+        }
+    }
+
+    std::printf("seed %u, %d chunks sampled\n", seed, sampled);
+    std::printf("level  cell   vertices/chunk   KiB/chunk   quads/chunk   ms/chunk\n");
+    std::vector<double> verticesPerChunk(ChunkMesher::LOD_COUNT), bytesPerChunk(ChunkMesher::LOD_COUNT);
+    for (int lod = 0; lod < ChunkMesher::LOD_COUNT; lod++) {
+        verticesPerChunk[lod] = static_cast<double>(totals[lod].vertices) / sampled;
+        bytesPerChunk[lod] = static_cast<double>(totals[lod].bytes) / sampled;
+        std::printf("%5d  %4d   %14.1f   %9.1f   %11.1f   %8.3f\n", lod, 1 << lod, verticesPerChunk[lod],
+                    bytesPerChunk[lod] / 1024.0, static_cast<double>(totals[lod].quads) / sampled,
+                    totals[lod].seconds * 1e3 / sampled);
+    }
+    std::printf("level 0 with closed sides (seam): %.1f vertices/chunk (+%.1f%%)\n",
+                static_cast<double>(closed.vertices) / sampled, 100.0 * (closed.vertices - totals[0].vertices) / totals[0].vertices);
+
+    // Budget of the whole view: the ring at distance d holds 8d chunks (1 for the player's chunk)
+    std::printf("\nrender distance   chunks   chunks per level       Mvertices (all level 0)   MiB (all level 0)\n");
+    const int distances[] = {8, 16, 32, 48};
+    for (int distance : distances) {
+        std::vector<long long> counts(ChunkMesher::LOD_COUNT, 0);
+        for (int ring = 0; ring <= distance; ring++) counts[ChunkMesher::lodForDistance(ring)] += ring == 0 ? 1 : 8 * ring;
+
+        long long chunkCount = 0;
+        double vertices = 0.0, bytes = 0.0;
+        for (int lod = 0; lod < ChunkMesher::LOD_COUNT; lod++) {
+            chunkCount += counts[lod];
+            vertices += counts[lod] * verticesPerChunk[lod];
+            bytes += counts[lod] * bytesPerChunk[lod];
+        }
+        std::printf("%15d   %6lld   %5lld %5lld %5lld      %6.2f (%6.2f)           %7.1f (%7.1f)\n", distance, chunkCount,
+                    counts[0], counts[1], counts[2], vertices / 1e6, chunkCount * verticesPerChunk[0] / 1e6,
+                    bytes / (1024.0 * 1024.0), chunkCount * bytesPerChunk[0] / (1024.0 * 1024.0));
+    }
+
+    // Rings chosen within the vertex budget, with the vertices measured above
+    std::printf("\nvertex budget %zu\nrender distance   draw distance   rings        Mvertices (estimated)\n",
+                Config::World::VERTEX_BUDGET);
+    bool withinBudget = true;
+    for (int distance = 8; distance <= Config::World::MAX_RENDER_DISTANCE; distance += 8) {
+        ChunkMesher::LodRings rings = ChunkMesher::lodRingsFor(distance, Config::World::VERTEX_BUDGET);
+        double vertices = 0.0;
+        for (int ring = 0; ring <= rings.drawDistance; ring++) {
+            vertices += (ring == 0 ? 1 : 8 * ring) * verticesPerChunk[ChunkMesher::lodForDistance(ring, rings)];
+        }
+        double estimate = ChunkMesher::estimateVertices(rings);
+        std::printf("%15d   %13d   %4d %4d    %6.2f (%6.2f)\n", distance, rings.drawDistance, rings.start[1], rings.start[2],
+                    vertices / 1e6, estimate / 1e6);
+        withinBudget = withinBudget && estimate <= static_cast<double>(Config::World::VERTEX_BUDGET);
+    }
+    Bench::check(withinBudget, "the chosen rings fit the vertex budget");
+
+    ChunkMesher::LodRings configured = ChunkMesher::lodRingsFor(Config::World::LOD2_DISTANCE, Config::World::VERTEX_BUDGET);
+    Bench::check(configured.drawDistance == Config::World::LOD2_DISTANCE && configured.start == ChunkMesher::LodRings{}.start,
+                 "a view within the budget keeps the configured rings");
+    const std::size_t smallBudget = 50000;
+    ChunkMesher::LodRings tight = ChunkMesher::lodRingsFor(Config::World::MAX_RENDER_DISTANCE, smallBudget);
+    Bench::check(tight.start[1] < Config::World::LOD1_DISTANCE && tight.start[1] <= tight.start[2] &&
+                 ChunkMesher::estimateVertices(tight) <= static_cast<double>(smallBudget),
+                 "a small budget moves the rings closer");
+    Bench::check(ChunkMesher::lodRingsFor(Config::World::MAX_RENDER_DISTANCE, 1000).drawDistance == 1,
+                 "a budget too small for any ring still draws the first ring");
+    // The rings are only as good as the estimates they are chosen with
+    for (int lod = 0; lod < ChunkMesher::LOD_COUNT; lod++) {
+        double estimate = Config::World::LOD_CHUNK_VERTICES[lod];
+        double error = std::abs(verticesPerChunk[lod] - estimate) / estimate;
+        std::printf("level %d: %.1f vertices/chunk measured, %.0f estimated (%+.1f%%)\n", lod, verticesPerChunk[lod], estimate,
+                    (verticesPerChunk[lod] / estimate - 1.0) * 100.0);
+        Bench::check(error <= ESTIMATE_TOLERANCE, "Config::World::LOD_CHUNK_VERTICES is within the tolerance of the measured meshes");
+    }
+
+    Bench::check(ChunkMesher::lodForDistance(0) == 0 && ChunkMesher::lodForDistance(Config::World::LOD1_DISTANCE) == 1 &&
+                 ChunkMesher::lodForDistance(Config::World::LOD2_DISTANCE) == ChunkMesher::LOD_COUNT - 1, "distance rings");
+    for (int lod = 1; lod < ChunkMesher::LOD_COUNT; lod++) {
+        Bench::check(totals[lod].vertices > 0, "every level draws the terrain");
+        Bench::check(totals[lod].vertices < totals[lod - 1].vertices, "each level has fewer vertices than the one before");
+    }
+    Bench::check(closed.vertices > totals[0].vertices, "closing the sides adds the seam faces");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,329 @@
+// Measures cave culling on generated terrain: the share of chunk sections the visibility walk removes on
+// top of frustum culling, for a camera on the surface and one in a cave dug under it. The generated
+// terrain is only about 20 blocks deep, so it is also run raised on a thick layer of stone with worm
+// caves, which is where the culling pays off. Every block a ray from the camera can see must belong to a
+// drawn section, the bench fails otherwise.
+// Usage: occlusion_bench [seed] [radius in chunks] (defaults 1337 and 8).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Core/VisibilityGraph.h"
+#include "../src/Core/VoxelQuery.h"
+#include "../src/Utils/PerlinNoise.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Camera of GameScene: the projection set in its constructor
+    const float FOV = Config::Player::FOV;
+    const float ASPECT_RATIO = static_cast<float>(Config::Window::WIDTH) / static_cast<float>(Config::Window::HEIGHT);
+    const float NEAR_PLANE = 0.1f;
+    const float FAR_PLANE = 100.0f;
+
+    // Generated chunks around the origin and what the renderer would know about their sections
+    class Terrain {
+    public:
+        // Generated chunks, raised by depth blocks of stone with caves dug in it
+        Terrain(unsigned int seed, int radius, int depth) : radius(radius), width(2 * radius + 1), chunks(width * width) {
+            PerlinNoise noiseGenerator(seed);
+            const int chunkSize = ChunkStorage::SIZE;
+            for (int x = -radius; x <= radius; x++) {
+                for (int z = -radius; z <= radius; z++) {
+                    Chunk& chunk = chunks[index({x, z})];
+                    chunk.generate(x * chunkSize, z * chunkSize, noiseGenerator);
+                    if (depth == 0) continue;
+
+                    ChunkStorage raised;
+                    for (int localX = 0; localX < chunkSize; localX++) {
+                        for (int localZ = 0; localZ < chunkSize; localZ++) {
+                            for (int y = 0; y < depth; y++) raised.set(localX, y, localZ, BlockType::STONE);
+                            for (int y = 0; y + depth < ChunkStorage::HEIGHT; y++) {
+                                BlockType type = chunk.getStorage().get(localX, y, localZ);
+                                if (type != BlockType::AIR) raised.set(localX, y + depth, localZ, type);
+                            }
+                        }
+                    }
+                    chunk.load(x * chunkSize, z * chunkSize, std::move(raised));
+                }
+            }
+            if (depth > 0) digCaves(seed, depth);
+        }
+
+        // Replace a block with air (ignored outside the chunks)
+        void dig(int x, int y, int z) {
+            sf::Vector2i chunkPos(Math::floorDiv(x, ChunkStorage::SIZE), Math::floorDiv(z, ChunkStorage::SIZE));
+            if (storage(chunkPos) && y > 0 && y < ChunkStorage::HEIGHT) chunks[index(chunkPos)].setBlockAt({x, y, z}, BlockType::AIR);
+        }
+
+        [[nodiscard]] const ChunkStorage* storage(const sf::Vector2i& chunkPos) const {
+            if (std::abs(chunkPos.x) > radius || std::abs(chunkPos.y) > radius) return nullptr;
+            return &chunks[index(chunkPos)].getStorage();
+        }
+
+        // Mesh every section the way WorldRenderer does, keeping whether it draws anything and its visibility
+        double mesh() {
+            hasFaces.assign(chunks.size() * ChunkStorage::SECTION_COUNT, false);
+            visibility.assign(chunks.size() * ChunkStorage::SECTION_COUNT, VisibilityGraph::SectionVisibility::all());
+
+            auto start = std::chrono::steady_clock::now();
+            for (int x = -radius; x <= radius; x++) {
+                for (int z = -radius; z <= radius; z++) {
+                    sf::Vector2i chunkPos(x, z);
+                    ChunkMesher::Neighbours neighbours = {storage({x - 1, z}), storage({x + 1, z}),
+                                                          storage({x, z - 1}), storage({x, z + 1})};
+                    for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                        if (storage(chunkPos)->isSectionEmpty(section)) continue;
+
+                        ChunkMeshData data = ChunkMesher::build(ChunkMesher::gather(*storage(chunkPos), neighbours, section), section);
+                        hasFaces[slot(chunkPos, section)] = data.quads > 0;
+                        visibility[slot(chunkPos, section)] = data.visibility;
+                    }
+                }
+            }
+            return Bench::secondsSince(start);
+        }
+
+        [[nodiscard]] bool drawsSomething(const sf::Vector2i& chunkPos, int section) const {
+            return hasFaces[slot(chunkPos, section)];
+        }
+
+        [[nodiscard]] VisibilityGraph::SectionVisibility getVisibility(const sf::Vector2i& chunkPos, int section) const {
+            if (!storage(chunkPos)) return VisibilityGraph::SectionVisibility::all();
+            return visibility[slot(chunkPos, section)];
+        }
+
+        // Height of the first air block above the ground of a column
+        [[nodiscard]] int surfaceAt(int x, int z) const {
+            const ChunkStorage* column = storage({Math::floorDiv(x, ChunkStorage::SIZE), Math::floorDiv(z, ChunkStorage::SIZE)});
+            int localX = x - Math::floorDiv(x, ChunkStorage::SIZE) * ChunkStorage::SIZE;
+            int localZ = z - Math::floorDiv(z, ChunkStorage::SIZE) * ChunkStorage::SIZE;
+            int y = ChunkStorage::HEIGHT;
+            while (y > 0 && column->get(localX, y - 1, localZ) == BlockType::AIR) y--;
+            return y;
+        }
+
+        const int radius;
+
+    private:
+        const int width;
+        std::vector<Chunk> chunks;
+        std::vector<bool> hasFaces;
+        std::vector<VisibilityGraph::SectionVisibility> visibility;
+
+        [[nodiscard]] int index(const sf::Vector2i& chunkPos) const {
+            return (chunkPos.x + radius) * width + (chunkPos.y + radius);
+        }
+
+        // Worm caves: a few tunnels per chunk, each a ball moved along a slowly turning direction
+        void digCaves(unsigned int seed, int depth) {
+            std::mt19937 generator(seed);
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            const int chunkSize = ChunkStorage::SIZE;
+
+            for (int x = -radius; x <= radius; x++) {
+                for (int z = -radius; z <= radius; z++) {
+                    for (int cave = 0; cave < 2; cave++) {
+                        sf::Vector3f position((x + unit(generator)) * chunkSize, 8.0f + unit(generator) * (depth - 16.0f),
+                                              (z + unit(generator)) * chunkSize);
+                        float heading = unit(generator) * 6.2832f;
+                        float slope = 0.0f;
+                        float ballRadius = 1.5f + unit(generator);
+
+                        for (int step = 0; step < 48; step++) {
+                            heading += (unit(generator) - 0.5f) * 0.6f;
+                            slope = std::clamp(slope + (unit(generator) - 0.5f) * 0.2f, -0.4f, 0.4f);
+                            position += sf::Vector3f(std::cos(heading), slope, std::sin(heading));
+                            position.y = std::clamp(position.y, 4.0f, depth - 6.0f);
+
+                            int reach = static_cast<int>(std::ceil(ballRadius));
+                            for (int dx = -reach; dx <= reach; dx++) {
+                                for (int dy = -reach; dy <= reach; dy++) {
+                                    for (int dz = -reach; dz <= reach; dz++) {
+                                        if (dx * dx + dy * dy + dz * dz > ballRadius * ballRadius) continue;
+                                        dig(static_cast<int>(position.x) + dx, static_cast<int>(position.y) + dy,
+                                            static_cast<int>(position.z) + dz);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] std::size_t slot(const sf::Vector2i& chunkPos, int section) const {
+            return static_cast<std::size_t>(index(chunkPos)) * ChunkStorage::SECTION_COUNT + section;
+        }
+    };
+
+    struct CullCounts {
+        long long considered = 0;  // Sections with faces
+        long long culled = 0;      // Outside the frustum
+        long long occluded = 0;    // Inside the frustum, not reached by the walk
+        long long drawn = 0;
+        long long missed = 0;      // Blocks seen by a ray in a section that was not drawn
+        double walkTime = 0.0;
+    };
+
+    // Cull the sections for one camera like WorldRenderer::cullSections and check them against rays
+    void cullFrom(const Terrain& terrain, const sf::Vector3f& eye, float yaw, float pitch, CullCounts& counts) {
+        const int chunkSize = ChunkStorage::SIZE;
+        const int sectionHeight = ChunkStorage::SECTION_HEIGHT;
+        const int radius = terrain.radius;
+
+        Math::Matrix4 view = Math::viewMatrix(eye, yaw, pitch);
+        Math::Matrix4 viewProjection = Math::multiply(Math::perspectiveMatrix(FOV, ASPECT_RATIO, NEAR_PLANE, FAR_PLANE), view);
+        Math::Frustum frustum = Math::Frustum::fromMatrix(viewProjection);
+        auto inView = [&](const sf::Vector2i& chunkPos, int section) {
+            return frustum.intersects(Math::AABB(chunkPos.x * chunkSize, section * sectionHeight, chunkPos.y * chunkSize,
+                                                 chunkSize, sectionHeight, chunkSize));
+        };
+
+        const int width = 2 * radius + 1;
+        std::vector<bool> drawn(static_cast<std::size_t>(width) * width * ChunkStorage::SECTION_COUNT, false);
+        auto slot = [&](const sf::Vector2i& chunkPos, int section) {
+            return (static_cast<std::size_t>(chunkPos.x + radius) * width + (chunkPos.y + radius)) * ChunkStorage::SECTION_COUNT + section;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        sf::Vector2i cameraChunk(Math::floorDiv(static_cast<int>(std::floor(eye.x)), chunkSize),
+                                 Math::floorDiv(static_cast<int>(std::floor(eye.z)), chunkSize));
+        VisibilityGraph::walk(cameraChunk, Math::floorDiv(static_cast<int>(std::floor(eye.y)), sectionHeight), radius,
+                [&](const sf::Vector2i& chunkPos, int section) { return terrain.getVisibility(chunkPos, section); },
+                inView,
+                [&](const sf::Vector2i& chunkPos, int section) {
+                    if (terrain.drawsSomething(chunkPos, section) && inView(chunkPos, section)) drawn[slot(chunkPos, section)] = true;
+                });
+        counts.walkTime += Bench::secondsSince(start);
+
+        for (int x = -radius; x <= radius; x++) {
+            for (int z = -radius; z <= radius; z++) {
+                for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                    if (!terrain.drawsSomething({x, z}, section)) continue;
+                    counts.considered++;
+                    if (!inView({x, z}, section)) counts.culled++;
+                    else if (drawn[slot({x, z}, section)]) counts.drawn++;
+                    else counts.occluded++;
+                }
+            }
+        }
+
+        // Rays through a grid of screen points: the section of the first block each one sees must be drawn
+        const int columns = 96, rows = 54;
+        float tanHalf = std::tan(FOV * static_cast<float>(M_PI) / 360.0f);
+        for (int row = 0; row < rows; row++) {
+            for (int column = 0; column < columns; column++) {
+                // Camera space direction, then into the world with the transpose of the view rotation
+                float cameraX = ((column + 0.5f) / columns * 2.0f - 1.0f) * tanHalf * ASPECT_RATIO;
+                float cameraY = ((row + 0.5f) / rows * 2.0f - 1.0f) * tanHalf;
+                sf::Vector3f direction(view[0] * cameraX + view[1] * cameraY - view[2],
+                                       view[4] * cameraX + view[5] * cameraY - view[6],
+                                       view[8] * cameraX + view[9] * cameraY - view[10]);
+
+                VoxelQuery::RaycastHit hit = VoxelQuery::raycast(eye, direction, FAR_PLANE,
+                        [&](const sf::Vector2i& chunkPos) { return terrain.storage(chunkPos); });
+                if (!hit.hit) continue;
+
+                sf::Vector2i chunkPos(Math::floorDiv(hit.block.x, chunkSize), Math::floorDiv(hit.block.z, chunkSize));
+                if (!drawn[slot(chunkPos, hit.block.y / sectionHeight)]) counts.missed++;
+            }
+        }
+    }
+
+    void report(const char* name, const CullCounts& counts, int frames) {
+        std::printf("%-16s %9.1f %9.1f %9.1f %9.1f %9.1f%% %8.1f%% %8.3f\n", name,
+                    static_cast<double>(counts.considered) / frames, static_cast<double>(counts.culled) / frames,
+                    static_cast<double>(counts.occluded) / frames, static_cast<double>(counts.drawn) / frames,
+                    100.0 * counts.occluded / std::max(counts.considered - counts.culled, 1LL),
+                    100.0 * (counts.culled + counts.occluded) / std::max(counts.considered, 1LL),
+                    counts.walkTime * 1e3 / frames);
+        if (counts.missed > 0) {
+            std::printf("FAILED: %lld blocks seen by rays are in sections that were not drawn\n", counts.missed);
+            Bench::failures++;
+        }
+    }
+
+    // Flood fill results on hand-made sections
+    void checkSectionVisibility() {
+        const int size = ChunkStorage::SIZE;
+        const int height = ChunkStorage::SECTION_HEIGHT;
+
+        ChunkMesher::Volume solid;
+        for (int y = 0; y < height; y++) {
+            for (int z = 0; z < size; z++) {
+                for (int x = 0; x < size; x++) solid.set(x, y, z, BlockType::STONE);
+            }
+        }
+        VisibilityGraph::SectionVisibility closed = ChunkMesher::buildVisibility(solid, 0);
+        Bench::check(!closed.connects(BlockRegistry::LEFT, BlockRegistry::RIGHT), "a solid section sees nothing");
+
+        // A tunnel along x at mid height
+        ChunkMesher::Volume tunnel = solid;
+        for (int x = 0; x < size; x++) tunnel.set(x, 8, 8, BlockType::AIR);
+        VisibilityGraph::SectionVisibility throughX = ChunkMesher::buildVisibility(tunnel, 0);
+        Bench::check(throughX.connects(BlockRegistry::LEFT, BlockRegistry::RIGHT), "a tunnel connects its two ends");
+        Bench::check(!throughX.connects(BlockRegistry::LEFT, BlockRegistry::TOP), "a tunnel does not reach the top");
+        Bench::check(!throughX.connects(BlockRegistry::FRONT, BlockRegistry::BACK), "a tunnel does not cross the other axis");
+
+        // Leaves and water let sight through, like air
+        ChunkMesher::Volume leaves = solid;
+        for (int y = 0; y < height; y++) leaves.set(3, y, 3, BlockType::LEAVES);
+        Bench::check(ChunkMesher::buildVisibility(leaves, 0).connects(BlockRegistry::BOTTOM, BlockRegistry::TOP),
+                     "a column of leaves connects bottom and top");
+
+        ChunkMesher::Volume air;
+        Bench::check(ChunkMesher::buildVisibility(air, 0).connects(BlockRegistry::FRONT, BlockRegistry::TOP), "air sees everything");
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const int radius = argc > 2 ? std::atoi(argv[2]) : 8;
+    if (radius <= 0) {
+        std::fprintf(stderr, "usage: %s [seed] [radius in chunks]\n", argv[0]);
+        return 1;
+    }
+
+    checkSectionVisibility();
+
+    std::printf("seed %u, radius %d chunks, 24 frames turning in place per camera\n", seed, radius);
+    std::printf("%-16s %9s %9s %9s %9s %10s %9s %8s\n", "terrain/camera", "sections", "frustum", "occluded", "drawn",
+                "occl/view", "culled", "walk ms");
+
+    // The generated terrain as it is, then raised on 64 blocks of stone with caves
+    for (int depth : {0, 64}) {
+        Terrain terrain(seed, radius, depth);
+
+        // A room dug under the ground at the center, with a tunnel leading away along x
+        int surface = terrain.surfaceAt(8, 8);
+        int caveFloor = std::max(surface - 12, 1);
+        for (int x = 0; x < 40; x++) {
+            for (int y = caveFloor; y < caveFloor + 3; y++) {
+                for (int z = 6; z < 11; z++) terrain.dig(x, y, z);
+            }
+        }
+        double meshTime = terrain.mesh();
+
+        const int frames = 24;  // A full turn in steps of 15 degrees
+        CullCounts surfaceCounts, caveCounts;
+        for (int frame = 0; frame < frames; frame++) {
+            float yaw = frame * 15.0f;
+            cullFrom(terrain, {8.5f, surface + Config::Player::NORMAL_HEIGHT, 8.5f}, yaw, 10.0f, surfaceCounts);
+            cullFrom(terrain, {8.5f, caveFloor + Config::Player::NORMAL_HEIGHT, 8.5f}, yaw, 10.0f, caveCounts);
+        }
+
+        const char* name = depth == 0 ? "generated" : "deep+caves";
+        std::printf("%s: ground at y %d, cave floor at y %d, meshing with visibility %.3f ms/chunk\n", name, surface,
+                    caveFloor, meshTime * 1e3 / ((2 * radius + 1) * (2 * radius + 1)));
+        report(depth == 0 ? "generated/surf" : "deep/surface", surfaceCounts, frames);
+        report(depth == 0 ? "generated/cave" : "deep/cave", caveCounts, frames);
+    }
+
+    return Bench::failures > 0 ? 1 : 0;
+}
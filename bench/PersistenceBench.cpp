@@ -0,0 +1,208 @@
+// Saves and loads a region of generated chunks through WorldSave and reports save/load throughput
+// in chunks/sec and bytes per chunk, and checks every loaded chunk matches the one that was saved. Then
+// corrupts table entries of the region file (a length past any chunk, an entry overlapping another) and
+// checks the region drops them instead of reading or overwriting through them. Finally makes a region
+// unwritable and checks the failed snapshot is counted, still loads, and is written by the retry.
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Save/ChunkSerializer.h"
+#include "../src/Save/WorldSave.h"
+#include "BenchUtil.h"
+
+namespace {
+    bool sameBlocks(const ChunkStorage& a, const ChunkStorage& b) {
+        for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+            for (int z = 0; z < ChunkStorage::SIZE; z++) {
+                for (int x = 0; x < ChunkStorage::SIZE; x++) {
+                    if (a.get(x, y, z) != b.get(x, y, z)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Overwrite the table entry of a chunk in a region file
+    void patchEntry(const std::filesystem::path& path, int index, std::uint32_t sector, std::uint32_t length) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        std::uint8_t bytes[8];
+        for (int i = 0; i < 4; i++) {
+            bytes[i] = static_cast<std::uint8_t>(sector >> (i * 8));
+            bytes[4 + i] = static_cast<std::uint8_t>(length >> (i * 8));
+        }
+        file.seekp(8 + index * 8);
+        file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    }
+
+    std::uintmax_t directorySize(const std::filesystem::path& directory) {
+        std::uintmax_t size = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.is_regular_file()) size += entry.file_size();
+        }
+        return size;
+    }
+}
+
+int main() {
+    const int regionSize = RegionFile::SIZE;  // One full region file
+    const int chunkSize = ChunkStorage::SIZE;
+    const int chunkCount = regionSize * regionSize;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "minecraft_persistence_bench";
+    std::filesystem::remove_all(directory);
+
+    // Generated terrain with a few edits per chunk, like chunks a player has built in
+    PerlinNoise noiseGenerator(1337);
+    std::vector<Chunk> chunks(chunkCount);
+    for (int x = 0; x < regionSize; x++) {
+        for (int z = 0; z < regionSize; z++) {
+            Chunk& chunk = chunks[x * regionSize + z];
+            chunk.generate(x * chunkSize, z * chunkSize, noiseGenerator);
+            for (int i = 0; i < 8; i++) {
+                chunk.setBlockAt({x * chunkSize + i, 30 + i, z * chunkSize + i}, BlockType::PLANKS);
+                chunk.setBlockAt({x * chunkSize + i, 2, z * chunkSize + 15 - i}, BlockType::AIR);
+            }
+        }
+    }
+
+    // Encoding alone
+    auto start = std::chrono::steady_clock::now();
+    std::size_t payloadBytes = 0, memoryBytes = 0;
+    for (const Chunk& chunk : chunks) {
+        payloadBytes += ChunkSerializer::encode(chunk.getStorage()).size();
+        memoryBytes += chunk.getStorage().memoryUsage();
+    }
+    double encodeTime = Bench::secondsSince(start);
+
+    double saveTime, loadTime, rewriteTime;
+    std::uintmax_t fileBytes, rewrittenFileBytes;
+    int mismatches = 0;
+
+    {
+        WorldSave save(directory.string());
+        start = std::chrono::steady_clock::now();
+        for (int x = 0; x < regionSize; x++) {
+            for (int z = 0; z < regionSize; z++) {
+                save.saveChunk({x, z}, chunks[x * regionSize + z].getStorage());
+            }
+        }
+        save.flush();
+        saveTime = Bench::secondsSince(start);
+    }
+    fileBytes = directorySize(directory);
+
+    {
+        // A fresh save has nothing queued, so every chunk comes from the region file
+        WorldSave save(directory.string());
+        std::vector<ChunkStorage> loaded(chunkCount);
+        start = std::chrono::steady_clock::now();
+        for (int x = 0; x < regionSize; x++) {
+            for (int z = 0; z < regionSize; z++) {
+                if (!save.loadChunk({x, z}, loaded[x * regionSize + z])) mismatches++;
+            }
+        }
+        loadTime = Bench::secondsSince(start);
+
+        for (int i = 0; i < chunkCount; i++) {
+            if (!sameBlocks(loaded[i], chunks[i].getStorage())) mismatches++;
+        }
+
+        // Edit a block in every chunk and save again: the chunks are rewritten in place once the loaded
+        // copies, which may still read the mapped file, are gone
+        loaded.clear();
+        start = std::chrono::steady_clock::now();
+        for (int x = 0; x < regionSize; x++) {
+            for (int z = 0; z < regionSize; z++) {
+                Chunk& chunk = chunks[x * regionSize + z];
+                chunk.setBlockAt({x * chunkSize + 8, 40, z * chunkSize + 8}, BlockType::COBBLESTONE);
+                save.saveChunk({x, z}, chunk.getStorage());
+            }
+        }
+        save.flush();
+        rewriteTime = Bench::secondsSince(start);
+    }
+    rewrittenFileBytes = directorySize(directory);
+
+    // Corrupt entries: chunk (0, 0) gets a length whose sector count wraps around in 32 bits, chunk (1, 0)
+    // points at the payload of chunk (2, 0)
+    const std::filesystem::path regionPath = directory / RegionFile::fileName(0, 0);
+    RegionFile::Entry shared;
+    {
+        RegionFile region(regionPath.string());
+        shared = region.getEntry(2, 0);
+    }
+    patchEntry(regionPath, 0, RegionFile::HEADER_SECTORS, 0xFFFFFF00u);
+    patchEntry(regionPath, 1, shared.sector, shared.length);
+    int corruptFailures = 0;
+    {
+        RegionFile region(regionPath.string());
+        std::vector<std::uint8_t> payload;
+        if (!region.isOpen() || region.hasChunk(0, 0) || region.readChunk(0, 0, payload)) corruptFailures++;
+
+        // Only the first of two overlapping entries is kept, the other chunk is lost rather than sharing sectors
+        if (region.hasChunk(1, 0) == region.hasChunk(2, 0)) corruptFailures++;
+
+        // Writing a chunk that no longer fits moves it without touching the sectors of the one kept
+        std::vector<std::uint8_t> large(RegionFile::SECTOR_SIZE * 64, 7);
+        std::vector<std::uint8_t> keptPayload;
+        int keptX = region.hasChunk(1, 0) ? 1 : 2;
+        if (!region.readChunk(keptX, 0, keptPayload) || !region.writeChunk(3 - keptX, 0, large)) corruptFailures++;
+        std::vector<std::uint8_t> reread;
+        if (!region.readChunk(keptX, 0, reread) || reread != keptPayload) corruptFailures++;
+    }
+    std::filesystem::remove_all(directory);
+
+    // A region that cannot be opened (a directory in its place) fails the write, and the retry writes it
+    int failedWriteFailures = 0;
+    {
+        const std::filesystem::path blocked = directory / RegionFile::fileName(0, 0);
+        std::filesystem::create_directories(blocked);
+        WorldSave save(directory.string());
+        save.saveChunk({0, 0}, chunks[0].getStorage());
+        save.flush();
+        WorldSave::Stats stats = save.getStats();
+        if (stats.writeFailures != 1 || stats.failedChunks != 1 || stats.chunksWritten != 0) failedWriteFailures++;
+
+        ChunkStorage loaded;
+        if (!save.loadChunk({0, 0}, loaded) || !sameBlocks(loaded, chunks[0].getStorage())) failedWriteFailures++;
+
+        std::filesystem::remove(blocked);
+        save.retryFailed();
+        save.flush();
+        stats = save.getStats();
+        if (stats.failedChunks != 0 || stats.chunksWritten != 1) failedWriteFailures++;
+    }
+    {
+        WorldSave save(directory.string());
+        ChunkStorage loaded;
+        if (!save.loadChunk({0, 0}, loaded) || !sameBlocks(loaded, chunks[0].getStorage())) failedWriteFailures++;
+    }
+    std::filesystem::remove_all(directory);
+
+    std::printf("chunks:              %d (one region)\n", chunkCount);
+    std::printf("in memory:           %10.0f bytes/chunk\n", static_cast<double>(memoryBytes) / chunkCount);
+    std::printf("encoded payload:     %10.0f bytes/chunk\n", static_cast<double>(payloadBytes) / chunkCount);
+    std::printf("region file:         %10.0f bytes/chunk\n", static_cast<double>(fileBytes) / chunkCount);
+    std::printf("encode:              %10.0f chunks/s\n", chunkCount / encodeTime);
+    std::printf("save (encode+write): %10.0f chunks/s\n", chunkCount / saveTime);
+    std::printf("load (read+decode):  %10.0f chunks/s\n", chunkCount / loadTime);
+    std::printf("resave after edit:   %10.0f chunks/s, file %ju -> %ju bytes\n", chunkCount / rewriteTime,
+                fileBytes, rewrittenFileBytes);
+
+    if (mismatches > 0) {
+        std::printf("FAILED: %d chunks did not load back as saved\n", mismatches);
+        return 1;
+    }
+    if (corruptFailures > 0) {
+        std::printf("FAILED: %d checks of corrupt region entries\n", corruptFailures);
+        return 1;
+    }
+    if (failedWriteFailures > 0) {
+        std::printf("FAILED: %d checks of a failed write and its retry\n", failedWriteFailures);
+        return 1;
+    }
+    return 0;
+}
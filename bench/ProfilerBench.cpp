@@ -0,0 +1,225 @@
+// Measures the cost of a profiler zone when the profiler is disabled and enabled, then checks what it records:
+// the nesting of zones, one named track per worker thread of a JobSystem, the ring keeping the latest zones
+// of a thread, clear, the Chrome trace export, and collecting while a thread records. Last, generates, lights and meshes a region of chunks with
+// the profiler off and on to show the cost on the instrumented code.
+// Usage: profiler_bench [zones per measure] (default 10000000). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "../src/Core/LightEngine.h"
+#include "../src/Utils/JobSystem.h"
+#include "../src/Utils/PerlinNoise.h"
+#include "../src/Utils/Profiler.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Keeps the loops from being optimized away
+    volatile unsigned int sink = 0;
+
+    // Nanoseconds per iteration of a loop with a zone around a trivial body
+    double zoneCost(long long count, bool withZone) {
+        auto start = std::chrono::steady_clock::now();
+        for (long long i = 0; i < count; i++) {
+            if (withZone) {
+                PROFILE_ZONE("bench zone");
+                sink = sink + 1;
+            } else {
+                sink = sink + 1;
+            }
+        }
+        return Bench::secondsSince(start) * 1e9 / static_cast<double>(count);
+    }
+
+    const Profiler::Track* findTrack(const std::vector<Profiler::Track>& tracks, const std::string& name) {
+        for (const Profiler::Track& track : tracks) {
+            if (track.name == name) return &track;
+        }
+        return nullptr;
+    }
+
+    std::size_t countOf(const std::string& text, const std::string& pattern) {
+        std::size_t count = 0;
+        for (std::size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) count++;
+        return count;
+    }
+
+    // Generate, light and mesh a region of chunks, returns the seconds it took
+    double buildRegion(int regionSize) {
+        const int chunkSize = ChunkStorage::SIZE;
+        PerlinNoise noiseGenerator(1337);
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<Chunk> chunks(regionSize * regionSize);
+        LightEngine engine;
+        for (int x = 0; x < regionSize; x++) {
+            for (int z = 0; z < regionSize; z++) {
+                chunks[x * regionSize + z].generate(x * chunkSize, z * chunkSize, noiseGenerator);
+                engine.lightChunk(chunks[x * regionSize + z]);
+            }
+        }
+
+        long long quads = 0;
+        for (int x = 1; x < regionSize - 1; x++) {
+            for (int z = 1; z < regionSize - 1; z++) {
+                auto at = [&](int dx, int dz) -> Chunk& { return chunks[(x + dx) * regionSize + z + dz]; };
+                ChunkMesher::Neighbours neighbours = {&at(-1, 0).getStorage(), &at(1, 0).getStorage(),
+                                                      &at(0, -1).getStorage(), &at(0, 1).getStorage()};
+                ChunkMesher::Light light{&at(0, 0).getLight(), {&at(-1, 0).getLight(), &at(1, 0).getLight(),
+                                                                &at(0, -1).getLight(), &at(0, 1).getLight()}};
+                for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                    if (at(0, 0).getStorage().isSectionEmpty(section)) continue;
+                    ChunkMeshData mesh = ChunkMesher::build(ChunkMesher::gather(at(0, 0).getStorage(), neighbours, section, 0, light), section);
+                    for (const MeshData& layer : mesh.layers) quads += static_cast<long long>(layer.indices.size() / 6);
+                }
+            }
+        }
+        sink = sink + static_cast<unsigned int>(quads);
+        return Bench::secondsSince(start);
+    }
+}
+
+int main(int argc, char** argv) {
+    const long long count = argc > 1 ? std::atoll(argv[1]) : 10000000;
+    if (count < 1000) {
+        std::fprintf(stderr, "usage: %s [zones per measure, at least 1000]\n", argv[0]);
+        return 1;
+    }
+
+    Profiler::setThreadName("main");
+
+    // Cost of a zone, over the cost of the loop without one
+    Profiler::setEnabled(false);
+    double bare = zoneCost(count, false);
+    double disabled = zoneCost(count, true);
+    Profiler::setEnabled(true);
+    double enabled = zoneCost(count, true);
+    Profiler::setEnabled(false);
+    std::printf("zone cost: disabled %.2f ns, enabled %.2f ns (loop alone %.2f ns)\n", disabled - bare, enabled - bare, bare);
+
+    // The main track kept the latest zones, up to the size of the ring
+    std::vector<Profiler::Track> tracks = Profiler::collect();
+    const Profiler::Track* main = findTrack(tracks, "main");
+    Bench::check(main && main->events.size() == Profiler::BUFFER_EVENTS, "a thread keeps its latest zones in its ring");
+    Bench::check(main && std::all_of(main->events.begin(), main->events.end(), [](const Profiler::Event& event) {
+                     return event.end >= event.start && std::string(event.name) == "bench zone";
+                 }), "recorded zones");
+
+    // Zones nest by depth and time
+    Profiler::clear();
+    tracks = Profiler::collect();
+    Bench::check(findTrack(tracks, "main")->events.empty(), "clear forgets the recorded zones");
+    Profiler::setEnabled(true);
+    {
+        PROFILE_ZONE("outer");
+        {
+            PROFILE_ZONE("inner");
+            sink = sink + 1;
+        }
+        PROFILE_ZONE("second inner");
+        sink = sink + 1;
+    }
+    Profiler::setEnabled(false);
+    tracks = Profiler::collect();
+    main = findTrack(tracks, "main");
+    bool nested = main && main->events.size() == 3 && std::string(main->events[2].name) == "outer" &&
+                  main->events[2].depth == 0 && main->events[0].depth == 1 && main->events[1].depth == 1 &&
+                  main->events[0].start >= main->events[2].start && main->events[1].end <= main->events[2].end &&
+                  main->events[0].end <= main->events[1].start;
+    Bench::check(nested, "zones nest inside the zone around them");
+
+    // Worker threads record on their own tracks
+    Profiler::clear();
+    Profiler::setEnabled(true);
+    const int workerCount = 4;
+    const int jobs = 64;
+    {
+        JobSystem jobSystem(workerCount);
+        for (int job = 0; job < jobs; job++) {
+            jobSystem.submit([] {
+                PROFILE_ZONE("job");
+                for (int i = 0; i < 10000; i++) sink = sink + 1;
+            });
+        }
+        jobSystem.wait();
+    }
+    Profiler::setEnabled(false);
+    tracks = Profiler::collect();
+    std::size_t workerTracks = 0, jobZones = 0;
+    for (const Profiler::Track& track : tracks) {
+        if (track.name.rfind("worker ", 0) != 0 || track.events.empty()) continue;
+        workerTracks++;
+        jobZones += track.events.size();
+    }
+    std::printf("%d jobs on %d workers: %zu worker tracks recorded %zu zones\n", jobs, workerCount, workerTracks, jobZones);
+    Bench::check(workerTracks >= 1 && jobZones == static_cast<std::size_t>(jobs), "every job zone is on a worker track");
+
+    // Chrome trace: a complete event per zone and a name per track
+    std::ostringstream trace;
+    Profiler::writeChromeTrace(trace);
+    std::string json = trace.str();
+    Bench::check(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 && json.find("\n]}") != std::string::npos,
+                 "the trace is one object holding the event array");
+    Bench::check(countOf(json, "\"ph\":\"X\"") == jobZones && countOf(json, "\"ph\":\"M\"") == tracks.size(),
+                 "the trace has a complete event per zone and a metadata event per track");
+    Bench::check(countOf(json, "{") == countOf(json, "}") && countOf(json, "[") == countOf(json, "]"), "the trace is balanced");
+
+    // Collect while a thread goes round its ring: the copies only hold whole zones
+    Profiler::clear();
+    Profiler::setEnabled(true);
+    std::atomic<bool> recording{true};
+    std::atomic<bool> recorded{false};
+    std::thread recorder([&recording, &recorded] {
+        Profiler::setThreadName("recorder");
+        while (recording.load(std::memory_order_relaxed)) {
+            PROFILE_ZONE("recorded zone");
+            recorded.store(true, std::memory_order_relaxed);
+        }
+    });
+    while (!recorded.load(std::memory_order_relaxed)) std::this_thread::yield();
+    std::size_t collectedZones = 0;
+    bool wholeZones = true;
+    for (int collection = 0; collection < 20; collection++) {
+        for (const Profiler::Track& track : Profiler::collect()) {
+            if (track.name != "recorder") continue;
+            collectedZones += track.events.size();
+            wholeZones = wholeZones && std::all_of(track.events.begin(), track.events.end(), [](const Profiler::Event& event) {
+                return event.name && std::string(event.name) == "recorded zone" && event.end >= event.start && event.depth == 0;
+            });
+        }
+    }
+    recording.store(false, std::memory_order_relaxed);
+    recorder.join();
+    Profiler::setEnabled(false);
+    Profiler::clear();
+    std::printf("collected %zu zones over 20 collections while they were recorded\n", collectedZones);
+    Bench::check(wholeZones, "zones collected while they are recorded are whole");
+
+    // The instrumented chunk code, with the profiler off and on
+    const int regionSize = 6;
+    buildRegion(regionSize);
+    double off = 1e30, on = 1e30;
+    for (int round = 0; round < 3; round++) {
+        Profiler::setEnabled(false);
+        off = std::min(off, buildRegion(regionSize));
+        Profiler::clear();
+        Profiler::setEnabled(true);
+        on = std::min(on, buildRegion(regionSize));
+        Profiler::setEnabled(false);
+    }
+    tracks = Profiler::collect();
+    std::size_t regionZones = findTrack(tracks, "main")->events.size();
+    std::printf("region of %dx%d chunks: %.2f ms off, %.2f ms on (%zu zones, %+.1f%%)\n", regionSize, regionSize,
+                off * 1000.0, on * 1000.0, regionZones, (on / off - 1.0) * 100.0);
+    Bench::check(regionZones > 0, "the chunk code records zones");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
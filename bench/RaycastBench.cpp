@@ -0,0 +1,154 @@
+// Measures rays/sec for short and long rays through generated terrain: the old traversal looking up
+// the chunk at every step, the chunk-caching traversal, and batches spread over the job system.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/VoxelQuery.h"
+#include "../src/Utils/JobSystem.h"
+#include "BenchUtil.h"
+
+namespace {
+    using ChunkMap = std::unordered_map<sf::Vector2i, Chunk>;
+
+    // The traversal Player::raycast used: chunk coordinates and a hash lookup at every step
+    VoxelQuery::RaycastHit legacyRaycast(const ChunkMap& chunks, const VoxelQuery::Ray& ray) {
+        const int chunkSize = ChunkStorage::SIZE;
+        sf::Vector3f direction = ray.direction;
+        direction /= std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+
+        sf::Vector3i blockPos(std::floor(ray.origin.x), std::floor(ray.origin.y), std::floor(ray.origin.z));
+        sf::Vector3f tMax, tDelta, step;
+        step.x = direction.x > 0 ? 1.0f : -1.0f;
+        step.y = direction.y > 0 ? 1.0f : -1.0f;
+        step.z = direction.z > 0 ? 1.0f : -1.0f;
+        tMax.x = direction.x > 0 ? (blockPos.x + 1 - ray.origin.x) / direction.x : (ray.origin.x - blockPos.x) / -direction.x;
+        tMax.y = direction.y > 0 ? (blockPos.y + 1 - ray.origin.y) / direction.y : (ray.origin.y - blockPos.y) / -direction.y;
+        tMax.z = direction.z > 0 ? (blockPos.z + 1 - ray.origin.z) / direction.z : (ray.origin.z - blockPos.z) / -direction.z;
+        tDelta = {std::abs(1.0f / direction.x), std::abs(1.0f / direction.y), std::abs(1.0f / direction.z)};
+
+        for (float distance = 0.0f; distance < ray.maxDistance;) {
+            sf::Vector3i normal;
+            if (tMax.x < tMax.y && tMax.x < tMax.z) {
+                blockPos.x += static_cast<int>(step.x);
+                distance = tMax.x;
+                tMax.x += tDelta.x;
+                normal = {-static_cast<int>(step.x), 0, 0};
+            } else if (tMax.y < tMax.z) {
+                blockPos.y += static_cast<int>(step.y);
+                distance = tMax.y;
+                tMax.y += tDelta.y;
+                normal = {0, -static_cast<int>(step.y), 0};
+            } else {
+                blockPos.z += static_cast<int>(step.z);
+                distance = tMax.z;
+                tMax.z += tDelta.z;
+                normal = {0, 0, -static_cast<int>(step.z)};
+            }
+            if (distance > ray.maxDistance) break;
+
+            int chunkX = (blockPos.x < 0) ? (blockPos.x - chunkSize + 1) / chunkSize : blockPos.x / chunkSize;
+            int chunkZ = (blockPos.z < 0) ? (blockPos.z - chunkSize + 1) / chunkSize : blockPos.z / chunkSize;
+            auto it = chunks.find({chunkX, chunkZ});
+            BlockType type = (it != chunks.end()) ? it->second.getBlockTypeAt(blockPos) : BlockType::AIR;
+            if (BlockRegistry::get(type).visible) {
+                VoxelQuery::RaycastHit hit;
+                hit.hit = true;
+                hit.block = blockPos;
+                hit.normal = normal;
+                hit.distance = distance;
+                hit.type = type;
+                return hit;
+            }
+        }
+        return {};
+    }
+
+    // Rays from a little above the surface in random directions, mostly horizontal
+    std::vector<VoxelQuery::Ray> makeRays(int count, float maxDistance, std::mt19937& random) {
+        std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+        std::uniform_real_distribution<float> height(14.0f, 30.0f);
+        std::uniform_real_distribution<float> horizontal(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> vertical(-0.5f, 0.2f);
+
+        std::vector<VoxelQuery::Ray> rays(count);
+        for (VoxelQuery::Ray& ray : rays) {
+            ray.origin = {position(random), height(random), position(random)};
+            ray.direction = {horizontal(random), vertical(random), horizontal(random)};
+            ray.maxDistance = maxDistance;
+        }
+        return rays;
+    }
+}
+
+int main() {
+    const int chunkSize = ChunkStorage::SIZE;
+    const int radius = 5;
+    PerlinNoise noiseGenerator(1337);
+
+    ChunkMap chunks;
+    for (int x = -radius; x <= radius; x++) {
+        for (int z = -radius; z <= radius; z++) {
+            chunks[{x, z}].generate(x * chunkSize, z * chunkSize, noiseGenerator);
+        }
+    }
+
+    auto getStorage = [&chunks](const sf::Vector2i& chunkPos) -> const ChunkStorage* {
+        auto it = chunks.find(chunkPos);
+        return it != chunks.end() ? &it->second.getStorage() : nullptr;
+    };
+
+    std::mt19937 random(42);
+    JobSystem jobSystem;
+
+    std::printf("%10s %8s %16s %16s %16s  (%u workers)\n", "ray", "hits", "legacy rays/s", "cached rays/s",
+                "batched rays/s", jobSystem.getWorkerCount());
+
+    for (float maxDistance : {8.0f, 64.0f}) {
+        const int count = 200000;
+        std::vector<VoxelQuery::Ray> rays = makeRays(count, maxDistance, random);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<VoxelQuery::RaycastHit> legacyHits(count);
+        for (int i = 0; i < count; i++) legacyHits[i] = legacyRaycast(chunks, rays[i]);
+        double legacyTime = Bench::secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<VoxelQuery::RaycastHit> cachedHits(count);
+        for (int i = 0; i < count; i++) {
+            cachedHits[i] = VoxelQuery::raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, getStorage);
+        }
+        double cachedTime = Bench::secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<VoxelQuery::RaycastHit> batchedHits(count);
+        jobSystem.parallelFor(rays.size(), 64, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                batchedHits[i] = VoxelQuery::raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance, getStorage);
+            }
+        });
+        double batchedTime = Bench::secondsSince(start);
+
+        // Every traversal must find the same block through the same face
+        int hits = 0;
+        for (int i = 0; i < count; i++) {
+            const VoxelQuery::RaycastHit& cached = cachedHits[i];
+            for (const VoxelQuery::RaycastHit* other : {&legacyHits[i], &batchedHits[i]}) {
+                if (other->hit != cached.hit || (cached.hit && (other->block != cached.block || other->normal != cached.normal))) {
+                    std::printf("ray %d does not match\n", i);
+                    return 1;
+                }
+            }
+            hits += cached.hit;
+        }
+
+        std::printf("%8.0f b %8d %16.0f %16.0f %16.0f\n", maxDistance, hits, count / legacyTime,
+                    count / cachedTime, count / batchedTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Checks the ring allocator of the mesh uploads headlessly and simulates the uploads of a world being
+// streamed in: bursts of section meshes within the byte budget of a frame, with the GPU finishing each
+// frame's copies a few frames later. Reports the bytes uploaded per frame, how often a write has to wait
+// for the GPU (a stall) with rings of several sizes, and the allocator throughput.
+// Usage: ring_allocator_bench [frames] (default 2000). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <vector>
+#include "../src/Config.h"
+#include "../src/Utils/RingAllocator.h"
+#include "BenchUtil.h"
+
+namespace {
+    void checkBasics() {
+        RingAllocator ring(256, 16);
+        Bench::check(ring.allocate(100) == std::optional<std::size_t>(0), "first allocation at the start");
+        Bench::check(ring.allocate(100) == std::optional<std::size_t>(112), "allocations are aligned");
+        Bench::check(ring.getUsed() == 224, "used bytes include the alignment");
+        Bench::check(!ring.allocate(64), "no room past the end before a fence is retired");
+
+        std::uint64_t first = ring.fence();
+        Bench::check(ring.getOldestFence() == std::optional<std::uint64_t>(first), "oldest fence");
+        ring.retire(first);
+        Bench::check(ring.getUsed() == 0 && !ring.getOldestFence(), "retiring the fence frees its allocations");
+
+        // Fill past the middle, free the start and wrap around to it
+        Bench::check(ring.allocate(160) == std::optional<std::size_t>(0), "empty ring starts over");
+        std::uint64_t second = ring.fence();
+        Bench::check(ring.allocate(64) == std::optional<std::size_t>(160), "allocation after the fenced one");
+        Bench::check(!ring.allocate(64), "the start is still in use");
+        ring.retire(second);
+        Bench::check(ring.allocate(64) == std::optional<std::size_t>(0), "wraps around once the start is retired");
+        Bench::check(ring.getUsed() == 64 + 32 + 64, "skipped end of the ring is counted as used");
+        Bench::check(!ring.allocate(128), "no room between the head and the tail");
+
+        std::uint64_t third = ring.fence();
+        ring.retire(third);
+        Bench::check(ring.getUsed() == 0, "everything retired");
+        Bench::check(!ring.allocate(0) && !ring.allocate(257), "empty and oversized allocations are refused");
+        Bench::check(ring.allocate(256) == std::optional<std::size_t>(0), "an empty ring holds an allocation of its whole size");
+    }
+
+    // Result of a simulated stream of uploads
+    struct Simulation {
+        double bytesPerFrame = 0.0;
+        long long stalls = 0;
+        long long wraps = 0;
+        long long allocations = 0;
+        bool overlaps = false;
+    };
+
+    // Upload bursts of meshes for a number of frames; the GPU passes a fence latency frames after it was made.
+    // With tracking on, every byte of the ring counts the live allocations covering it.
+    Simulation simulate(std::size_t capacity, int frames, int latency, bool tracking) {
+        std::mt19937 generator(7);
+        std::uniform_int_distribution<int> meshBytes(1 << 10, 24 << 10);  // Vertex or index data of one section
+        std::uniform_int_distribution<int> burst(0, 9);
+
+        RingAllocator ring(capacity);
+        std::deque<std::pair<std::uint64_t, int>> fences;  // Token and the frame it was made in
+        std::deque<std::vector<std::pair<std::size_t, std::size_t>>> fencedRanges;
+        std::vector<std::pair<std::size_t, std::size_t>> frameRanges;
+        std::vector<unsigned char> live(tracking ? capacity : 0, 0);
+
+        Simulation result;
+        std::size_t lastOffset = 0;
+        long long totalBytes = 0;
+
+        auto retireOldest = [&]() {
+            ring.retire(fences.front().first);
+            fences.pop_front();
+            if (tracking) {
+                for (const auto& range : fencedRanges.front()) {
+                    for (std::size_t i = range.first; i < range.second; i++) live[i]--;
+                }
+                fencedRanges.pop_front();
+            }
+        };
+        auto fence = [&](int frame) {
+            fences.emplace_back(ring.fence(), frame);
+            if (tracking) fencedRanges.push_back(std::move(frameRanges));
+            frameRanges.clear();
+        };
+
+        std::size_t backlog = 0;
+        for (int frame = 0; frame < frames; frame++) {
+            // One frame in ten a burst of chunks finishes meshing together, the budget spreads it over frames
+            const std::size_t budget = Config::World::UPLOAD_BYTES_PER_FRAME;
+            backlog += burst(generator) == 0 ? budget * 4 : budget / 4;
+            std::size_t frameBytes = 0;
+            while (frameBytes < std::min(backlog, budget)) {
+                std::size_t size = static_cast<std::size_t>(meshBytes(generator));
+                std::optional<std::size_t> offset = ring.allocate(size);
+                if (!offset) {
+                    result.stalls++;
+                    while (!offset) {
+                        if (fences.empty()) fence(frame);
+                        retireOldest();
+                        offset = ring.allocate(size);
+                    }
+                }
+
+                if (*offset < lastOffset) result.wraps++;
+                lastOffset = *offset;
+                if (tracking) {
+                    for (std::size_t i = *offset; i < *offset + size; i++) {
+                        if (live[i]++ != 0) result.overlaps = true;
+                    }
+                    frameRanges.emplace_back(*offset, *offset + size);
+                }
+
+                frameBytes += size;
+                result.allocations++;
+            }
+            backlog -= std::min(backlog, frameBytes);
+            totalBytes += static_cast<long long>(frameBytes);
+
+            fence(frame);
+            while (!fences.empty() && fences.front().second <= frame - latency) retireOldest();
+        }
+
+        while (!fences.empty()) retireOldest();
+        if (ring.getUsed() != 0) result.overlaps = true;
+        if (tracking && std::any_of(live.begin(), live.end(), [](unsigned char count) { return count != 0; })) result.overlaps = true;
+
+        result.bytesPerFrame = static_cast<double>(totalBytes) / frames;
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (frames <= 0) {
+        std::fprintf(stderr, "usage: %s [frames]\n", argv[0]);
+        return 1;
+    }
+
+    checkBasics();
+
+    // A small ring with every byte tracked: allocations in use never overlap and the ring wraps around
+    Simulation tracked = simulate(Config::World::UPLOAD_BYTES_PER_FRAME * 3, std::min(frames, 300), 2, true);
+    Bench::check(!tracked.overlaps, "live allocations never overlap and the ring drains to empty");
+    Bench::check(tracked.wraps > 0, "the ring wraps around");
+
+    std::printf("budget %.0f KiB/frame, %d frames, bursts of 4 frames of budget one frame in ten\n",
+                Config::World::UPLOAD_BYTES_PER_FRAME / 1024.0, frames);
+    std::printf("ring MiB   GPU latency   KiB/frame   stalls/1000 frames\n");
+    const std::size_t sizes[] = {1, 2, 4, 8};
+    for (std::size_t megabytes : sizes) {
+        for (int latency : {1, 3}) {
+            Simulation simulation = simulate(megabytes << 20, frames, latency, false);
+            std::printf("%8zu   %11d   %9.1f   %18.1f\n", megabytes, latency, simulation.bytesPerFrame / 1024.0,
+                        1000.0 * simulation.stalls / frames);
+            if (megabytes << 20 == Config::World::UPLOAD_RING_SIZE) {
+                Bench::check(simulation.stalls == 0, "the configured ring never stalls within the budget");
+            }
+        }
+    }
+
+    // Allocator alone: allocate and retire small ranges as fast as possible
+    RingAllocator ring(Config::World::UPLOAD_RING_SIZE);
+    const int operations = 4000000;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; i++) {
+        if (!ring.allocate(4096)) ring.retire(ring.fence());
+        if (i % 64 == 63) ring.fence();
+    }
+    std::printf("allocator  %.1f M allocations/s\n", operations / Bench::secondsSince(start) / 1e6);
+
+    return Bench::failures > 0 ? 1 : 0;
+}
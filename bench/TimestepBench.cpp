@@ -0,0 +1,149 @@
+// Checks the fixed timestep loop of Game headless: ticks per simulated second at several frame rates with
+// jittered frame times, the catch-up limit after a hitch, and the interpolation fraction. Then a jump with the
+// gravity integration of Player, stepped once per frame with the raw frame time against fixed ticks, to show
+// the apex only depends on the frame rate in the first case. Last, a loaded World run headless as fast as
+// it goes, the most ticks per frame and one streaming update per frame, reported as simulated seconds per
+// real second.
+// Usage: timestep_bench [seed] [simulated seconds] (defaults 1337 and 600). Returns nonzero if a check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "../src/Config.h"
+#include "../src/Core/World.h"
+#include "../src/Utils/FixedTimestep.h"
+#include "BenchUtil.h"
+
+namespace {
+    // Frame times around 1 / frameRate, each up to 20% off
+    std::vector<float> frameTimes(float frameRate, float seconds, unsigned int seed) {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> jitter(0.8f, 1.2f);
+        std::vector<float> times;
+        for (float total = 0.0f; total < seconds; ) {
+            times.push_back(jitter(generator) / frameRate);
+            total += times.back();
+        }
+        return times;
+    }
+
+    // Vertical motion of a jump, integrated like Player::updateVerticalMovement
+    struct Jump {
+        float height = 0.0f;
+        float velocity = Config::Player::JUMP_VELOCITY;
+        float apex = 0.0f;
+
+        void step(float deltaTime) {
+            velocity -= Config::Player::GRAVITY * deltaTime;
+            height += velocity * deltaTime;
+            apex = std::max(apex, height);
+        }
+
+        [[nodiscard]] bool landed() const {
+            return height < 0.0f;
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const float simulatedSeconds = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 600.0f;
+    const float tickRate = Config::Simulation::TICK_RATE;
+    const int maxTicks = Config::Simulation::MAX_TICKS_PER_FRAME;
+    const std::vector<float> frameRates = {30.0f, 60.0f, 75.0f, 144.0f, 240.0f};
+
+    // Ticks over ten seconds of frames, whatever the frame rate
+    std::printf("%-10s %8s %10s %12s %12s\n", "frame rate", "ticks", "expected", "ticks/s", "frames/s");
+    for (float frameRate : frameRates) {
+        FixedTimestep timestep(tickRate, maxTicks);
+        double elapsed = 0.0;
+        long long ticks = 0;
+        bool alphaInRange = true;
+        for (float frameTime : frameTimes(frameRate, 10.0f, seed)) {
+            ticks += timestep.advance(frameTime);
+            elapsed += frameTime;
+            alphaInRange = alphaInRange && timestep.getAlpha() >= 0.0f && timestep.getAlpha() <= 1.0f;
+        }
+        long long expected = static_cast<long long>(elapsed * tickRate);
+        std::printf("%-10.0f %8lld %10lld %12.1f %12.1f\n", frameRate, ticks, expected, timestep.getMeasuredTickRate(),
+                    timestep.getMeasuredFrameRate());
+
+        Bench::check(std::llabs(ticks - expected) <= 1 && timestep.getDroppedTicks() == 0, "one tick per tick length of real time");
+        Bench::check(alphaInRange, "the interpolation fraction stays between 0 and 1");
+        Bench::check(std::abs(timestep.getMeasuredTickRate() - tickRate) < tickRate * 0.05f, "measured tick rate");
+        Bench::check(std::abs(timestep.getMeasuredFrameRate() - frameRate) < frameRate * 0.05f, "measured frame rate");
+    }
+
+    // A two second hitch runs the catch-up limit and drops the rest
+    FixedTimestep hitch(tickRate, maxTicks);
+    int hitchTicks = hitch.advance(2.0f);
+    int nextTicks = hitch.advance(1.0f / tickRate);
+    std::printf("2 s hitch: %d ticks, %lld dropped, then %d tick\n", hitchTicks, hitch.getDroppedTicks(), nextTicks);
+    Bench::check(hitchTicks == maxTicks && nextTicks == 1, "a hitch runs at most the catch-up limit");
+    Bench::check(hitch.getDroppedTicks() == static_cast<long long>(2.0f * tickRate) - maxTicks, "the rest of a hitch is dropped");
+
+    // The same jump stepped by frames and by ticks
+    std::printf("\n%-10s %14s %14s %14s\n", "frame rate", "apex per frame", "apex per tick", "airtime ticks");
+    std::vector<float> frameApexes, tickApexes;
+    std::vector<int> tickAirtimes;
+    for (float frameRate : frameRates) {
+        Jump perFrame;
+        for (float frameTime : frameTimes(frameRate, 10.0f, seed)) {
+            if (perFrame.landed()) break;
+            perFrame.step(frameTime);
+        }
+
+        Jump perTick;
+        FixedTimestep timestep(tickRate, maxTicks);
+        int airtime = 0;
+        for (float frameTime : frameTimes(frameRate, 10.0f, seed)) {
+            int ticks = timestep.advance(frameTime);
+            for (int tick = 0; tick < ticks && !perTick.landed(); tick++, airtime++) perTick.step(timestep.getTickTime());
+            if (perTick.landed()) break;
+        }
+
+        std::printf("%-10.0f %14.4f %14.4f %14d\n", frameRate, perFrame.apex, perTick.apex, airtime);
+        frameApexes.push_back(perFrame.apex);
+        tickApexes.push_back(perTick.apex);
+        tickAirtimes.push_back(airtime);
+    }
+    auto [lowFrame, highFrame] = std::minmax_element(frameApexes.begin(), frameApexes.end());
+    std::printf("apex spread: %.4f blocks per frame, %.4f per tick\n", *highFrame - *lowFrame,
+                *std::max_element(tickApexes.begin(), tickApexes.end()) - *std::min_element(tickApexes.begin(), tickApexes.end()));
+    Bench::check(std::all_of(tickApexes.begin(), tickApexes.end(), [&](float apex) { return apex == tickApexes[0]; }) &&
+                 std::all_of(tickAirtimes.begin(), tickAirtimes.end(), [&](int airtime) { return airtime == tickAirtimes[0]; }),
+                 "a jump in ticks is the same at every frame rate");
+
+    // A loaded world run headless, with no frames to wait for: each frame runs the most ticks it may
+    World world(seed);
+    const sf::Vector3f player = Config::Player::POSITION;
+    world.init(player);
+    Bench::loadChunksAround(world, player, world.getLoadRadius());
+
+    FixedTimestep timestep(tickRate, maxTicks);
+    const long long worldTicks = static_cast<long long>(simulatedSeconds * tickRate);
+    float startTime = world.getTimeOfDay();
+    const float frameTime = static_cast<float>(maxTicks) * timestep.getTickTime();
+    long long ticksRun = 0, frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (ticksRun < worldTicks) {
+        int ticks = static_cast<int>(std::min<long long>(timestep.advance(frameTime), worldTicks - ticksRun));
+        for (int tick = 0; tick < ticks; tick++) world.tick(timestep.getTickTime());
+        world.update(frameTime, player);
+        ticksRun += ticks;
+        frames++;
+    }
+    double realSeconds = Bench::secondsSince(start);
+
+    float simulatedDays = static_cast<float>(worldTicks) * timestep.getTickTime() / Config::World::DAY_LENGTH;
+    float expectedTime = std::fmod(startTime + simulatedDays, 1.0f);
+    std::printf("\nheadless world: %lld ticks in %lld frames (%.0f s simulated) in %.3f s real, %.0fx real time\n",
+                worldTicks, frames, static_cast<double>(worldTicks) / tickRate, realSeconds, static_cast<double>(worldTicks) / tickRate / realSeconds);
+    Bench::check(std::abs(world.getTimeOfDay() - expectedTime) < 1e-3f, "the world clock follows the ticks");
+
+    return Bench::failures > 0 ? 1 : 0;
+}
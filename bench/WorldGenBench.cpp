@@ -0,0 +1,101 @@
+// Generates an N x N chunk region for a seed without a window, prints a checksum of the voxel data and
+// the time spent in each stage. Usage: worldgen_bench [seed] [region size in chunks] (default 1337 16).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Core/ChunkMesher.h"
+#include "BenchUtil.h"
+
+namespace {
+    // FNV-1a over the block types of a chunk, in storage order
+    std::uint64_t hashChunk(const ChunkStorage& storage, std::uint64_t hash) {
+        for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+            for (int z = 0; z < ChunkStorage::SIZE; z++) {
+                for (int x = 0; x < ChunkStorage::SIZE; x++) {
+                    hash ^= static_cast<std::uint8_t>(storage.get(x, y, z));
+                    hash *= 1099511628211ull;
+                }
+            }
+        }
+        return hash;
+    }
+}
+
+int main(int argc, char** argv) {
+    const unsigned int seed = argc > 1 ? static_cast<unsigned int>(std::strtoul(argv[1], nullptr, 10)) : 1337;
+    const int regionSize = argc > 2 ? std::atoi(argv[2]) : 16;
+    if (regionSize <= 0) {
+        std::fprintf(stderr, "usage: %s [seed] [region size in chunks]\n", argv[0]);
+        return 1;
+    }
+
+    const int chunkSize = ChunkStorage::SIZE;
+    PerlinNoise noiseGenerator(seed);  // Built the same way World builds its generator
+
+    // Stage 1: terrain, the chunks are centered on the origin like the chunks around the spawn
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Chunk> chunks(regionSize * regionSize);
+    for (int x = 0; x < regionSize; x++) {
+        for (int z = 0; z < regionSize; z++) {
+            int chunkX = x - regionSize / 2;
+            int chunkZ = z - regionSize / 2;
+            chunks[x * regionSize + z].generate(chunkX * chunkSize, chunkZ * chunkSize, noiseGenerator);
+        }
+    }
+    double generateTime = Bench::secondsSince(start);
+
+    // Stage 2: meshing, every chunk with the neighbours that are inside the region
+    auto storageAt = [&](int x, int z) -> const ChunkStorage* {
+        if (x < 0 || z < 0 || x >= regionSize || z >= regionSize) return nullptr;
+        return &chunks[x * regionSize + z].getStorage();
+    };
+
+    double gatherTime = 0.0, buildTime = 0.0;
+    long long quads = 0;
+    for (int x = 0; x < regionSize; x++) {
+        for (int z = 0; z < regionSize; z++) {
+            ChunkMesher::Neighbours neighbours = {storageAt(x - 1, z), storageAt(x + 1, z),
+                                                  storageAt(x, z - 1), storageAt(x, z + 1)};
+
+            start = std::chrono::steady_clock::now();
+            ChunkMesher::Volume volume = ChunkMesher::gather(*storageAt(x, z), neighbours);
+            gatherTime += Bench::secondsSince(start);
+
+            start = std::chrono::steady_clock::now();
+            quads += ChunkMesher::build(volume).quads;
+            buildTime += Bench::secondsSince(start);
+        }
+    }
+
+    // Stage 3: checksum of the voxel data
+    start = std::chrono::steady_clock::now();
+    std::uint64_t checksum = 14695981039346656037ull;
+    std::size_t memory = 0;
+    int emptySections = 0, uniformSections = 0;
+    for (const Chunk& chunk : chunks) {
+        checksum = hashChunk(chunk.getStorage(), checksum);
+        memory += chunk.getStorage().memoryUsage();
+        for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+            emptySections += chunk.getStorage().isSectionEmpty(section);
+            uniformSections += chunk.getStorage().isSectionUniform(section);
+        }
+    }
+    double checksumTime = Bench::secondsSince(start);
+
+    int chunkCount = regionSize * regionSize;
+    std::printf("seed %u, %d x %d chunks\n", seed, regionSize, regionSize);
+    std::printf("checksum   %016llx\n", static_cast<unsigned long long>(checksum));
+    std::printf("generate   %9.2f ms  (%.3f ms/chunk)\n", generateTime * 1e3, generateTime * 1e3 / chunkCount);
+    std::printf("gather     %9.2f ms  (%.3f ms/chunk)\n", gatherTime * 1e3, gatherTime * 1e3 / chunkCount);
+    std::printf("build      %9.2f ms  (%.3f ms/chunk, %lld quads)\n", buildTime * 1e3, buildTime * 1e3 / chunkCount, quads);
+    std::printf("checksum   %9.2f ms\n", checksumTime * 1e3);
+    std::printf("storage    %9.2f KiB\n", memory / 1024.0);
+    std::printf("sections   %9d  (%d empty, %d uniform)\n", chunkCount * ChunkStorage::SECTION_COUNT, emptySections,
+                uniformSections);
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Opens a large saved world and loads the chunks around the player, with region files read through
+// memory mappings and through buffered reads. Reports the time until the chunks of the first frame are
+// loaded, the time to load the whole view and the resident memory afterwards. Each mode runs in its own
+// process so the memory numbers do not mix. Usage: world_load_bench [world size in regions] (default 4).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../src/Core/Chunk.h"
+#include "../src/Save/ChunkSerializer.h"
+#include "../src/Save/WorldSave.h"
+#include "BenchUtil.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const int TILE_SIZE = 8;     // The world repeats an 8x8 block of generated chunks
+    const int VIEW_RADIUS = 16;  // Chunks loaded around the player for the full view
+    const int FIRST_FRAME_RADIUS = Config::World::RENDER_DISTANCE + Config::World::LOAD_MARGIN;  // Load radius of a new game
+
+    // FNV-1a over the block types of a chunk
+    std::uint64_t hashChunk(const ChunkStorage& storage) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (int y = 0; y < ChunkStorage::HEIGHT; y++) {
+            for (int z = 0; z < ChunkStorage::SIZE; z++) {
+                for (int x = 0; x < ChunkStorage::SIZE; x++) {
+                    hash ^= static_cast<std::uint8_t>(storage.get(x, y, z));
+                    hash *= 1099511628211ull;
+                }
+            }
+        }
+        return hash;
+    }
+
+    // Chunk of the tile stored at a (non-negative) chunk position. Regions are a whole number of tiles,
+    // so local coordinates inside a region give the same tile.
+    int tileIndex(int chunkX, int chunkZ) {
+        return chunkX % TILE_SIZE * TILE_SIZE + chunkZ % TILE_SIZE;
+    }
+
+    // Chunks inside a radius around a center, closest first like World::streamChunks queues them
+    std::vector<sf::Vector2i> chunksAround(const sf::Vector2i& center, int radius) {
+        std::vector<sf::Vector2i> positions;
+        for (int distance = 0; distance <= radius * radius; distance++) {
+            for (int x = -radius; x <= radius; x++) {
+                for (int z = -radius; z <= radius; z++) {
+                    if (x * x + z * z == distance) positions.emplace_back(center.x + x, center.y + z);
+                }
+            }
+        }
+        return positions;
+    }
+
+    // Resident memory of the process in KiB: total, anonymous (heap) and file-backed (mapped) pages
+    void residentMemory(long& total, long& anonymous, long& file) {
+        total = anonymous = file = -1;
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            long value;
+            if (std::sscanf(line.c_str(), "VmRSS: %ld", &value) == 1) total = value;
+            else if (std::sscanf(line.c_str(), "RssAnon: %ld", &value) == 1) anonymous = value;
+            else if (std::sscanf(line.c_str(), "RssFile: %ld", &value) == 1) file = value;
+        }
+    }
+
+    // Drop the region files from the page cache so every load starts cold (Linux only)
+    void evictFromPageCache(const std::filesystem::path& directory) {
+#ifdef __linux__
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            int descriptor = open(entry.path().c_str(), O_RDONLY);
+            if (descriptor < 0) continue;
+            fdatasync(descriptor);
+            posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+            close(descriptor);
+        }
+#else
+        (void) directory;
+#endif
+    }
+
+    // Child process: load the first frame and the full view in one mode and check the loaded chunks
+    int runLoad(const char* mode, const char* cache, const std::string& directory, int worldSize, std::uint64_t expected) {
+        bool mapped = std::strcmp(mode, "mapped") == 0;
+        sf::Vector2i center(worldSize / 2, worldSize / 2);
+        std::vector<sf::Vector2i> firstFrame = chunksAround(center, FIRST_FRAME_RADIUS);
+        std::vector<sf::Vector2i> view = chunksAround(center, VIEW_RADIUS);
+
+        std::vector<ChunkStorage> loaded(view.size());
+
+        auto start = std::chrono::steady_clock::now();
+        WorldSave save(directory, mapped ? WorldSave::ReadMode::MAPPED : WorldSave::ReadMode::BUFFERED);
+        for (std::size_t i = 0; i < firstFrame.size(); i++) {
+            if (!save.loadChunk(firstFrame[i], loaded[i])) return 1;
+        }
+        double firstFrameTime = Bench::secondsSince(start);
+
+        for (std::size_t i = firstFrame.size(); i < view.size(); i++) {
+            if (!save.loadChunk(view[i], loaded[i])) return 1;
+        }
+        double viewTime = Bench::secondsSince(start);
+
+        long total, anonymous, file;
+        residentMemory(total, anonymous, file);
+
+        std::size_t heapBytes = 0;
+        int borrowed = 0;
+        std::uint64_t checksum = 0;
+        for (const ChunkStorage& storage : loaded) {
+            heapBytes += storage.memoryUsage();
+            borrowed += storage.borrowedSectionCount();
+            checksum += hashChunk(storage);
+        }
+
+        std::printf("%-9s %-5s %10.2f ms %10.2f ms %10ld %10ld %10ld %10.0f %9d\n", mode, cache, firstFrameTime * 1e3,
+                    viewTime * 1e3, total, anonymous, file, heapBytes / 1024.0, borrowed);
+        if (checksum != expected) {
+            std::printf("FAILED: the %s load does not match the saved chunks\n", mode);
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc == 7 && std::strcmp(argv[1], "--load") == 0) {
+        return runLoad(argv[2], argv[3], argv[4], std::atoi(argv[5]), std::strtoull(argv[6], nullptr, 16));
+    }
+
+    const int regions = argc > 1 ? std::atoi(argv[1]) : 4;
+    if (regions <= 0) {
+        std::fprintf(stderr, "usage: %s [world size in regions]\n", argv[0]);
+        return 1;
+    }
+    const int worldSize = regions * RegionFile::SIZE;  // In chunks
+    const int chunkSize = ChunkStorage::SIZE;
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "minecraft_world_load_bench";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // A tile of generated chunks with a few edits, repeated over the whole world
+    PerlinNoise noiseGenerator(1337);
+    std::vector<std::vector<std::uint8_t>> payloads;
+    std::vector<std::uint64_t> hashes;
+    for (int x = 0; x < TILE_SIZE; x++) {
+        for (int z = 0; z < TILE_SIZE; z++) {
+            Chunk chunk;
+            chunk.generate(x * chunkSize, z * chunkSize, noiseGenerator);
+            for (int i = 0; i < 8; i++) {
+                chunk.setBlockAt({x * chunkSize + i, 30 + i, z * chunkSize + i}, BlockType::PLANKS);
+            }
+            payloads.push_back(ChunkSerializer::encode(chunk.getStorage()));
+            hashes.push_back(hashChunk(chunk.getStorage()));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uintmax_t worldBytes = 0;
+    for (int regionX = 0; regionX < regions; regionX++) {
+        for (int regionZ = 0; regionZ < regions; regionZ++) {
+            std::filesystem::path path = directory / RegionFile::fileName(regionX, regionZ);
+            {
+                RegionFile region(path.string());
+                for (int x = 0; x < RegionFile::SIZE; x++) {
+                    for (int z = 0; z < RegionFile::SIZE; z++) {
+                        region.writeChunk(x, z, payloads[tileIndex(x, z)]);
+                    }
+                }
+            }
+            worldBytes += std::filesystem::file_size(path);
+        }
+    }
+    double writeTime = Bench::secondsSince(start);
+
+    sf::Vector2i center(worldSize / 2, worldSize / 2);
+    std::uint64_t expected = 0;
+    for (const sf::Vector2i& chunkPos : chunksAround(center, VIEW_RADIUS)) {
+        expected += hashes[tileIndex(chunkPos.x, chunkPos.y)];
+    }
+
+    std::printf("world: %d x %d chunks, %.1f MiB of region files (written in %.2f s)\n", worldSize, worldSize,
+                worldBytes / (1024.0 * 1024.0), writeTime);
+    std::printf("first frame: %zu chunks, view: %zu chunks, cold runs drop the files from the page cache first\n",
+                chunksAround(center, FIRST_FRAME_RADIUS).size(), chunksAround(center, VIEW_RADIUS).size());
+    std::printf("%-15s %13s %13s %10s %10s %10s %10s %9s\n", "mode", "first frame", "view", "RSS KiB",
+                "anon KiB", "file KiB", "heap KiB", "borrowed");
+    std::fflush(stdout);
+
+    int failures = 0;
+    char expectedText[32];
+    std::snprintf(expectedText, sizeof(expectedText), "%016llx", static_cast<unsigned long long>(expected));
+    for (const char* cache : {"cold", "warm"}) {
+        for (const char* mode : {"buffered", "mapped"}) {
+            if (std::strcmp(cache, "cold") == 0) evictFromPageCache(directory);
+            std::string command = "\"" + std::string(argv[0]) + "\" --load " + mode + " " + cache + " \"" +
+                                  directory.string() + "\" " + std::to_string(worldSize) + " " + expectedText;
+            if (std::system(command.c_str()) != 0) failures++;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return failures > 0 ? 1 : 0;
+}
@@ -2,24 +2,33 @@
 #define MINECRAFTCLONE_CONFIG_H
 
 
+#include <cstddef>
 #include <string>
-#include <SFML/Graphics/Font.hpp>
-#include <Windows.h>
 #include <SFML/System/Vector3.hpp>
 
 namespace Config {
-    static std::string executablePath;
-
     namespace Window {
         const unsigned int WIDTH = 1920;
         const unsigned int HEIGHT = 1080;
         const std::string TITLE = "Minecraft Clone";
 
         const unsigned int DEPTH_BITS = 24;
+        const unsigned int OPENGL_MAJOR = 3;  // OpenGL context requested, the version the world renderer targets and checks for
+        const unsigned int OPENGL_MINOR = 3;
 
         const unsigned int FPS = 60;
     }
 
+    namespace Simulation {
+        const float TICK_RATE = 60.0f;          // Simulation ticks per second, whatever the frame rate
+        const int MAX_TICKS_PER_FRAME = 5;      // Ticks a frame may run to catch up, the rest of a longer hitch is dropped
+    }
+
+    namespace Profiling {
+        const bool START_ENABLED = false;                   // Record the profiler zones from the start (F9 toggles them)
+        const std::string TRACE_FILE = "profile.json";      // Chrome trace written when the recording stops
+    }
+
     namespace Widgets {
         const unsigned int TITLE_FONT_SIZE = 100;
 
@@ -54,24 +63,41 @@ namespace Config {
 
     namespace World {
         const int CHUNK_SIZE = 16;
-        const int CHUNKS_GENERATION = 1;
-        const int RENDER_DISTANCE = 1;
+        const int CHUNK_HEIGHT = 256;
+        const int SECTION_HEIGHT = 16;
+        const int RENDER_DISTANCE = 1;                      // Render distance a world starts with (PageUp and PageDown change it in game)
+        const int MAX_RENDER_DISTANCE = 32;
+
+        const int LOAD_MARGIN = 2;                          // Chunks past the render distance that are generated
+        const int UNLOAD_MARGIN = 2;                        // Chunks past the load radius kept before eviction (the gap avoids thrashing at the border)
+        const int MAX_PENDING_CHUNKS = 16;                  // Chunks queued for generation at the same time
+
+        const unsigned int WORKER_THREADS = 0;          // Worker threads for generation and meshing (0 = one per core)
+        const float CHUNK_INTEGRATION_BUDGET = 2.0f;    // Milliseconds per frame spent moving generated chunks into the world
+        const float MESH_UPLOAD_BUDGET = 4.0f;          // Milliseconds per frame spent uploading finished meshes
+        const std::size_t UPLOAD_BYTES_PER_FRAME = 1 << 20;  // Mesh bytes uploaded per frame (edited sections may go over)
+        const std::size_t UPLOAD_RING_SIZE = 8 << 20;         // Staging ring the uploads go through, several frames of budget
+        const std::size_t MESH_ARENA_VERTICES = 1 << 20;      // Initial size of the vertex arena of the chunk meshes (it grows when full)
+        const std::size_t MESH_ARENA_INDICES = 3 << 19;       // Initial size of the index arena, 6 indices for every 4 vertices
+        const int EDITED_SECTIONS_PER_FRAME = 8;        // Edited sections meshed on the main thread to show the edit in the next frame
+        const int MESH_REQUESTS_PER_FRAME = 128;        // Other dirty sections gathered for the workers per frame (the rest wait)
+        const int LOD1_DISTANCE = 8;                    // Chunks this far away (in chunks) are meshed with 2x2x2 block cells
+        const int LOD2_DISTANCE = 16;                   // Chunks this far away are meshed with 4x4x4 block cells
+        const std::size_t VERTEX_BUDGET = MESH_ARENA_VERTICES;  // Vertices the meshes of the whole view may take, what the arena holds before growing (the rings move closer to stay under it)
+        // Vertices of a chunk mesh at each level of detail, as lod_bench measures them. It fails when a measured
+        // count is more than 10% off this table: a mesher change that does this must update it.
+        const float LOD_CHUNK_VERTICES[] = {1140.0f, 306.0f, 110.0f};
+
+        const std::string SAVE_DIRECTORY = "saves/world";   // Folder of the saved world, relative to the working directory
+        const float AUTOSAVE_INTERVAL = 30.0f;              // Seconds between saves of the edited chunks
+
+        const float DAY_LENGTH = 600.0f;                // Seconds of a full day and night
+        const float START_TIME_OF_DAY = 0.3f;           // Time of day a world starts at (0 = midnight, 0.5 = noon)
+        const float NIGHT_SKY_LIGHT = 0.25f;            // Share of the sky light left at night
 
         const sf::Vector3f SKY_COLOR = {0.431f, 0.694f, 1.0f};
+        const sf::Vector3f NIGHT_SKY_COLOR = {0.02f, 0.03f, 0.08f};
     }
-
-    class Assets {
-    public:
-        sf::Font font;
-
-    private:
-        static Assets* assets;
-        Assets();
-
-    public:
-        Assets(const Assets& other) = default;
-        static Assets& get();
-    };
 }
 
 
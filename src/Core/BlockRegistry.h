@@ -0,0 +1,147 @@
+#ifndef MINECRAFTCLONE_BLOCKREGISTRY_H
+#define MINECRAFTCLONE_BLOCKREGISTRY_H
+
+
+#include <array>
+#include <cstdint>
+#include "BlockType.h"
+
+// Compile-time table of per-type block properties. A voxel only stores its BlockType,
+// everything else (flags, atlas tiles, normalized and rotated texture coordinates) is looked up here.
+namespace BlockRegistry {
+    // Atlas is 256x256, each tile is 16x16
+    constexpr int ATLAS_SIZE = 256;
+    constexpr int TILE_SIZE = 16;
+    constexpr int TILES_PER_ROW = ATLAS_SIZE / TILE_SIZE;
+
+    // Faces of a block, in the order used by the cube indices
+    enum Face {
+        FRONT,   // -Z
+        BACK,    // +Z
+        BOTTOM,  // -Y
+        TOP,     // +Y
+        LEFT,    // -X
+        RIGHT,   // +X
+        FACE_COUNT
+    };
+
+    // Render pass a block is drawn in
+    enum Layer {
+        OPAQUE,       // Fully opaque blocks
+        CUTOUT,       // Blocks with fully transparent texels (leaves)
+        TRANSLUCENT,  // Blended blocks (water)
+        LAYER_COUNT
+    };
+
+    // Atlas tile and texture coordinates of one block face
+    struct FaceTexture {
+        std::uint8_t tile;                          // Tile index in the atlas (row * TILES_PER_ROW + column)
+        int rotation;                               // Rotation of the texture in degrees
+        std::array<std::array<float, 2>, 4> uv;     // Normalized UVs for the bottom-left, bottom-right, top-right and top-left corners
+    };
+
+    struct BlockProperties {
+        bool visible;   // Whether the block is drawn at all (AIR is invisible)
+        bool opaque;    // Whether the block hides the faces behind it
+        bool solid;     // Whether the block collides with the player
+        Layer layer;    // Render pass of the block
+        std::uint8_t emission;  // Block light given off by the block (0 to 15)
+        std::array<FaceTexture, FACE_COUNT> faces;
+    };
+
+    // Build the texture of a face from its tile position in the atlas and its rotation
+    constexpr FaceTexture face(int column, int row, int rotation) {
+        float left = static_cast<float>(column * TILE_SIZE) / ATLAS_SIZE;
+        float right = static_cast<float>(column * TILE_SIZE + TILE_SIZE) / ATLAS_SIZE;
+        float top = static_cast<float>(row * TILE_SIZE) / ATLAS_SIZE;
+        float bottom = static_cast<float>(row * TILE_SIZE + TILE_SIZE) / ATLAS_SIZE;
+
+        std::array<std::array<float, 2>, 4> corners = {{
+                {left, bottom},   // Bottom-left
+                {right, bottom},  // Bottom-right
+                {right, top},     // Top-right
+                {left, top}       // Top-left
+        }};
+
+        // Rotating the texture shifts which corner of the tile lands on each corner of the face
+        int shift = 0;
+        if (rotation == 90) shift = 1;
+        else if (rotation == 180) shift = 2;
+        else if (rotation == 270 || rotation == -90) shift = 3;
+
+        FaceTexture result{static_cast<std::uint8_t>(row * TILES_PER_ROW + column), rotation, {}};
+        for (int corner = 0; corner < 4; corner++) {
+            result.uv[corner] = corners[(corner + shift) % 4];
+        }
+        return result;
+    }
+
+    // Block with the same tile on every face
+    constexpr std::array<FaceTexture, FACE_COUNT> uniformFaces(std::array<int, 2> tile) {
+        return {face(tile[0], tile[1], 180), face(tile[0], tile[1], -90), face(tile[0], tile[1], 0),
+                face(tile[0], tile[1], 0), face(tile[0], tile[1], -90), face(tile[0], tile[1], 180)};
+    }
+
+    // Block with side, bottom and top tiles (sides are rotated to line up around the block)
+    constexpr std::array<FaceTexture, FACE_COUNT> columnFaces(std::array<int, 2> front, std::array<int, 2> back,
+                                                              std::array<int, 2> bottom, std::array<int, 2> top,
+                                                              std::array<int, 2> left, std::array<int, 2> right) {
+        return {face(front[0], front[1], 0), face(back[0], back[1], 90), face(bottom[0], bottom[1], 0),
+                face(top[0], top[1], 0), face(left[0], left[1], 90), face(right[0], right[1], 0)};
+    }
+
+    // Tile positions in the atlas (column, row)
+    namespace Tiles {
+        constexpr std::array<int, 2> DIRT = {0, 0};
+        constexpr std::array<int, 2> GRASS_SIDE = {1, 0};
+        constexpr std::array<int, 2> GRASS = {2, 0};
+        constexpr std::array<int, 2> STONE = {3, 0};
+        constexpr std::array<int, 2> COBBLESTONE = {4, 0};
+        constexpr std::array<int, 2> PLANKS = {5, 0};
+        constexpr std::array<int, 2> LOG = {6, 0};
+        constexpr std::array<int, 2> LOG_TOP = {7, 0};
+        constexpr std::array<int, 2> LEAVES = {0, 1};
+        constexpr std::array<int, 2> CRAFTING_TABLE_FRONT = {1, 1};
+        constexpr std::array<int, 2> CRAFTING_TABLE_SIDE = {2, 1};
+        constexpr std::array<int, 2> CRAFTING_TABLE_TOP = {3, 1};
+        constexpr std::array<int, 2> FURNACE_FRONT = {4, 1};
+        constexpr std::array<int, 2> FURNACE_SIDE = {5, 1};
+        constexpr std::array<int, 2> FURNACE_TOP = {6, 1};
+        constexpr std::array<int, 2> FURNACE_FRONT_LIT = {7, 1};
+        constexpr std::array<int, 2> WATER = {0, 2};
+        constexpr std::array<int, 2> IRON_ORE = {1, 2};
+        constexpr std::array<int, 2> NONE = {7, 7};
+    }
+
+    // Properties of every block type, indexed by BlockType
+    inline constexpr std::array<BlockProperties, BLOCK_TYPE_COUNT> BLOCKS = {{
+            /* AIR */            {false, false, false, OPAQUE, 0, uniformFaces(Tiles::NONE)},
+            /* DIRT */           {true, true, true, OPAQUE, 0, uniformFaces(Tiles::DIRT)},
+            /* GRASS */          {true, true, true, OPAQUE, 0, columnFaces(Tiles::GRASS_SIDE, Tiles::GRASS_SIDE, Tiles::DIRT,
+                                                                           Tiles::GRASS, Tiles::GRASS_SIDE, Tiles::GRASS_SIDE)},
+            /* STONE */          {true, true, true, OPAQUE, 0, uniformFaces(Tiles::STONE)},
+            /* WATER */          {true, false, false, TRANSLUCENT, 0, uniformFaces(Tiles::WATER)},
+            /* PLANKS */         {true, true, true, OPAQUE, 0, uniformFaces(Tiles::PLANKS)},
+            /* LOG */            {true, true, true, OPAQUE, 0, columnFaces(Tiles::LOG, Tiles::LOG, Tiles::LOG_TOP,
+                                                                           Tiles::LOG_TOP, Tiles::LOG, Tiles::LOG)},
+            /* COBBLESTONE */    {true, true, true, OPAQUE, 0, uniformFaces(Tiles::COBBLESTONE)},
+            /* LEAVES */         {true, false, true, CUTOUT, 0, uniformFaces(Tiles::LEAVES)},
+            /* CRAFTING_TABLE */ {true, true, true, OPAQUE, 0, columnFaces(Tiles::CRAFTING_TABLE_FRONT, Tiles::CRAFTING_TABLE_FRONT,
+                                                                           Tiles::PLANKS, Tiles::CRAFTING_TABLE_TOP,
+                                                                           Tiles::CRAFTING_TABLE_SIDE, Tiles::CRAFTING_TABLE_SIDE)},
+            /* FURNACE */        {true, true, true, OPAQUE, 0, columnFaces(Tiles::FURNACE_FRONT, Tiles::FURNACE_SIDE, Tiles::FURNACE_TOP,
+                                                                           Tiles::FURNACE_TOP, Tiles::FURNACE_SIDE, Tiles::FURNACE_SIDE)},
+            /* IRON_ORE */       {true, true, true, OPAQUE, 0, uniformFaces(Tiles::IRON_ORE)},
+            /* LIT_FURNACE */    {true, true, true, OPAQUE, 13, columnFaces(Tiles::FURNACE_FRONT_LIT, Tiles::FURNACE_SIDE,
+                                                                            Tiles::FURNACE_TOP, Tiles::FURNACE_TOP,
+                                                                            Tiles::FURNACE_SIDE, Tiles::FURNACE_SIDE)},
+    }};
+
+    // Get the properties of a block type
+    constexpr const BlockProperties& get(BlockType type) {
+        return BLOCKS[static_cast<int>(type)];
+    }
+}
+
+
+#endif
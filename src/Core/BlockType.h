@@ -0,0 +1,28 @@
+#ifndef MINECRAFTCLONE_BLOCKTYPE_H
+#define MINECRAFTCLONE_BLOCKTYPE_H
+
+
+#include <cstdint>
+
+// Enum to define different block types (AIR marks an empty voxel)
+enum class BlockType : std::uint8_t {
+    AIR,
+    DIRT,
+    GRASS,
+    STONE,
+    WATER,
+    PLANKS,
+    LOG,
+    COBBLESTONE,
+    LEAVES,
+    CRAFTING_TABLE,
+    FURNACE,
+    IRON_ORE,
+    LIT_FURNACE,
+};
+
+// Number of block types, including AIR
+constexpr int BLOCK_TYPE_COUNT = static_cast<int>(BlockType::LIT_FURNACE) + 1;
+
+
+#endif
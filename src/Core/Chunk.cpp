@@ -1,13 +1,19 @@
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <utility>
 #include "Chunk.h"
 #include "../Utils/PerlinNoise.h"
+#include "../Utils/Profiler.h"
 #include "../Config.h"
 
 // Constructor for the chunk
-Chunk::Chunk(): chunkSize(Config::World::CHUNK_SIZE) {}
+Chunk::Chunk(): chunkSize(Config::World::CHUNK_SIZE), sectionRevisions{}, editRevisions{}, unsavedChanges(false) {}
 
 // Generate the chunk using Perlin noise for terrain generation
 void Chunk::generate(int xOffset, int zOffset, const PerlinNoise& noiseGenerator) {
+    PROFILE_ZONE("Chunk::generate");
+
     // Set the chunk's position in the world
     position = {xOffset, zOffset};
 
@@ -16,30 +22,29 @@ void Chunk::generate(int xOffset, int zOffset, const PerlinNoise& noiseGenerator
     const int octaves = 4;
     const float persistence = 0.5f;
 
+    // Sample each octave for the whole chunk at once, sample [z * SIZE + x] is column (x, z)
+    std::array<float, ChunkStorage::SIZE * ChunkStorage::SIZE> heightNoise{};
+    std::array<float, ChunkStorage::SIZE * ChunkStorage::SIZE> octaveNoise{};
+    float freq = frequency;
+    float amplitude = 1.0f;
+    float maxValue = 0.0f;
+
+    for (int octave = 0; octave < octaves; octave++) {
+        // Use the same world coordinates for all chunks, ensuring the seed-based noise
+        noiseGenerator.noiseGrid(xOffset, zOffset, chunkSize, chunkSize, freq, 0.5f, octaveNoise.data());
+        for (std::size_t i = 0; i < heightNoise.size(); i++) {
+            heightNoise[i] += octaveNoise[i] * amplitude;
+        }
+        maxValue += amplitude;
+        amplitude *= persistence;
+        freq *= 2.0f;
+    }
+
     // Iterate through the chunk's x and z coordinates
     for (int x = 0; x < chunkSize; x++) {
         for (int z = 0; z < chunkSize; z++) {
-            // Calculate the world coordinates for this block
-            int worldX = xOffset + x;
-            int worldZ = zOffset + z;
-
-            // Sample from the larger Perlin noise map
-            float noiseValue = 0.0f;
-            float amplitude = 1.0f;
-            float maxValue = 0.0f;
-
-            // Loop through each octave
-            for (int octave = 0; octave < octaves; octave++) {
-                float freq = frequency * std::pow(2.0f, octave);
-
-                // Use the same worldX and worldZ for all chunks, ensuring the seed-based noise
-                noiseValue += noiseGenerator.noise(worldX * freq, worldZ * freq, 0.5f) * amplitude;
-                maxValue += amplitude;
-                amplitude *= persistence;
-            }
-
             // Normalize the noise value
-            noiseValue /= maxValue;
+            float noiseValue = heightNoise[z * chunkSize + x] / maxValue;
 
             // Adjust the height scale
             float height = noiseValue * 20.0f;  // Adjust this value for terrain height
@@ -47,68 +52,86 @@ void Chunk::generate(int xOffset, int zOffset, const PerlinNoise& noiseGenerator
 
             // Fill the chunk with blocks up to the calculated height
             for (int y = 0; y < groundHeight; y++) {
-                sf::Vector3i blockPos(worldX, y, worldZ);
-
                 if (y == groundHeight - 1) {
-                    blocks[blockPos] = Block(BlockType::GRASS, blockPos);  // Topmost block is grass
+                    blocks.set(x, y, z, BlockType::GRASS);  // Topmost block is grass
                 } else if (y >= groundHeight - 4) {
-                    blocks[blockPos] = Block(BlockType::DIRT, blockPos);  // Next few layers are dirt
+                    blocks.set(x, y, z, BlockType::DIRT);  // Next few layers are dirt
                 } else {
-                    blocks[blockPos] = Block(BlockType::STONE, blockPos);  // Below that is stone
+                    blocks.set(x, y, z, BlockType::STONE);  // Below that is stone
                 }
             }
         }
     }
+
+    markChanged();
+}
+
+// Fill the chunk with blocks loaded from a save
+void Chunk::load(int xOffset, int zOffset, ChunkStorage storage) {
+    position = {xOffset, zOffset};
+    blocks = std::move(storage);
+    unsavedChanges = false;
+    markChanged();
 }
 
 // Retrieve the block at a specific position within the chunk
 const Block* Chunk::getBlockAt(const sf::Vector3i& position) const {
-    auto it = blocks.find(position);
+    BlockType type = getBlockTypeAt(position);
 
-    if (it != blocks.end()) {
-        return &it->second;
+    if (type != BlockType::AIR) {
+        return &Block::get(type);
     }
     return nullptr;  // Return null if no block is found at the given position
 }
 
+// Retrieve the block type at a specific position within the chunk
+BlockType Chunk::getBlockTypeAt(const sf::Vector3i& position) const {
+    return blocks.get(position.x - this->position.x, position.y, position.z - this->position.y);
+}
+
 // Set a block at a specific position within the chunk
 void Chunk::setBlockAt(const sf::Vector3i& position, BlockType type) {
-    blocks[position] = Block(type, position);  // Set the block to the desired type
+    blocks.set(position.x - this->position.x, position.y, position.z - this->position.y, type);  // Set the block to the desired type
+    unsavedChanges = true;
+    markBlockEdited(position.y);
 }
 
 // Remove a block at a specific position within the chunk
 void Chunk::removeBlockAt(const sf::Vector3i& position) {
-    blocks.erase(position);  // Remove the block from the chunk
+    blocks.set(position.x - this->position.x, position.y, position.z - this->position.y, BlockType::AIR);  // Replace the block with air
+    unsavedChanges = true;
+    markBlockEdited(position.y);
 }
 
-// Render the chunk
-void Chunk::render() const {
-    // Iterate through all the blocks in the chunk and render them
-    for (const auto& [position, block] : blocks) {
-        // Use the block's render function
-        block.render();
-    }
-}
-
-// Render the chunk
-void Chunk::renderNotOpaque() const {
-    // Iterate through all the blocks in the chunk and render them
-    for (const auto& [position, block] : blocks) {
-        // Use the block's render function
-        block.renderNotOpaque();
-    }
-}
-
-
 // Check if a player AABB collides with any solid blocks in the chunk
 bool Chunk::checkCollision(const Math::AABB& playerAABB) const {
-    // Iterate through all the blocks in the chunk
-    for (const auto& [position, block] : blocks) {
-        // Only check for collision if the block is solid
-        if (block.checkIfSolid()) {
-            // Check if the player's AABB collides with the block's AABB
-            if (block.getAABB().intersects(playerAABB)) {
-                return true;  // Collision detected with a solid block
+    float epsilon = 0.001f;  // Same buffer as Math::AABB::intersects
+
+    // Only the voxels overlapped by the AABB can collide, clamp them to the chunk
+    int minX = std::max(static_cast<int>(std::floor(playerAABB.min.x - epsilon)) - position.x, 0);
+    int minY = std::max(static_cast<int>(std::floor(playerAABB.min.y - epsilon)), 0);
+    int minZ = std::max(static_cast<int>(std::floor(playerAABB.min.z - epsilon)) - position.y, 0);
+    int maxX = std::min(static_cast<int>(std::floor(playerAABB.max.x + epsilon)) - position.x, chunkSize - 1);
+    int maxY = std::min(static_cast<int>(std::floor(playerAABB.max.y + epsilon)), ChunkStorage::HEIGHT - 1);
+    int maxZ = std::min(static_cast<int>(std::floor(playerAABB.max.z + epsilon)) - position.y, chunkSize - 1);
+
+    for (int y = minY; y <= maxY; y++) {
+        // Nothing in an empty section can collide, jump to the next one
+        int section = y / ChunkStorage::SECTION_HEIGHT;
+        if (blocks.isSectionEmpty(section)) {
+            y = (section + 1) * ChunkStorage::SECTION_HEIGHT - 1;
+            continue;
+        }
+
+        for (int z = minZ; z <= maxZ; z++) {
+            for (int x = minX; x <= maxX; x++) {
+                // Only check for collision if the block is solid
+                if (BlockRegistry::get(blocks.get(x, y, z)).solid) {
+                    // Check if the player's AABB collides with the block's AABB
+                    if (Block::getAABB({position.x + x, y, position.y + z}).intersects(playerAABB)) {
+                        return true;  // Collision detected with a solid block
+                    }
+                }
             }
         }
     }
@@ -124,9 +147,81 @@ Math::AABB Chunk::getAABB() const {
 
     // Calculate the chunk's size
     int width = chunkSize;
-    int height = 256;  // Set the height to the maximum world height
+    int height = ChunkStorage::HEIGHT;  // Set the height to the maximum world height
     int depth = chunkSize;
 
     // Return the chunk's AABB
     return {x, y, z, width, height, depth};
-}
\ No newline at end of file
+}
+
+// Get the block storage of the chunk
+const ChunkStorage& Chunk::getStorage() const {
+    return blocks;
+}
+
+// Get the light of the chunk
+const LightStorage& Chunk::getLight() const {
+    return light;
+}
+
+// Get the light of the chunk to update it
+LightStorage& Chunk::getLight() {
+    return light;
+}
+
+// Get the revision of a section
+std::uint32_t Chunk::getSectionRevision(int section) const {
+    return sectionRevisions[section];
+}
+
+// Get the revision a section had after its latest block edit
+std::uint32_t Chunk::getSectionEditRevision(int section) const {
+    return editRevisions[section];
+}
+
+// Get the time of the latest block edit of a section
+std::chrono::steady_clock::time_point Chunk::getSectionEditTime(int section) const {
+    return editTimes[section];
+}
+
+// Mark every section as changed
+void Chunk::markChanged() {
+    for (std::uint32_t& revision : sectionRevisions) {
+        revision++;
+    }
+}
+
+// Mark a section as changed by a block edit
+void Chunk::markSectionEdited(int section) {
+    if (section < 0 || section >= ChunkStorage::SECTION_COUNT) return;
+
+    editRevisions[section] = ++sectionRevisions[section];
+    editTimes[section] = std::chrono::steady_clock::now();
+}
+
+// Mark a section as changed without a block edit
+void Chunk::markSectionChanged(int section) {
+    if (section < 0 || section >= ChunkStorage::SECTION_COUNT) return;
+
+    sectionRevisions[section]++;
+}
+
+// Mark the sections whose mesh depends on the block at a height
+void Chunk::markBlockEdited(int y) {
+    if (y < 0 || y >= ChunkStorage::HEIGHT) return;
+
+    int section = y / ChunkStorage::SECTION_HEIGHT;
+    markSectionEdited(section);
+    if (y % ChunkStorage::SECTION_HEIGHT == 0) markSectionEdited(section - 1);
+    if (y % ChunkStorage::SECTION_HEIGHT == ChunkStorage::SECTION_HEIGHT - 1) markSectionEdited(section + 1);
+}
+
+// Check if blocks were edited since the chunk was generated, loaded or last saved
+bool Chunk::hasUnsavedChanges() const {
+    return unsavedChanges;
+}
+
+// Mark the current blocks as saved
+void Chunk::markSaved() {
+    unsavedChanges = false;
+}
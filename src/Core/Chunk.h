@@ -1,8 +1,11 @@
 #ifndef MINECRAFTCLONE_CHUNK_H
 #define MINECRAFTCLONE_CHUNK_H
 
-#include <unordered_map>
+#include <array>
+#include <chrono>
 #include "Block.h"
+#include "ChunkStorage.h"
+#include "LightStorage.h"
 #include "../Utils/Math.h"
 #include "../Utils/PerlinNoise.h"
 #include <SFML/System/Vector3.hpp>
@@ -14,9 +17,15 @@ public:
     // Generate the chunk using Perlin noise for terrain generation
     void generate(int xOffset, int zOffset, const PerlinNoise& noiseGenerator);
 
+    // Fill the chunk with blocks loaded from a save
+    void load(int xOffset, int zOffset, ChunkStorage storage);
+
     // Get the block at a specific position within the chunk
     const Block* getBlockAt(const sf::Vector3i& position) const;
 
+    // Get the block type at a specific position within the chunk (AIR if empty)
+    [[nodiscard]] BlockType getBlockTypeAt(const sf::Vector3i& position) const;
+
     // Set a block at a specific position within the chunk
     void setBlockAt(const sf::Vector3i& position, BlockType type);
 
@@ -26,21 +35,60 @@ public:
     // Check if a player AABB collides with any blocks in the chunk
     bool checkCollision(const Math::AABB& playerAABB) const;
 
-    // Render the chunk
-    void render() const;
-
-    // Render the chunk
-    void renderNotOpaque() const;
-
     // Get the chunk's AABB
     Math::AABB getAABB() const;
 
+    // Get the block storage of the chunk
+    [[nodiscard]] const ChunkStorage& getStorage() const;
+
+    // Get the light of the chunk
+    [[nodiscard]] const LightStorage& getLight() const;
+
+    // Get the light of the chunk to update it (see LightEngine)
+    LightStorage& getLight();
+
+    // Get the revision of a section, it changes whenever the section has to be meshed again
+    [[nodiscard]] std::uint32_t getSectionRevision(int section) const;
+
+    // Get the revision a section had after its latest block edit (0 if it was never edited)
+    [[nodiscard]] std::uint32_t getSectionEditRevision(int section) const;
+
+    // Get the time of the latest block edit of a section
+    [[nodiscard]] std::chrono::steady_clock::time_point getSectionEditTime(int section) const;
+
+    // Mark every section as changed (used when a neighbouring chunk arrives and the border changes)
+    void markChanged();
+
+    // Mark a section as changed by a block edit (also used for edits on the border of a neighbouring chunk)
+    void markSectionEdited(int section);
+
+    // Mark a section as changed without a block edit (its light changed)
+    void markSectionChanged(int section);
+
+    // Check if blocks were edited since the chunk was generated, loaded or last saved
+    [[nodiscard]] bool hasUnsavedChanges() const;
+
+    // Mark the current blocks as saved
+    void markSaved();
+
 private:
-    std::unordered_map<sf::Vector3i, Block> blocks;  // List of blocks in the chunk
+    ChunkStorage blocks;  // Block types of the chunk, indexed by local position
+    LightStorage light;   // Sky and block light of the chunk, indexed like the blocks
 
     int chunkSize; // Size of the chunk
 
     sf::Vector2i position;  // Position of the chunk in the world
+
+    // Per section: incremented on every change, and the revision and time of the latest block edit
+    std::array<std::uint32_t, ChunkStorage::SECTION_COUNT> sectionRevisions;
+    std::array<std::uint32_t, ChunkStorage::SECTION_COUNT> editRevisions;
+    std::array<std::chrono::steady_clock::time_point, ChunkStorage::SECTION_COUNT> editTimes;
+
+    bool unsavedChanges;    // Set by block edits, generated terrain can be generated again and is not saved
+
+    // Mark the sections whose mesh depends on the block at a height (the faces of a block on a section
+    // border belong to the mesh of the section next to it)
+    void markBlockEdited(int y);
 };
 
 #endif
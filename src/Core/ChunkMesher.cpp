@@ -0,0 +1,633 @@
+#include <algorithm>
+#include "ChunkMesher.h"
+#include "../Utils/Profiler.h"
+
+namespace {
+    // Geometry of a block face: the axis it faces along and the unit cube corners
+    // (bottom-left, bottom-right, top-right, top-left) in the same order as the face textures
+    struct FaceGeometry {
+        int axis;
+        int direction;
+        std::array<std::array<int, 3>, 4> corners;
+    };
+
+    constexpr std::array<FaceGeometry, BlockRegistry::FACE_COUNT> FACES = {{
+            {2, -1, {{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}}}},  // Front
+            {2, 1, {{{0, 0, 1}, {0, 1, 1}, {1, 1, 1}, {1, 0, 1}}}},   // Back
+            {1, -1, {{{0, 0, 0}, {0, 0, 1}, {1, 0, 1}, {1, 0, 0}}}},  // Bottom
+            {1, 1, {{{1, 1, 0}, {1, 1, 1}, {0, 1, 1}, {0, 1, 0}}}},   // Top
+            {0, -1, {{{0, 0, 0}, {0, 1, 0}, {0, 1, 1}, {0, 0, 1}}}},  // Left
+            {0, 1, {{{1, 0, 0}, {1, 0, 1}, {1, 1, 1}, {1, 1, 0}}}},   // Right
+    }};
+
+    constexpr std::array<int, 3> DIMENSIONS = {ChunkStorage::SIZE, ChunkStorage::HEIGHT, ChunkStorage::SIZE};
+
+    // Shading of the four corners of a face, 10 bits per corner in corner order: ao | sky << 2 | block << 6
+    constexpr int CORNER_BITS = 10;
+    constexpr std::uint64_t CORNER_MASK = (1u << CORNER_BITS) - 1;
+
+    // Corner of a face without occlusion in full sky light
+    constexpr std::uint64_t OPEN_CORNER = 3 | LightStorage::MAX_LEVEL << 2;
+    constexpr std::uint64_t OPEN_SHADING = OPEN_CORNER | OPEN_CORNER << CORNER_BITS | OPEN_CORNER << 2 * CORNER_BITS |
+                                           OPEN_CORNER << 3 * CORNER_BITS;
+
+    // Shade the corners of the face of the block at (x, y, z) from the 3x3 voxels in front of it: a corner is
+    // occluded by the two voxels along its edges and the one across it, and takes the average light of the
+    // open ones (the voxel across is hidden when both edges are closed)
+    std::uint64_t shadeFace(const ChunkMesher::Volume& volume, int x, int y, int z, int face) {
+        const FaceGeometry& geometry = FACES[face];
+        int axisA = (geometry.axis + 1) % 3;
+        int axisB = (geometry.axis + 2) % 3;
+
+        std::array<int, 3> front = {x, y, z};
+        front[geometry.axis] += geometry.direction;
+
+        std::array<BlockType, 9> types{};
+        std::array<std::uint8_t, 9> light{};
+        volume.sample(front[0], front[1], front[2], geometry.axis, types, light);
+
+        std::array<bool, 9> opaque{};
+        for (int i = 0; i < 9; i++) opaque[i] = BlockRegistry::get(types[i]).opaque;
+
+        std::uint64_t shading = 0;
+        for (int corner = 0; corner < 4; corner++) {
+            int i = geometry.corners[corner][axisA] ? 1 : -1;
+            int j = geometry.corners[corner][axisB] ? 1 : -1;
+            int side1 = 4 + i, side2 = 4 + j * 3, across = 4 + i + j * 3;
+
+            bool closed = opaque[side1] && opaque[side2];
+            int ao = closed ? 0 : 3 - (opaque[side1] + opaque[side2] + opaque[across]);
+
+            int sky = light[4] >> 4, block = light[4] & 0x0F, count = 1;
+            for (int sample : {side1, side2, across}) {
+                if (opaque[sample] || (sample == across && closed)) continue;
+                sky += light[sample] >> 4;
+                block += light[sample] & 0x0F;
+                count++;
+            }
+            sky = (sky + count / 2) / count;
+            block = (block + count / 2) / count;
+
+            shading |= static_cast<std::uint64_t>(ao | sky << 2 | block << 6) << (corner * CORNER_BITS);
+        }
+        return shading;
+    }
+
+    // Faces are merged when they share a layer, an atlas tile and a rotation, packed into one key (0 = no face)
+    int faceKey(const BlockRegistry::BlockProperties& properties, int face) {
+        const BlockRegistry::FaceTexture& texture = properties.faces[face];
+        int shift = (((texture.rotation / 90) % 4) + 4) % 4;
+        return 1 + ((properties.layer * 256 + texture.tile) * 4 + shift);
+    }
+
+    // Append a merged quad covering [min, max) to its layer, with the shading of its corners
+    void emitQuad(ChunkMeshData& mesh, int face, int key, std::uint64_t shading, const std::array<int, 3>& min,
+                  const std::array<int, 3>& max) {
+        const FaceGeometry& geometry = FACES[face];
+
+        int packed = key - 1;
+        int shift = packed % 4;
+        int tile = (packed / 4) % 256;
+        int layer = packed / 4 / 256;
+
+        // Size of the quad along the texture's right (bottom-left -> bottom-right) and up (bottom-left -> top-left) axes
+        int width = 0, height = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            if (geometry.corners[1][axis] != geometry.corners[0][axis]) width = max[axis] - min[axis];
+            if (geometry.corners[3][axis] != geometry.corners[0][axis]) height = max[axis] - min[axis];
+        }
+
+        // Texture coordinates in block units; a rotated texture spans the quad the other way around
+        int u = shift % 2 == 0 ? width : height;
+        int v = shift % 2 == 0 ? height : width;
+        const std::array<std::array<int, 2>, 4> texCoords = {{{0, v}, {u, v}, {u, 0}, {0, 0}}};
+
+        MeshData& data = mesh.layers[layer];
+        auto base = static_cast<MeshData::Index>(data.vertices.size());
+
+        std::array<int, 4> brightness{};
+        for (int corner = 0; corner < 4; corner++) {
+            const std::array<int, 3>& unit = geometry.corners[corner];
+            const std::array<int, 2>& texCoord = texCoords[(corner + shift) % 4];
+            auto shade = static_cast<int>((shading >> (corner * CORNER_BITS)) & CORNER_MASK);
+            int ao = shade & 3, sky = (shade >> 2) & 0x0F, block = shade >> 6;
+            brightness[corner] = ao * 64 + sky + block;
+
+            data.vertices.push_back(ChunkVertex::pack(unit[0] ? max[0] : min[0], unit[1] ? max[1] : min[1],
+                                                      unit[2] ? max[2] : min[2], face, tile, texCoord[0], texCoord[1],
+                                                      ao, sky, block));
+        }
+
+        // Two triangles with the same winding as the block faces. The shading is interpolated along the diagonal
+        // they share, which is turned to join the brighter pair of corners: a single dark corner then fades
+        // over its own triangle instead of stretching into a dark band across the quad
+        bool flip = brightness[0] + brightness[2] < brightness[1] + brightness[3];
+        for (int index : {0, 1, 2, 2, 3, 0}) {
+            data.indices.push_back(static_cast<MeshData::Index>(base + (flip ? (index + 1) % 4 : index)));
+        }
+
+        mesh.quads++;
+    }
+
+    // Greedy mesh the cells of a grid in [origin, origin + dimensions). get(x, y, z) returns the block type of a
+    // cell, it is also called on the cells just outside the range, and shade(x, y, z, face) the shading of the
+    // corners of a visible face. A cell is scale blocks wide, positions and texture coordinates of the quads are in blocks.
+    template<typename Get, typename Shade>
+    void meshGrid(ChunkMeshData& mesh, Get&& get, Shade&& shade, const std::array<int, 3>& origin,
+                  const std::array<int, 3>& dimensions, int scale) {
+        // Merge key of every face of a slice in the low 16 bits and its shading above (0 = no face)
+        std::vector<std::uint64_t> mask;
+
+        for (int face = 0; face < BlockRegistry::FACE_COUNT; face++) {
+            const FaceGeometry& geometry = FACES[face];
+
+            // Sweep slices along the face axis; a and b are the two axes of the slice
+            int axis = geometry.axis;
+            int axisA = (axis + 1) % 3;
+            int axisB = (axis + 2) % 3;
+            int sizeA = dimensions[axisA];
+            int sizeB = dimensions[axisB];
+
+            mask.assign(sizeA * sizeB, 0);
+
+            for (int slice = origin[axis]; slice < origin[axis] + dimensions[axis]; slice++) {
+                // Mark every visible face in the slice with its merge key
+                for (int b = 0; b < sizeB; b++) {
+                    for (int a = 0; a < sizeA; a++) {
+                        std::array<int, 3> position{};
+                        position[axis] = slice;
+                        position[axisA] = origin[axisA] + a;
+                        position[axisB] = origin[axisB] + b;
+
+                        std::uint64_t key = 0;
+                        BlockType type = get(position[0], position[1], position[2]);
+
+                        if (type != BlockType::AIR) {
+                            BlockType neighbour = get(position[0] + (axis == 0 ? geometry.direction : 0),
+                                                      position[1] + (axis == 1 ? geometry.direction : 0),
+                                                      position[2] + (axis == 2 ? geometry.direction : 0));
+
+                            // A face is hidden by opaque neighbours and by neighbours of the same type (water next to water)
+                            if (!BlockRegistry::get(neighbour).opaque && neighbour != type) {
+                                key = static_cast<std::uint64_t>(faceKey(BlockRegistry::get(type), face)) |
+                                      shade(position[0], position[1], position[2], face) << 16;
+                                mesh.visibleFaces++;
+                            }
+                        }
+
+                        mask[b * sizeA + a] = key;
+                    }
+                }
+
+                // Greedily grow rectangles of equal keys, first along a then along b
+                for (int b = 0; b < sizeB; b++) {
+                    for (int a = 0; a < sizeA; ) {
+                        std::uint64_t key = mask[b * sizeA + a];
+                        if (key == 0) {
+                            a++;
+                            continue;
+                        }
+
+                        int width = 1;
+                        while (a + width < sizeA && mask[b * sizeA + a + width] == key) width++;
+
+                        int height = 1;
+                        for (bool grow = true; grow && b + height < sizeB; ) {
+                            for (int i = 0; i < width; i++) {
+                                if (mask[(b + height) * sizeA + a + i] != key) {
+                                    grow = false;
+                                    break;
+                                }
+                            }
+                            if (grow) height++;
+                        }
+
+                        std::array<int, 3> min{}, max{};
+                        min[axis] = slice * scale;
+                        max[axis] = (slice + 1) * scale;
+                        min[axisA] = (origin[axisA] + a) * scale;
+                        max[axisA] = (origin[axisA] + a + width) * scale;
+                        min[axisB] = (origin[axisB] + b) * scale;
+                        max[axisB] = (origin[axisB] + b + height) * scale;
+                        emitQuad(mesh, face, static_cast<int>(key & 0xFFFF), key >> 16, min, max);
+
+                        // Clear the merged faces
+                        for (int j = 0; j < height; j++) {
+                            for (int i = 0; i < width; i++) {
+                                mask[(b + j) * sizeA + a + i] = 0;
+                            }
+                        }
+                        a += width;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Pack the attributes of a vertex
+ChunkVertex ChunkVertex::pack(int x, int y, int z, int face, int tile, int u, int v, int ao, int sky, int block) {
+    ChunkVertex vertex{};
+    vertex.position = static_cast<std::uint32_t>(x) |
+                      static_cast<std::uint32_t>(y) << POSITION_BITS |
+                      static_cast<std::uint32_t>(z) << (POSITION_BITS + HEIGHT_BITS) |
+                      static_cast<std::uint32_t>(face) << (2 * POSITION_BITS + HEIGHT_BITS) |
+                      static_cast<std::uint32_t>(tile) << (2 * POSITION_BITS + HEIGHT_BITS + FACE_BITS);
+    vertex.texture = static_cast<std::uint32_t>(u) |
+                     static_cast<std::uint32_t>(v) << TEXCOORD_BITS |
+                     static_cast<std::uint32_t>(ao) << (2 * TEXCOORD_BITS) |
+                     static_cast<std::uint32_t>(sky) << (2 * TEXCOORD_BITS + AO_BITS) |
+                     static_cast<std::uint32_t>(block) << (2 * TEXCOORD_BITS + AO_BITS + LIGHT_BITS);
+    return vertex;
+}
+
+int ChunkVertex::x() const {
+    return static_cast<int>(position & ((1u << POSITION_BITS) - 1));
+}
+
+int ChunkVertex::y() const {
+    return static_cast<int>((position >> POSITION_BITS) & ((1u << HEIGHT_BITS) - 1));
+}
+
+int ChunkVertex::z() const {
+    return static_cast<int>((position >> (POSITION_BITS + HEIGHT_BITS)) & ((1u << POSITION_BITS) - 1));
+}
+
+int ChunkVertex::face() const {
+    return static_cast<int>((position >> (2 * POSITION_BITS + HEIGHT_BITS)) & ((1u << FACE_BITS) - 1));
+}
+
+int ChunkVertex::tile() const {
+    return static_cast<int>((position >> (2 * POSITION_BITS + HEIGHT_BITS + FACE_BITS)) & ((1u << TILE_BITS) - 1));
+}
+
+int ChunkVertex::u() const {
+    return static_cast<int>(texture & ((1u << TEXCOORD_BITS) - 1));
+}
+
+int ChunkVertex::v() const {
+    return static_cast<int>((texture >> TEXCOORD_BITS) & ((1u << TEXCOORD_BITS) - 1));
+}
+
+int ChunkVertex::ao() const {
+    return static_cast<int>((texture >> (2 * TEXCOORD_BITS)) & ((1u << AO_BITS) - 1));
+}
+
+int ChunkVertex::sky() const {
+    return static_cast<int>((texture >> (2 * TEXCOORD_BITS + AO_BITS)) & ((1u << LIGHT_BITS) - 1));
+}
+
+int ChunkVertex::block() const {
+    return static_cast<int>((texture >> (2 * TEXCOORD_BITS + AO_BITS + LIGHT_BITS)) & ((1u << LIGHT_BITS) - 1));
+}
+
+std::size_t ChunkMeshData::vertexCount() const {
+    std::size_t count = 0;
+    for (const MeshData& layer : layers) {
+        count += layer.vertices.size();
+    }
+    return count;
+}
+
+ChunkMesher::Volume::Volume() : Volume(0, HEIGHT) {}
+
+ChunkMesher::Volume::Volume(int minY, int maxY)
+        : minY(std::max(minY, 0)), maxY(std::min(maxY, HEIGHT)), blockMinY(this->minY), blockMaxY(this->maxY),
+          blocks((SIZE + 2) * std::max(this->maxY - this->minY, 0) * (SIZE + 2), BlockType::AIR),
+          light(blocks.size(), LightStorage::pack(LightStorage::MAX_LEVEL, 0)) {}
+
+BlockType ChunkMesher::Volume::get(int x, int y, int z) const {
+    if (y < minY || y >= maxY) return BlockType::AIR;
+    return blocks[index(x, y, z)];
+}
+
+void ChunkMesher::Volume::set(int x, int y, int z, BlockType type) {
+    blocks[index(x, y, z)] = type;
+}
+
+std::uint8_t ChunkMesher::Volume::getLight(int x, int y, int z) const {
+    if (y < minY || y >= maxY) return LightStorage::pack(LightStorage::MAX_LEVEL, 0);
+    return light[index(x, y, z)];
+}
+
+void ChunkMesher::Volume::setLight(int x, int y, int z, std::uint8_t value) {
+    light[index(x, y, z)] = value;
+}
+
+void ChunkMesher::Volume::sample(int x, int y, int z, int axis, std::array<BlockType, 9>& types,
+                                 std::array<std::uint8_t, 9>& light) const {
+    const std::array<int, 3> strides = {1, (SIZE + 2) * (SIZE + 2), SIZE + 2};
+    int axisA = (axis + 1) % 3, axisB = (axis + 2) % 3;
+
+    // Heights outside the volume only happen on its top and bottom layers, they go through get
+    int lowY = axis == 1 ? y : y - 1, highY = axis == 1 ? y : y + 1;
+    if (lowY < minY || highY >= maxY) {
+        for (int j = -1; j <= 1; j++) {
+            for (int i = -1; i <= 1; i++) {
+                std::array<int, 3> position = {x, y, z};
+                position[axisA] += i;
+                position[axisB] += j;
+                types[(j + 1) * 3 + i + 1] = get(position[0], position[1], position[2]);
+                light[(j + 1) * 3 + i + 1] = getLight(position[0], position[1], position[2]);
+            }
+        }
+        return;
+    }
+
+    int center = index(x, y, z);
+    for (int j = -1; j <= 1; j++) {
+        for (int i = -1; i <= 1; i++) {
+            int voxel = center + i * strides[axisA] + j * strides[axisB];
+            types[(j + 1) * 3 + i + 1] = blocks[voxel];
+            light[(j + 1) * 3 + i + 1] = this->light[voxel];
+        }
+    }
+}
+
+void ChunkMesher::Volume::setBlockRange(int minY, int maxY) {
+    blockMinY = std::max(minY, this->minY);
+    blockMaxY = std::min(maxY, this->maxY);
+}
+
+int ChunkMesher::Volume::getBlockMinY() const {
+    return blockMinY;
+}
+
+int ChunkMesher::Volume::getBlockMaxY() const {
+    return blockMaxY;
+}
+
+int ChunkMesher::Volume::index(int x, int y, int z) const {
+    return ((y - minY) * (SIZE + 2) + (z + 1)) * (SIZE + 2) + (x + 1);
+}
+
+// Copy a chunk and the border of its neighbours into a volume
+ChunkMesher::Volume ChunkMesher::gather(const ChunkStorage& chunk, const Neighbours& neighbours, const Light& light) {
+    return gatherRange(chunk, neighbours, light, 0, ChunkStorage::HEIGHT);
+}
+
+// Copy the blocks needed to mesh one section
+ChunkMesher::Volume ChunkMesher::gather(const ChunkStorage& chunk, const Neighbours& neighbours, int section, int lod,
+                                        const Light& light) {
+    int minY = section * ChunkStorage::SECTION_HEIGHT;
+    int cell = 1 << lod;
+    return gatherRange(chunk, neighbours, lod > 0 ? Light{} : light, minY - cell, minY + ChunkStorage::SECTION_HEIGHT + cell);
+}
+
+// Get the level of detail of a chunk at a distance in chunks from the player
+int ChunkMesher::lodForDistance(int distance) {
+    return lodForDistance(distance, LodRings{});
+}
+
+// Get the level of detail of a chunk at a distance in chunks from the player within rings
+int ChunkMesher::lodForDistance(int distance, const LodRings& rings) {
+    for (int lod = LOD_COUNT - 1; lod > 0; lod--) {
+        if (distance >= rings.start[lod]) return lod;
+    }
+    return 0;
+}
+
+// Estimate the vertices of the meshes of every chunk the rings draw
+double ChunkMesher::estimateVertices(const LodRings& rings) {
+    // The ring at distance d holds 8d chunks (1 for the player's chunk)
+    double vertices = 0.0;
+    for (int ring = 0; ring <= rings.drawDistance; ring++) {
+        vertices += (ring == 0 ? 1 : 8 * ring) * Config::World::LOD_CHUNK_VERTICES[lodForDistance(ring, rings)];
+    }
+    return vertices;
+}
+
+// Choose the rings for a render distance within a vertex budget
+ChunkMesher::LodRings ChunkMesher::lodRingsFor(int renderDistance, std::size_t vertexBudget) {
+    const LodRings configured;
+    const auto budget = static_cast<double>(vertexBudget);
+
+    // Scale the configured rings down together, so each level keeps its share of the view. The player's chunk
+    // and at least one ring around it are always drawn, even over the budget.
+    LodRings rings;
+    for (rings.drawDistance = renderDistance; rings.drawDistance >= 1; rings.drawDistance--) {
+        for (int first = configured.start[1]; first >= 1; first--) {
+            for (int lod = 1; lod < LOD_COUNT; lod++) rings.start[lod] = configured.start[lod] * first / configured.start[1];
+            if (estimateVertices(rings) <= budget) return rings;
+        }
+    }
+    rings.drawDistance = 1;
+    return rings;
+}
+
+// Copy the heights [minY, maxY) of a chunk and the border of its neighbours into a volume
+ChunkMesher::Volume ChunkMesher::gatherRange(const ChunkStorage& chunk, const Neighbours& neighbours, const Light& light,
+                                             int minY, int maxY) {
+    PROFILE_ZONE("ChunkMesher::gather");
+    const int size = ChunkStorage::SIZE;
+    const int sectionHeight = ChunkStorage::SECTION_HEIGHT;
+    Volume volume(minY, maxY);
+
+    // Heights of an empty section hold no faces: their blocks are air and the border is only read by them
+    int blockMinY = ChunkStorage::HEIGHT, blockMaxY = 0;
+    for (int y = std::max(minY, 0); y < std::min(maxY, ChunkStorage::HEIGHT); y++) {
+        if (chunk.isSectionEmpty(y / sectionHeight)) {
+            y = (y / sectionHeight + 1) * sectionHeight - 1;
+            continue;
+        }
+        blockMinY = std::min(blockMinY, y);
+        blockMaxY = y + 1;
+
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                volume.set(x, y, z, chunk.get(x, y, z));
+            }
+        }
+    }
+    volume.setBlockRange(blockMinY, blockMaxY);
+
+    // The faces also read the layers right above and below the blocks for their shading
+    for (int y = std::max({minY, blockMinY - 1, 0}); y < std::min({maxY, blockMaxY + 1, ChunkStorage::HEIGHT}); y++) {
+        // One block wide border from each neighbour (missing neighbours stay air)
+        for (int i = 0; i < size; i++) {
+            if (neighbours[0]) volume.set(-1, y, i, neighbours[0]->get(size - 1, y, i));
+            if (neighbours[1]) volume.set(size, y, i, neighbours[1]->get(0, y, i));
+            if (neighbours[2]) volume.set(i, y, -1, neighbours[2]->get(i, y, size - 1));
+            if (neighbours[3]) volume.set(i, y, size, neighbours[3]->get(i, y, 0));
+        }
+
+        if (light.chunk) {
+            for (int z = 0; z < size; z++) {
+                for (int x = 0; x < size; x++) {
+                    volume.setLight(x, y, z, light.chunk->get(x, y, z));
+                }
+            }
+        }
+        for (int i = 0; i < size; i++) {
+            if (light.neighbours[0]) volume.setLight(-1, y, i, light.neighbours[0]->get(size - 1, y, i));
+            if (light.neighbours[1]) volume.setLight(size, y, i, light.neighbours[1]->get(0, y, i));
+            if (light.neighbours[2]) volume.setLight(i, y, -1, light.neighbours[2]->get(i, y, size - 1));
+            if (light.neighbours[3]) volume.setLight(i, y, size, light.neighbours[3]->get(i, y, 0));
+        }
+
+        // The corners of the border belong to the diagonal chunks, which are not gathered: they are open and lit
+        // like the border next to them
+        if (light.neighbours[0]) {
+            volume.setLight(-1, y, -1, volume.getLight(-1, y, 0));
+            volume.setLight(-1, y, size, volume.getLight(-1, y, size - 1));
+        }
+        if (light.neighbours[1]) {
+            volume.setLight(size, y, -1, volume.getLight(size, y, 0));
+            volume.setLight(size, y, size, volume.getLight(size, y, size - 1));
+        }
+    }
+    return volume;
+}
+
+// Build the mesh of a volume
+ChunkMeshData ChunkMesher::build(const Volume& volume) {
+    PROFILE_ZONE("ChunkMesher::build");
+    return buildRange(volume, 0, ChunkStorage::HEIGHT);
+}
+
+// Build the mesh of one section of a volume and its visibility
+ChunkMeshData ChunkMesher::build(const Volume& volume, int section, int lod) {
+    PROFILE_ZONE("ChunkMesher::build");
+    int minY = section * ChunkStorage::SECTION_HEIGHT;
+    ChunkMeshData mesh = lod > 0 ? buildLod(volume, section, lod) : buildRange(volume, minY, minY + ChunkStorage::SECTION_HEIGHT);
+    mesh.visibility = buildVisibility(volume, section);
+    return mesh;
+}
+
+// Flood fill the non-opaque blocks of a section to find which of its faces see each other
+VisibilityGraph::SectionVisibility ChunkMesher::buildVisibility(const Volume& volume, int section) {
+    const int size = ChunkStorage::SIZE;
+    const int height = ChunkStorage::SECTION_HEIGHT;
+    const int minY = section * height;
+
+    // Blocks light and sight can pass through, in section order ((y * size + z) * size + x)
+    std::array<bool, ChunkStorage::SECTION_VOLUME> open{};
+    int openCount = 0;
+    for (int y = 0; y < height; y++) {
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) {
+                bool isOpen = !BlockRegistry::get(volume.get(x, minY + y, z)).opaque;
+                open[(y * size + z) * size + x] = isOpen;
+                openCount += isOpen;
+            }
+        }
+    }
+
+    VisibilityGraph::SectionVisibility visibility;
+    if (openCount == 0) return visibility;
+    if (openCount == ChunkStorage::SECTION_VOLUME) return VisibilityGraph::SectionVisibility::all();
+
+    // Every group of connected open blocks connects all the faces it touches
+    std::array<bool, ChunkStorage::SECTION_VOLUME> visited{};
+    std::vector<int> stack;
+    for (int start = 0; start < ChunkStorage::SECTION_VOLUME; start++) {
+        if (!open[start] || visited[start]) continue;
+
+        int faces = 0;
+        visited[start] = true;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+
+            int x = index % size;
+            int z = index / size % size;
+            int y = index / (size * size);
+            const std::array<int, BlockRegistry::FACE_COUNT> neighbours = {
+                    z > 0 ? index - size : -1, z < size - 1 ? index + size : -1,
+                    y > 0 ? index - size * size : -1, y < height - 1 ? index + size * size : -1,
+                    x > 0 ? index - 1 : -1, x < size - 1 ? index + 1 : -1
+            };
+
+            // A step out of the section goes through the face in the same direction
+            for (int face = 0; face < BlockRegistry::FACE_COUNT; face++) {
+                int neighbour = neighbours[face];
+                if (neighbour < 0) {
+                    faces |= 1 << face;
+                } else if (open[neighbour] && !visited[neighbour]) {
+                    visited[neighbour] = true;
+                    stack.push_back(neighbour);
+                }
+            }
+        }
+
+        for (int a = 0; a < BlockRegistry::FACE_COUNT; a++) {
+            for (int b = a + 1; b < BlockRegistry::FACE_COUNT; b++) {
+                if ((faces & (1 << a)) && (faces & (1 << b))) visibility.connect(a, b);
+            }
+        }
+    }
+    return visibility;
+}
+
+// Build the mesh of the blocks at heights [minY, maxY). Faces are not merged across minY or maxY.
+ChunkMeshData ChunkMesher::buildRange(const Volume& volume, int minY, int maxY) {
+    ChunkMeshData mesh;
+
+    // Only blocks of the chunk make faces, the air around them is skipped
+    minY = std::max(minY, volume.getBlockMinY());
+    maxY = std::min(maxY, volume.getBlockMaxY());
+    if (minY >= maxY) return mesh;
+
+    const std::array<int, 3> origin = {0, minY, 0};
+    const std::array<int, 3> dimensions = {DIMENSIONS[0], maxY - minY, DIMENSIONS[2]};
+    auto get = [&](int x, int y, int z) { return volume.get(x, y, z); };
+    auto shade = [&](int x, int y, int z, int face) { return shadeFace(volume, x, y, z, face); };
+    meshGrid(mesh, get, shade, origin, dimensions, 1);
+    return mesh;
+}
+
+// Build the mesh of one section with cells of 2^lod blocks
+ChunkMeshData ChunkMesher::buildLod(const Volume& volume, int section, int lod) {
+    ChunkMeshData mesh;
+    const int cell = 1 << lod;
+    const int cellVolume = cell * cell * cell;
+    const int size = ChunkStorage::SIZE / cell;
+    const int height = ChunkStorage::SECTION_HEIGHT / cell;
+    const int minY = section * ChunkStorage::SECTION_HEIGHT;
+
+    if (volume.getBlockMinY() >= minY + ChunkStorage::SECTION_HEIGHT || volume.getBlockMaxY() <= minY) return mesh;
+
+    // Cells of the section and one layer of cells above and below it. A cell is filled when at least half of
+    // its blocks are, with the most common type of its highest layer of blocks so the surface keeps its look.
+    std::vector<BlockType> cells(size * (height + 2) * size, BlockType::AIR);
+    std::array<int, BLOCK_TYPE_COUNT> counts{};
+    for (int j = -1; j <= height; j++) {
+        for (int k = 0; k < size; k++) {
+            for (int i = 0; i < size; i++) {
+                int filled = 0;
+                BlockType surface = BlockType::AIR;
+                for (int dy = cell - 1; dy >= 0; dy--) {
+                    counts.fill(0);
+                    int layerFilled = 0;
+                    for (int dz = 0; dz < cell; dz++) {
+                        for (int dx = 0; dx < cell; dx++) {
+                            BlockType type = volume.get(i * cell + dx, minY + j * cell + dy, k * cell + dz);
+                            if (type != BlockType::AIR) {
+                                counts[static_cast<int>(type)]++;
+                                layerFilled++;
+                            }
+                        }
+                    }
+
+                    filled += layerFilled;
+                    if (surface == BlockType::AIR && layerFilled > 0) {
+                        surface = static_cast<BlockType>(std::max_element(counts.begin(), counts.end()) - counts.begin());
+                    }
+                }
+
+                if (filled * 2 >= cellVolume) cells[((j + 1) * size + k) * size + i] = surface;
+            }
+        }
+    }
+
+    // Cells beside the chunk are air, so its sides are always closed
+    auto get = [&](int x, int y, int z) {
+        int j = y - minY / cell;
+        if (x < 0 || x >= size || z < 0 || z >= size || j < -1 || j > height) return BlockType::AIR;
+        return cells[((j + 1) * size + z) * size + x];
+    };
+    auto shade = [](int, int, int, int) { return OPEN_SHADING; };
+    meshGrid(mesh, get, shade, {0, minY / cell, 0}, {size, height, size}, cell);
+    return mesh;
+}
@@ -0,0 +1,179 @@
+#ifndef MINECRAFTCLONE_CHUNKMESHER_H
+#define MINECRAFTCLONE_CHUNKMESHER_H
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BlockRegistry.h"
+#include "ChunkStorage.h"
+#include "LightStorage.h"
+#include "VisibilityGraph.h"
+#include "../Config.h"
+
+// Vertex of a chunk mesh packed into 64 bits, unpacked by the chunk vertex shader of WorldRenderer.
+// Positions are local to the chunk, texture coordinates are in block units (they repeat across merged
+// faces, up to a whole column), face is the BlockRegistry::Face the quad looks along and tile is its atlas tile.
+// ao is the ambient occlusion of the corner (0 = fully occluded, 3 = open) and sky and block its smooth light.
+struct ChunkVertex {
+    static constexpr int POSITION_BITS = 5;   // x and z, 0..SIZE
+    static constexpr int HEIGHT_BITS = 9;     // y, 0..HEIGHT
+    static constexpr int FACE_BITS = 3;
+    static constexpr int TILE_BITS = 8;
+    static constexpr int TEXCOORD_BITS = 9;   // u and v, 0..HEIGHT
+    static constexpr int AO_BITS = 2;
+    static constexpr int LIGHT_BITS = 4;      // sky and block light, 0..15
+
+    std::uint32_t position;  // x | y << 5 | z << 14 | face << 19 | tile << 22
+    std::uint32_t texture;   // u | v << 9 | ao << 18 | sky << 20 | block << 24 (the upper 4 bits are free)
+
+    // Pack the attributes of a vertex (each must fit its bits)
+    static ChunkVertex pack(int x, int y, int z, int face, int tile, int u, int v, int ao, int sky, int block);
+
+    [[nodiscard]] int x() const;
+    [[nodiscard]] int y() const;
+    [[nodiscard]] int z() const;
+    [[nodiscard]] int face() const;
+    [[nodiscard]] int tile() const;
+    [[nodiscard]] int u() const;
+    [[nodiscard]] int v() const;
+    [[nodiscard]] int ao() const;
+    [[nodiscard]] int sky() const;
+    [[nodiscard]] int block() const;
+};
+
+// Vertices and triangle indices of one render layer. Indices are 16 bits: they start from 0 in every layer and
+// are drawn with the base vertex of the layer, and a section layer has at most 49152 vertices (every other
+// block of 16x16x16 showing 6 faces).
+struct MeshData {
+    using Index = std::uint16_t;
+
+    std::vector<ChunkVertex> vertices;
+    std::vector<Index> indices;
+};
+
+// Mesh of a whole chunk, one MeshData per render layer
+struct ChunkMeshData {
+    std::array<MeshData, BlockRegistry::LAYER_COUNT> layers;
+
+    int visibleFaces = 0;   // Block faces that survived culling
+    int quads = 0;          // Quads emitted after greedy merging
+
+    // Faces of the section that see each other (only filled in for section meshes, see VisibilityGraph)
+    VisibilityGraph::SectionVisibility visibility = VisibilityGraph::SectionVisibility::all();
+
+    [[nodiscard]] std::size_t vertexCount() const;
+};
+
+// Builds chunk meshes on the CPU: faces hidden by a neighbouring block are culled and
+// coplanar faces with the same texture are merged into larger quads (greedy meshing).
+// Every corner of a face gets ambient occlusion from the three voxels touching it in front of the face and
+// smooth light averaged over the open ones; faces only merge when their corners are shaded the same.
+// No GL calls are made here, uploading the result is up to the renderer.
+class ChunkMesher {
+public:
+    // Block types and light of a chunk plus a one block border taken from the neighbouring chunks. A volume
+    // can cover only a range of heights (a section and the layers above and below it). Light that was not
+    // gathered is full sky light.
+    class Volume {
+    public:
+        static constexpr int SIZE = ChunkStorage::SIZE;
+        static constexpr int HEIGHT = ChunkStorage::HEIGHT;
+
+        // Volume covering the whole height of the chunk
+        Volume();
+
+        // Volume covering the heights [minY, maxY), clamped to the chunk
+        Volume(int minY, int maxY);
+
+        // Get the block type at local coordinates (x and z may be -1 or SIZE for the border, AIR outside)
+        [[nodiscard]] BlockType get(int x, int y, int z) const;
+
+        // Set the block type at local coordinates
+        void set(int x, int y, int z, BlockType type);
+
+        // Get the packed light at local coordinates (see LightStorage, full sky light outside)
+        [[nodiscard]] std::uint8_t getLight(int x, int y, int z) const;
+
+        // Set the packed light at local coordinates
+        void setLight(int x, int y, int z, std::uint8_t value);
+
+        // Get the block types and light of the 3x3 voxels centered on local coordinates across the two axes
+        // after axis, in the order [(j + 1) * 3 + i + 1] for offsets i and j along them
+        void sample(int x, int y, int z, int axis, std::array<BlockType, 9>& types, std::array<std::uint8_t, 9>& light) const;
+
+        // Narrow the heights that may hold blocks of the chunk itself (the rest of it is air and is not meshed)
+        void setBlockRange(int minY, int maxY);
+
+        [[nodiscard]] int getBlockMinY() const;
+        [[nodiscard]] int getBlockMaxY() const;
+
+    private:
+        int minY, maxY;
+        int blockMinY, blockMaxY;  // Heights holding blocks of the chunk, the whole volume unless narrowed
+        std::vector<BlockType> blocks;
+        std::vector<std::uint8_t> light;
+
+        [[nodiscard]] int index(int x, int y, int z) const;
+    };
+
+    // Neighbouring chunks in the order -X, +X, -Z, +Z (nullptr if not generated)
+    using Neighbours = std::array<const ChunkStorage*, 4>;
+
+    // Light of a chunk and of its neighbours in the order of Neighbours (nullptr: full sky light)
+    struct Light {
+        const LightStorage* chunk;
+        std::array<const LightStorage*, 4> neighbours;
+    };
+
+    // Levels of detail: level n meshes cells of 2^n x 2^n x 2^n blocks, each drawn as one block
+    static constexpr int LOD_COUNT = 3;
+
+    // Rings of distance (in chunks, from the player's chunk) the levels of detail are drawn in
+    struct LodRings {
+        std::array<int, LOD_COUNT> start = {0, Config::World::LOD1_DISTANCE, Config::World::LOD2_DISTANCE};  // First ring of each level
+        int drawDistance = Config::World::RENDER_DISTANCE;  // Last ring drawn
+    };
+
+    // Get the level of detail of a chunk at a distance in chunks from the player (the rings of Config::World)
+    static int lodForDistance(int distance);
+
+    // Get the level of detail of a chunk at a distance in chunks from the player within rings
+    static int lodForDistance(int distance, const LodRings& rings);
+
+    // Estimate the vertices of the meshes of every chunk the rings draw (Config::World::LOD_CHUNK_VERTICES per chunk)
+    static double estimateVertices(const LodRings& rings);
+
+    // Choose the rings for a render distance within a vertex budget: the rings of Config::World, moved closer
+    // together until the estimate fits, and the draw distance lowered if even the closest rings do not fit
+    static LodRings lodRingsFor(int renderDistance, std::size_t vertexBudget);
+
+    // Copy a chunk and the border of its neighbours into a volume (empty sections are skipped)
+    static Volume gather(const ChunkStorage& chunk, const Neighbours& neighbours, const Light& light = Light{});
+
+    // Copy the blocks needed to mesh one section: the section, the cells above and below it and the border.
+    // Light is only gathered at level 0, the other levels are drawn in full sky light without occlusion.
+    static Volume gather(const ChunkStorage& chunk, const Neighbours& neighbours, int section, int lod = 0,
+                         const Light& light = Light{});
+
+    // Build the mesh of a whole volume in one piece, to compare with the section meshes (its layers must stay
+    // within the 65536 vertices 16-bit indices address, terrain is far below)
+    static ChunkMeshData build(const Volume& volume);
+
+    // Build the mesh of one section of a volume (positions are still local to the chunk) and its visibility.
+    // Above level 0 the sides of the chunk are always closed with faces: neighbours at another level do not
+    // line up with the cells, so this keeps the seams between levels free of cracks.
+    static ChunkMeshData build(const Volume& volume, int section, int lod = 0);
+
+    // Flood fill the non-opaque blocks of a section to find which of its faces see each other
+    static VisibilityGraph::SectionVisibility buildVisibility(const Volume& volume, int section);
+
+private:
+    static Volume gatherRange(const ChunkStorage& chunk, const Neighbours& neighbours, const Light& light, int minY, int maxY);
+    static ChunkMeshData buildRange(const Volume& volume, int minY, int maxY);
+    static ChunkMeshData buildLod(const Volume& volume, int section, int lod);
+};
+
+
+#endif
@@ -0,0 +1,296 @@
+#include <utility>
+#include "ChunkStorage.h"
+
+namespace {
+    // Word read by uniform sections: with 0 bits per entry every voxel reads palette index 0 from it
+    const std::uint64_t UNIFORM_WORD = 0;
+
+    // Number of set bits in a word
+    int popcount(std::uint64_t value) {
+        value -= (value >> 1) & 0x5555555555555555ull;
+        value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+        value = (value + (value >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        return static_cast<int>((value * 0x0101010101010101ull) >> 56);
+    }
+}
+
+ChunkStorage::ChunkStorage() = default;
+
+// Get the block type at local coordinates
+BlockType ChunkStorage::get(int x, int y, int z) const {
+    if (!contains(x, y, z)) return BlockType::AIR;
+
+    return sections[y / SECTION_HEIGHT].get(sectionIndex(x, y, z));
+}
+
+// Set the block type at local coordinates
+void ChunkStorage::set(int x, int y, int z, BlockType type) {
+    if (!contains(x, y, z)) return;
+
+    sections[y / SECTION_HEIGHT].set(sectionIndex(x, y, z), type);
+}
+
+// Check if local coordinates are inside the column
+bool ChunkStorage::contains(int x, int y, int z) {
+    return x >= 0 && x < SIZE && y >= 0 && y < HEIGHT && z >= 0 && z < SIZE;
+}
+
+// Check if a section only contains air
+bool ChunkStorage::isSectionEmpty(int section) const {
+    return sections[section].isEmpty();
+}
+
+// Check if a section is made of a single block type
+bool ChunkStorage::isSectionUniform(int section) const {
+    return sections[section].isUniform();
+}
+
+// Get the number of non-air blocks in a section
+int ChunkStorage::getSectionBlockCount(int section) const {
+    return sections[section].getBlockCount();
+}
+
+// Approximate number of bytes used by the storage
+std::size_t ChunkStorage::memoryUsage() const {
+    std::size_t total = sizeof(ChunkStorage);
+    for (const Section& section : sections) {
+        total += section.memoryUsage();
+    }
+    return total;
+}
+
+// Get the number of sections reading borrowed words
+int ChunkStorage::borrowedSectionCount() const {
+    int count = 0;
+    for (const Section& section : sections) {
+        count += section.isBorrowed();
+    }
+    return count;
+}
+
+// Copy out the contents of a section
+ChunkStorage::SectionData ChunkStorage::getSectionData(int section) const {
+    return sections[section].save();
+}
+
+// Replace the contents of a section
+bool ChunkStorage::setSectionData(int section, SectionData sectionData) {
+    if (section < 0 || section >= SECTION_COUNT) return false;
+
+    return sections[section].load(std::move(sectionData));
+}
+
+// Voxels are laid out y-major so that a section is a contiguous slab
+int ChunkStorage::sectionIndex(int x, int y, int z) {
+    return ((y % SECTION_HEIGHT) * SIZE + z) * SIZE + x;
+}
+
+// A new section is uniform air and stores nothing per voxel
+ChunkStorage::Section::Section() : palette{BlockType::AIR}, words(&UNIFORM_WORD), bitsPerEntry(0), blockCount(0) {}
+
+ChunkStorage::Section::Section(const Section& other)
+    : palette(other.palette), data(other.data), backing(other.backing), bitsPerEntry(other.bitsPerEntry),
+      blockCount(other.blockCount) {
+    words = backing || bitsPerEntry == 0 ? other.words : data.data();
+}
+
+ChunkStorage::Section& ChunkStorage::Section::operator=(const Section& other) {
+    if (this != &other) {
+        palette = other.palette;
+        data = other.data;
+        backing = other.backing;
+        bitsPerEntry = other.bitsPerEntry;
+        blockCount = other.blockCount;
+        words = backing || bitsPerEntry == 0 ? other.words : data.data();
+    }
+    return *this;
+}
+
+BlockType ChunkStorage::Section::get(int index) const {
+    return palette[getPaletteIndex(index)];
+}
+
+void ChunkStorage::Section::set(int index, BlockType type) {
+    BlockType previous = get(index);
+    if (previous == type) return;
+
+    // A uniform section gets per-voxel storage, every voxel on the palette index of its type
+    if (bitsPerEntry == 0) {
+        bitsPerEntry = 1;
+        data.assign(SECTION_VOLUME / 64, 0);
+        words = data.data();
+    }
+    if (backing) own();
+
+    // Look up the type in the palette (palettes are tiny, a linear scan is the fastest option)
+    int paletteIndex = -1;
+    for (int i = 0; i < static_cast<int>(palette.size()); i++) {
+        if (palette[i] == type) {
+            paletteIndex = i;
+            break;
+        }
+    }
+
+    // Add the type to the palette, widening the indices if they no longer fit
+    if (paletteIndex == -1) {
+        paletteIndex = static_cast<int>(palette.size());
+        palette.push_back(type);
+
+        if (paletteIndex >= (1 << bitsPerEntry)) {
+            grow(bitsPerEntry * 2);
+        }
+    }
+
+    setPaletteIndex(index, paletteIndex);
+
+    blockCount += (type != BlockType::AIR) - (previous != BlockType::AIR);
+    collapse();
+}
+
+bool ChunkStorage::Section::isEmpty() const {
+    return blockCount == 0;
+}
+
+bool ChunkStorage::Section::isUniform() const {
+    return bitsPerEntry == 0;
+}
+
+int ChunkStorage::Section::getBlockCount() const {
+    return blockCount;
+}
+
+bool ChunkStorage::Section::isBorrowed() const {
+    return backing != nullptr;
+}
+
+// Borrowed words are not counted, they belong to the mapped file
+std::size_t ChunkStorage::Section::memoryUsage() const {
+    return palette.capacity() * sizeof(BlockType) + data.capacity() * sizeof(std::uint64_t);
+}
+
+ChunkStorage::SectionData ChunkStorage::Section::save() const {
+    SectionData sectionData;
+    sectionData.palette = palette;
+    sectionData.bitsPerEntry = bitsPerEntry;
+    sectionData.data.assign(words, words + SECTION_VOLUME * bitsPerEntry / 64);
+    return sectionData;
+}
+
+bool ChunkStorage::Section::load(SectionData sectionData) {
+    int bits = sectionData.bitsPerEntry;
+    if (bits != 0 && bits != 1 && bits != 2 && bits != 4 && bits != 8) return false;
+    if (sectionData.palette.empty() || sectionData.palette.size() > (std::size_t(1) << bits)) return false;
+    if (sectionData.borrowedData ? !sectionData.backing
+                                 : sectionData.data.size() != static_cast<std::size_t>(SECTION_VOLUME * bits / 64)) {
+        return false;
+    }
+
+    palette = std::move(sectionData.palette);
+    bitsPerEntry = bits;
+    if (bits == 0) {
+        data.clear();
+        data.shrink_to_fit();
+        words = &UNIFORM_WORD;
+        backing.reset();
+    } else if (sectionData.borrowedData) {
+        data.clear();
+        data.shrink_to_fit();
+        words = sectionData.borrowedData;
+        backing = std::move(sectionData.backing);
+    } else {
+        data = std::move(sectionData.data);
+        words = data.data();
+        backing.reset();
+    }
+
+    blockCount = countBlocks();
+    if (palette.size() == 1) makeUniform(palette[0]);
+    collapse();
+    return true;
+}
+
+int ChunkStorage::Section::getPaletteIndex(int index) const {
+    // Entry widths divide 64, so an entry never straddles two words (uniform sections read index 0 from their zero word)
+    int bitIndex = index * bitsPerEntry;
+    std::uint64_t mask = (std::uint64_t(1) << bitsPerEntry) - 1;
+    return static_cast<int>((words[bitIndex >> 6] >> (bitIndex & 63)) & mask);
+}
+
+void ChunkStorage::Section::setPaletteIndex(int index, int paletteIndex) {
+    int bitIndex = index * bitsPerEntry;
+    std::uint64_t mask = (std::uint64_t(1) << bitsPerEntry) - 1;
+    std::uint64_t& word = data[bitIndex >> 6];
+    word = (word & ~(mask << (bitIndex & 63))) | (std::uint64_t(paletteIndex) << (bitIndex & 63));
+}
+
+void ChunkStorage::Section::grow(int newBitsPerEntry) {
+    std::vector<int> indices(SECTION_VOLUME);
+    for (int i = 0; i < SECTION_VOLUME; i++) {
+        indices[i] = getPaletteIndex(i);
+    }
+
+    bitsPerEntry = newBitsPerEntry;
+    data.assign(SECTION_VOLUME * bitsPerEntry / 64, 0);
+    words = data.data();
+
+    for (int i = 0; i < SECTION_VOLUME; i++) {
+        setPaletteIndex(i, indices[i]);
+    }
+}
+
+void ChunkStorage::Section::own() {
+    data.assign(words, words + SECTION_VOLUME * bitsPerEntry / 64);
+    words = data.data();
+    backing.reset();
+}
+
+void ChunkStorage::Section::collapse() {
+    if (bitsPerEntry == 0) return;
+
+    // Without per-type counts, a full section is only known to be one type when air is the only other entry
+    if (blockCount == 0) {
+        makeUniform(BlockType::AIR);
+    } else if (blockCount == SECTION_VOLUME && palette.size() == 2 &&
+               (palette[0] == BlockType::AIR || palette[1] == BlockType::AIR)) {
+        makeUniform(palette[0] == BlockType::AIR ? palette[1] : palette[0]);
+    }
+}
+
+void ChunkStorage::Section::makeUniform(BlockType type) {
+    palette.assign(1, type);
+    palette.shrink_to_fit();
+    data.clear();
+    data.shrink_to_fit();
+    words = &UNIFORM_WORD;
+    backing.reset();
+    bitsPerEntry = 0;
+    blockCount = type == BlockType::AIR ? 0 : SECTION_VOLUME;
+}
+
+int ChunkStorage::Section::countBlocks() const {
+    // The palette answers without looking at the voxels when air is missing from it or is all of it
+    bool hasAir = false, hasBlocks = false;
+    for (BlockType type : palette) {
+        if (type == BlockType::AIR) hasAir = true;
+        else hasBlocks = true;
+    }
+    if (!hasBlocks) return 0;
+    if (!hasAir) return SECTION_VOLUME;
+
+    // Count the entries holding the air index a word at a time: entries equal to it become zero after the
+    // xor, then the bits of each entry are folded into its lowest bit
+    int airIndex = 0;
+    while (palette[airIndex] != BlockType::AIR) airIndex++;
+    const std::uint64_t lowBits = ~std::uint64_t(0) / ((std::uint64_t(1) << bitsPerEntry) - 1);
+    const std::uint64_t airPattern = static_cast<std::uint64_t>(airIndex) * lowBits;
+
+    int airCount = 0;
+    for (int i = 0; i < SECTION_VOLUME * bitsPerEntry / 64; i++) {
+        std::uint64_t word = words[i] ^ airPattern;
+        for (int shift = 1; shift < bitsPerEntry; shift *= 2) {
+            word |= word >> shift;
+        }
+        airCount += popcount(~word & lowBits);
+    }
+    return SECTION_VOLUME - airCount;
+}
@@ -0,0 +1,128 @@
+#ifndef MINECRAFTCLONE_CHUNKSTORAGE_H
+#define MINECRAFTCLONE_CHUNKSTORAGE_H
+
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "BlockType.h"
+#include "../Config.h"
+
+// Dense voxel storage for one chunk column. The column is split into 16-high sections,
+// each holding a small palette of block types and a bit-packed array of palette indices
+// (1, 2, 4 or 8 bits per voxel, widened as new types are added to the section). A section made of
+// a single block type (all air above the terrain, all stone below it) is uniform: 0 bits per voxel
+// and no per-voxel storage. Each section counts its non-air blocks, so empty sections are found in O(1).
+class ChunkStorage {
+public:
+    static constexpr int SIZE = Config::World::CHUNK_SIZE;
+    static constexpr int HEIGHT = Config::World::CHUNK_HEIGHT;
+    static constexpr int SECTION_HEIGHT = Config::World::SECTION_HEIGHT;
+    static constexpr int SECTION_COUNT = HEIGHT / SECTION_HEIGHT;
+    static constexpr int SECTION_VOLUME = SIZE * SIZE * SECTION_HEIGHT;
+
+    // Contents of a section as stored: the palette and the bit-packed palette indices. Entries are packed
+    // from the low bits of each 64-bit word and never straddle two words. A uniform section has a palette
+    // of one type, 0 bits per entry and no data.
+    //
+    // Instead of data, a section can be given borrowedData: words that live in memory owned by backing
+    // (a mapped region file). The section then reads them in place and copies them on its first write.
+    struct SectionData {
+        std::vector<BlockType> palette;
+        int bitsPerEntry = 1;
+        std::vector<std::uint64_t> data;
+        const std::uint64_t* borrowedData = nullptr;
+        std::shared_ptr<const void> backing;
+    };
+
+    ChunkStorage();
+
+    // Get the block type at local coordinates (AIR outside the column)
+    [[nodiscard]] BlockType get(int x, int y, int z) const;
+
+    // Set the block type at local coordinates (ignored outside the column)
+    void set(int x, int y, int z, BlockType type);
+
+    // Check if local coordinates are inside the column
+    [[nodiscard]] static bool contains(int x, int y, int z);
+
+    // Check if a section only contains air
+    [[nodiscard]] bool isSectionEmpty(int section) const;
+
+    // Check if a section is made of a single block type (and has no per-voxel storage)
+    [[nodiscard]] bool isSectionUniform(int section) const;
+
+    // Get the number of non-air blocks in a section
+    [[nodiscard]] int getSectionBlockCount(int section) const;
+
+    // Approximate number of bytes used by the storage (including heap allocations, not borrowed words)
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+    // Get the number of sections reading borrowed words
+    [[nodiscard]] int borrowedSectionCount() const;
+
+    // Copy out the contents of a section (used for serialization)
+    [[nodiscard]] SectionData getSectionData(int section) const;
+
+    // Replace the contents of a section, returns false (leaving the section untouched) if the data is malformed
+    bool setSectionData(int section, SectionData sectionData);
+
+private:
+    class Section {
+    public:
+        Section();
+
+        // Copies point at their own words, or share the borrowed ones (moves keep the vector buffer)
+        Section(const Section& other);
+        Section& operator=(const Section& other);
+        Section(Section&& other) noexcept = default;
+        Section& operator=(Section&& other) noexcept = default;
+
+        [[nodiscard]] BlockType get(int index) const;
+        void set(int index, BlockType type);
+
+        [[nodiscard]] bool isEmpty() const;
+        [[nodiscard]] bool isUniform() const;
+        [[nodiscard]] int getBlockCount() const;
+        [[nodiscard]] bool isBorrowed() const;
+        [[nodiscard]] std::size_t memoryUsage() const;
+
+        [[nodiscard]] SectionData save() const;
+        bool load(SectionData sectionData);
+
+    private:
+        std::vector<BlockType> palette;      // Block types used by this section
+        std::vector<std::uint64_t> data;     // Bit-packed palette indices (empty while uniform or borrowed)
+        const std::uint64_t* words;          // Words in use: data.data(), borrowed words or a zero word when uniform
+        std::shared_ptr<const void> backing; // Keeps borrowed words alive
+        int bitsPerEntry;                    // 0 (uniform), 1, 2, 4 or 8 bits per voxel
+        int blockCount;                      // Non-air voxels
+
+        [[nodiscard]] int getPaletteIndex(int index) const;
+        void setPaletteIndex(int index, int paletteIndex);
+
+        // Repack the data with a larger number of bits per entry
+        void grow(int newBitsPerEntry);
+
+        // Copy borrowed words into data before they are modified
+        void own();
+
+        // Drop the per-voxel storage once the section holds a single type (all air, or full of one block)
+        void collapse();
+
+        // Make the section a single block type
+        void makeUniform(BlockType type);
+
+        // Count the non-air voxels
+        [[nodiscard]] int countBlocks() const;
+    };
+
+    std::array<Section, SECTION_COUNT> sections;
+
+    // Index of a voxel inside its section
+    [[nodiscard]] static int sectionIndex(int x, int y, int z);
+};
+
+
+#endif
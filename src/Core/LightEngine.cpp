@@ -0,0 +1,310 @@
+#include <algorithm>
+#include "LightEngine.h"
+#include "../Utils/Profiler.h"
+
+namespace {
+    constexpr int SIZE = ChunkStorage::SIZE;
+    constexpr int HEIGHT = ChunkStorage::HEIGHT;
+    constexpr int SECTION_HEIGHT = ChunkStorage::SECTION_HEIGHT;
+
+    // The six neighbours of a voxel
+    constexpr std::array<std::array<int, 3>, 6> DIRECTIONS = {{
+            {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    }};
+
+    constexpr std::array<LightStorage::Channel, LightStorage::CHANNEL_COUNT> CHANNELS = {LightStorage::SKY, LightStorage::BLOCK};
+}
+
+// Light a chunk on its own
+void LightEngine::lightChunk(Chunk& chunk) {
+    PROFILE_ZONE("LightEngine::lightChunk");
+    Neighbourhood alone{};
+    alone[CENTER] = &chunk;
+    begin(alone);
+
+    const ChunkStorage& blocks = chunk.getStorage();
+    LightStorage& light = chunk.getLight();
+
+    // Height of every column above its highest block, only the sections holding blocks are scanned
+    int topSection = ChunkStorage::SECTION_COUNT - 1;
+    while (topSection >= 0 && blocks.isSectionEmpty(topSection)) topSection--;
+
+    std::array<int, SIZE * SIZE> heights{};
+    int maxHeight = 0;
+    for (int z = 0; z < SIZE; z++) {
+        for (int x = 0; x < SIZE; x++) {
+            int y = (topSection + 1) * SECTION_HEIGHT - 1;
+            while (y >= 0 && blocks.get(x, y, z) == BlockType::AIR) y--;
+            heights[z * SIZE + x] = y + 1;
+            maxHeight = std::max(maxHeight, y + 1);
+        }
+    }
+
+    // Sky light falls down every column to its highest block, the sections above all of them are open sky
+    int openSection = (maxHeight + SECTION_HEIGHT - 1) / SECTION_HEIGHT;
+    for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+        light.fillSection(section, section >= openSection ? LightStorage::pack(LightStorage::MAX_LEVEL, 0) : 0);
+    }
+
+    for (int z = 0; z < SIZE; z++) {
+        for (int x = 0; x < SIZE; x++) {
+            int height = heights[z * SIZE + x];
+            for (int y = height; y < openSection * SECTION_HEIGHT; y++) {
+                light.set(LightStorage::SKY, x, y, z, LightStorage::MAX_LEVEL);
+            }
+
+            // A block at the very top is lit by the sky directly
+            if (height == HEIGHT) {
+                int level = sourceLevel(LightStorage::SKY, blocks.get(x, HEIGHT - 1, z), HEIGHT - 1);
+                if (level > 0) {
+                    light.set(LightStorage::SKY, x, HEIGHT - 1, z, level);
+                    addQueue.push_back({x, HEIGHT - 1, z, 0});
+                }
+                continue;
+            }
+
+            // Only the sky light next to lower columns (and above the highest block) can spread further
+            int spreadHeight = height;
+            if (x > 0) spreadHeight = std::max(spreadHeight, heights[z * SIZE + x - 1]);
+            if (x < SIZE - 1) spreadHeight = std::max(spreadHeight, heights[z * SIZE + x + 1]);
+            if (z > 0) spreadHeight = std::max(spreadHeight, heights[(z - 1) * SIZE + x]);
+            if (z < SIZE - 1) spreadHeight = std::max(spreadHeight, heights[(z + 1) * SIZE + x]);
+            for (int y = height; y <= std::min(std::max(height, spreadHeight - 1), HEIGHT - 1); y++) {
+                addQueue.push_back({x, y, z, 0});
+            }
+        }
+    }
+    propagateAdd(LightStorage::SKY);
+
+    // Block light starts from every block giving off light
+    for (int section = 0; section <= topSection; section++) {
+        if (blocks.isSectionEmpty(section)) continue;
+
+        for (int y = section * SECTION_HEIGHT; y < (section + 1) * SECTION_HEIGHT; y++) {
+            for (int z = 0; z < SIZE; z++) {
+                for (int x = 0; x < SIZE; x++) {
+                    int level = BlockRegistry::get(blocks.get(x, y, z)).emission;
+                    if (level > 0) {
+                        light.set(LightStorage::BLOCK, x, y, z, level);
+                        addQueue.push_back({x, y, z, 0});
+                    }
+                }
+            }
+        }
+    }
+    propagateAdd(LightStorage::BLOCK);
+}
+
+// Spread light across the borders between the center chunk and its four neighbours
+void LightEngine::stitch(const Neighbourhood& neighbourhood) {
+    PROFILE_ZONE("LightEngine::stitch");
+    begin(neighbourhood);
+    const LightStorage& light = chunks[CENTER]->getLight();
+
+    for (LightStorage::Channel channel : CHANNELS) {
+        for (const std::array<int, 3>& direction : DIRECTIONS) {
+            if (direction[1] != 0) continue;
+
+            int slot = (direction[2] + 1) * 3 + direction[0] + 1;
+            if (!chunks[slot]) continue;
+            const LightStorage& neighbourLight = chunks[slot]->getLight();
+
+            // The voxels of the center chunk along the border, and the voxels facing them in the neighbour
+            int x = direction[0] > 0 ? SIZE - 1 : 0;
+            int z = direction[2] > 0 ? SIZE - 1 : 0;
+            int neighbourX = direction[0] > 0 ? 0 : direction[0] < 0 ? SIZE - 1 : 0;
+            int neighbourZ = direction[2] > 0 ? 0 : direction[2] < 0 ? SIZE - 1 : 0;
+
+            for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                // Nothing flows between two sections with the same light everywhere
+                int bottom = section * SECTION_HEIGHT;
+                if (light.isSectionUniform(section) && neighbourLight.isSectionUniform(section) &&
+                    light.get(0, bottom, 0) == neighbourLight.get(0, bottom, 0)) continue;
+
+                for (int y = bottom; y < bottom + SECTION_HEIGHT; y++) {
+                    for (int i = 0; i < SIZE; i++) {
+                        int cx = direction[0] != 0 ? x : i, cz = direction[2] != 0 ? z : i;
+                        int nx = direction[0] != 0 ? neighbourX : i, nz = direction[2] != 0 ? neighbourZ : i;
+
+                        int level = light.get(channel, cx, y, cz);
+                        int neighbourLevel = neighbourLight.get(channel, nx, y, nz);
+                        if (level > neighbourLevel + 1) {
+                            addQueue.push_back({cx, y, cz, 0});
+                        } else if (neighbourLevel > level + 1) {
+                            addQueue.push_back({nx + direction[0] * SIZE, y, nz + direction[2] * SIZE, 0});
+                        }
+                    }
+                }
+            }
+        }
+        propagateAdd(channel);
+    }
+}
+
+// Update the light after the block at local coordinates of the center chunk was replaced
+void LightEngine::blockChanged(const Neighbourhood& neighbourhood, int x, int y, int z, BlockType previous, BlockType type) {
+    PROFILE_ZONE("LightEngine::blockChanged");
+    begin(neighbourhood);
+    if (!ChunkStorage::contains(x, y, z)) return;
+
+    // Light only cares about opacity, emission and whether sky light falls through freely
+    const BlockRegistry::BlockProperties& before = BlockRegistry::get(previous);
+    const BlockRegistry::BlockProperties& after = BlockRegistry::get(type);
+    if (before.opaque == after.opaque && before.emission == after.emission &&
+        (previous == BlockType::AIR) == (type == BlockType::AIR)) return;
+
+    for (LightStorage::Channel channel : CHANNELS) {
+        // Darken everything that was lit through the block
+        int slot = CENTER;
+        int level = chunks[CENTER]->getLight().get(channel, x, y, z);
+        if (level > 0) {
+            setLevel(channel, chunks[CENTER], slot, x, y, z, 0);
+            removeQueue.push_back({x, y, z, level});
+        }
+
+        // The new block lights itself, and a block letting light through takes the light around it
+        int source = sourceLevel(channel, type, y);
+        if (source > 0) {
+            setLevel(channel, chunks[CENTER], slot, x, y, z, source);
+            addQueue.push_back({x, y, z, 0});
+        }
+        if (!after.opaque) {
+            for (const std::array<int, 3>& direction : DIRECTIONS) {
+                int nx = x + direction[0], ny = y + direction[1], nz = z + direction[2], neighbourSlot = 0;
+                if (locate(nx, ny, nz, neighbourSlot)) addQueue.push_back({x + direction[0], ny, z + direction[2], 0});
+            }
+        }
+
+        propagateRemove(channel);
+        propagateAdd(channel);
+    }
+}
+
+// Get the sections whose light changed in the last call
+const std::array<std::uint32_t, 9>& LightEngine::getChangedSections() const {
+    return changedSections;
+}
+
+// Get the number of voxel light levels written
+std::uint64_t LightEngine::getUpdatedVoxels() const {
+    return updatedVoxels;
+}
+
+// Get the light level a block gives itself in a channel
+int LightEngine::sourceLevel(LightStorage::Channel channel, BlockType type, int y) {
+    if (channel == LightStorage::BLOCK) return BlockRegistry::get(type).emission;
+
+    // Sky light enters the top of the column at full level from above
+    return y == HEIGHT - 1 ? passedLevel(LightStorage::SKY, LightStorage::MAX_LEVEL, -1, type) : 0;
+}
+
+// Start an update of a neighbourhood
+void LightEngine::begin(const Neighbourhood& neighbourhood) {
+    chunks = neighbourhood;
+    addQueue.clear();
+    removeQueue.clear();
+    changedSections.fill(0);
+}
+
+// Get the chunk holding a voxel and make its coordinates local to it
+Chunk* LightEngine::locate(int& x, int y, int& z, int& slot) const {
+    if (y < 0 || y >= HEIGHT || x < -SIZE || x >= 2 * SIZE || z < -SIZE || z >= 2 * SIZE) return nullptr;
+
+    int chunkX = x < 0 ? -1 : (x >= SIZE ? 1 : 0);
+    int chunkZ = z < 0 ? -1 : (z >= SIZE ? 1 : 0);
+    x -= chunkX * SIZE;
+    z -= chunkZ * SIZE;
+    slot = (chunkZ + 1) * 3 + chunkX + 1;
+    return chunks[slot];
+}
+
+// Set the level of a voxel and mark the sections that use it
+void LightEngine::setLevel(LightStorage::Channel channel, Chunk* chunk, int slot, int x, int y, int z, int level) {
+    chunk->getLight().set(channel, x, y, z, level);
+    updatedVoxels++;
+
+    // The meshes of the sections and chunks next to a voxel on their border read its light too
+    int chunkX = slot % 3 - 1, chunkZ = slot / 3 - 1;
+    int section = y / SECTION_HEIGHT;
+    for (int dz = -1; dz <= 1; dz++) {
+        if ((dz < 0 && z != 0) || (dz > 0 && z != SIZE - 1) || chunkZ + dz < -1 || chunkZ + dz > 1) continue;
+        for (int dx = -1; dx <= 1; dx++) {
+            if ((dx < 0 && x != 0) || (dx > 0 && x != SIZE - 1) || chunkX + dx < -1 || chunkX + dx > 1) continue;
+            for (int ds = -1; ds <= 1; ds++) {
+                if ((ds < 0 && y % SECTION_HEIGHT != 0) || (ds > 0 && y % SECTION_HEIGHT != SECTION_HEIGHT - 1)) continue;
+                if (section + ds < 0 || section + ds >= ChunkStorage::SECTION_COUNT) continue;
+                changedSections[slot + dz * 3 + dx] |= 1u << (section + ds);
+            }
+        }
+    }
+}
+
+// Level a voxel receives from a neighbour at a level, one step away in a direction
+int LightEngine::passedLevel(LightStorage::Channel channel, int level, int dy, BlockType type) {
+    if (BlockRegistry::get(type).opaque) return 0;
+
+    // Full sky light falls through air without fading
+    if (channel == LightStorage::SKY && level == LightStorage::MAX_LEVEL && dy < 0 && type == BlockType::AIR) return level;
+    return std::max(level - 1, 0);
+}
+
+// Spread the light of the queued voxels until nothing gets brighter
+void LightEngine::propagateAdd(LightStorage::Channel channel) {
+    for (std::size_t i = 0; i < addQueue.size(); i++) {
+        Node node = addQueue[i];
+        int x = node.x, z = node.z, slot = 0;
+        Chunk* chunk = locate(x, node.y, z, slot);
+        if (!chunk) continue;
+
+        int level = chunk->getLight().get(channel, x, node.y, z);
+        if (level <= 1) continue;
+
+        for (const std::array<int, 3>& direction : DIRECTIONS) {
+            int nx = node.x + direction[0], ny = node.y + direction[1], nz = node.z + direction[2], neighbourSlot = 0;
+            Chunk* neighbour = locate(nx, ny, nz, neighbourSlot);
+            if (!neighbour) continue;
+
+            int passed = passedLevel(channel, level, direction[1], neighbour->getStorage().get(nx, ny, nz));
+            if (passed > neighbour->getLight().get(channel, nx, ny, nz)) {
+                setLevel(channel, neighbour, neighbourSlot, nx, ny, nz, passed);
+                addQueue.push_back({node.x + direction[0], ny, node.z + direction[2], 0});
+            }
+        }
+    }
+    addQueue.clear();
+}
+
+// Darken the voxels lit through the queued ones and queue the voxels around them to light them again
+void LightEngine::propagateRemove(LightStorage::Channel channel) {
+    for (std::size_t i = 0; i < removeQueue.size(); i++) {
+        Node node = removeQueue[i];
+
+        for (const std::array<int, 3>& direction : DIRECTIONS) {
+            int nx = node.x + direction[0], ny = node.y + direction[1], nz = node.z + direction[2], neighbourSlot = 0;
+            Chunk* neighbour = locate(nx, ny, nz, neighbourSlot);
+            if (!neighbour) continue;
+
+            int level = neighbour->getLight().get(channel, nx, ny, nz);
+            if (level == 0) continue;
+
+            // A dimmer neighbour (or full sky light right below) got its light from the removed voxel
+            bool litThrough = level < node.level || (channel == LightStorage::SKY && direction[1] < 0 &&
+                                                     node.level == LightStorage::MAX_LEVEL && level == LightStorage::MAX_LEVEL);
+            Node next = {node.x + direction[0], ny, node.z + direction[2], level};
+            if (!litThrough) {
+                addQueue.push_back(next);  // Lit from elsewhere, it lights the darkened voxels again
+                continue;
+            }
+
+            setLevel(channel, neighbour, neighbourSlot, nx, ny, nz, 0);
+            removeQueue.push_back(next);
+
+            int source = sourceLevel(channel, neighbour->getStorage().get(nx, ny, nz), ny);
+            if (source > 0) {
+                setLevel(channel, neighbour, neighbourSlot, nx, ny, nz, source);
+                addQueue.push_back(next);
+            }
+        }
+    }
+    removeQueue.clear();
+}
@@ -0,0 +1,76 @@
+#ifndef MINECRAFTCLONE_LIGHTENGINE_H
+#define MINECRAFTCLONE_LIGHTENGINE_H
+
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Chunk.h"
+#include "LightStorage.h"
+
+// Flood fill of sky light and block light through the voxels that are not opaque. Each step loses one
+// level, except sky light at full level going down through air, which lights every open column from the top.
+// A chunk is lit on its own when it is generated, its light is then spread across the borders to the chunks
+// around it, and block edits update the light incrementally: a removal queue darkens the voxels lit through
+// the edited block and an add queue fills them again from the light around them. Light never travels more
+// than 15 blocks sideways, less than a chunk, so every update stays within the 3x3 chunks around the edit.
+class LightEngine {
+public:
+    // The 3x3 chunks around a chunk, indexed [(dz + 1) * 3 + (dx + 1)] (nullptr where no chunk is loaded)
+    using Neighbourhood = std::array<Chunk*, 9>;
+
+    static constexpr int CENTER = 4;
+
+    // Light a chunk on its own, as if nothing was around it
+    void lightChunk(Chunk& chunk);
+
+    // Spread light across the borders between the center chunk and its four neighbours, in both directions
+    void stitch(const Neighbourhood& chunks);
+
+    // Update the light after the block at local coordinates of the center chunk was replaced
+    void blockChanged(const Neighbourhood& chunks, int x, int y, int z, BlockType previous, BlockType type);
+
+    // Get the sections whose light changed in the last call, a bit per section for each chunk of the neighbourhood
+    // (a voxel on a border also marks the sections next to it, whose meshes use its light)
+    [[nodiscard]] const std::array<std::uint32_t, 9>& getChangedSections() const;
+
+    // Get the number of voxel light levels written since the engine was created
+    [[nodiscard]] std::uint64_t getUpdatedVoxels() const;
+
+    // Get the light level a block gives itself in a channel, before any light reaches it from around
+    [[nodiscard]] static int sourceLevel(LightStorage::Channel channel, BlockType type, int y);
+
+private:
+    // Voxels are addressed relative to the center chunk, from -SIZE to 2 * SIZE - 1 on x and z
+    struct Node {
+        int x, y, z;
+        int level;  // Level the voxel had when it was queued for removal
+    };
+
+    Neighbourhood chunks{};
+    std::vector<Node> addQueue;
+    std::vector<Node> removeQueue;
+    std::array<std::uint32_t, 9> changedSections{};
+    std::uint64_t updatedVoxels = 0;
+
+    // Start an update of a neighbourhood
+    void begin(const Neighbourhood& neighbourhood);
+
+    // Get the chunk holding a voxel and make its coordinates local to it (nullptr outside the neighbourhood)
+    [[nodiscard]] Chunk* locate(int& x, int y, int& z, int& slot) const;
+
+    // Set the level of a voxel located in a chunk of the neighbourhood and mark the sections that use it
+    void setLevel(LightStorage::Channel channel, Chunk* chunk, int slot, int x, int y, int z, int level);
+
+    // Level a voxel receives from a neighbour at a level, one step away in a direction (0 if it cannot pass)
+    [[nodiscard]] static int passedLevel(LightStorage::Channel channel, int level, int dy, BlockType type);
+
+    // Spread the light of the queued voxels until nothing gets brighter
+    void propagateAdd(LightStorage::Channel channel);
+
+    // Darken the voxels lit through the queued ones and queue the voxels around them to light them again
+    void propagateRemove(LightStorage::Channel channel);
+};
+
+
+#endif
@@ -0,0 +1,58 @@
+#include "LightStorage.h"
+
+LightStorage::LightStorage() = default;
+
+// Get the packed light at local coordinates
+std::uint8_t LightStorage::get(int x, int y, int z) const {
+    if (y >= ChunkStorage::HEIGHT) return pack(MAX_LEVEL, 0);
+    if (!ChunkStorage::contains(x, y, z)) return 0;
+
+    const Section& section = sections[y / ChunkStorage::SECTION_HEIGHT];
+    return section.data.empty() ? section.uniform : section.data[sectionIndex(x, y, z)];
+}
+
+// Get the level of one channel at local coordinates
+int LightStorage::get(Channel channel, int x, int y, int z) const {
+    std::uint8_t light = get(x, y, z);
+    return channel == SKY ? light >> 4 : light & 0x0F;
+}
+
+// Set the level of one channel at local coordinates
+void LightStorage::set(Channel channel, int x, int y, int z, int level) {
+    if (!ChunkStorage::contains(x, y, z)) return;
+
+    Section& section = sections[y / ChunkStorage::SECTION_HEIGHT];
+    std::uint8_t current = section.data.empty() ? section.uniform : section.data[sectionIndex(x, y, z)];
+    std::uint8_t light = channel == SKY ? pack(level, current & 0x0F) : pack(current >> 4, level);
+    if (light == current) return;
+
+    // The first voxel that differs gives the section its per-voxel storage
+    if (section.data.empty()) section.data.assign(ChunkStorage::SECTION_VOLUME, section.uniform);
+    section.data[sectionIndex(x, y, z)] = light;
+}
+
+// Give every voxel of a section the same packed light
+void LightStorage::fillSection(int section, std::uint8_t light) {
+    sections[section].data.clear();
+    sections[section].data.shrink_to_fit();
+    sections[section].uniform = light;
+}
+
+// Check if a section has the same light everywhere
+bool LightStorage::isSectionUniform(int section) const {
+    return sections[section].data.empty();
+}
+
+// Approximate number of bytes used by the storage
+std::size_t LightStorage::memoryUsage() const {
+    std::size_t total = sizeof(LightStorage);
+    for (const Section& section : sections) {
+        total += section.data.capacity();
+    }
+    return total;
+}
+
+// Index of a voxel inside its section
+int LightStorage::sectionIndex(int x, int y, int z) {
+    return ((y % ChunkStorage::SECTION_HEIGHT) * ChunkStorage::SIZE + z) * ChunkStorage::SIZE + x;
+}
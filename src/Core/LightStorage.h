@@ -0,0 +1,63 @@
+#ifndef MINECRAFTCLONE_LIGHTSTORAGE_H
+#define MINECRAFTCLONE_LIGHTSTORAGE_H
+
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "ChunkStorage.h"
+
+// Light of one chunk column: a byte per voxel, sky light in the high 4 bits and block light in the low 4 bits.
+// Like the blocks, the light is split into sections; a section with the same light everywhere (full sky above
+// the terrain, dark inside the ground) keeps a single value and no per-voxel storage.
+class LightStorage {
+public:
+    static constexpr int MAX_LEVEL = 15;
+
+    // Light channels, in the order they are packed from the high bits
+    enum Channel {
+        SKY,
+        BLOCK,
+        CHANNEL_COUNT
+    };
+
+    LightStorage();
+
+    // Get the packed light at local coordinates (full sky light above the column, dark below it)
+    [[nodiscard]] std::uint8_t get(int x, int y, int z) const;
+
+    // Get the level of one channel at local coordinates
+    [[nodiscard]] int get(Channel channel, int x, int y, int z) const;
+
+    // Set the level of one channel at local coordinates (ignored outside the column)
+    void set(Channel channel, int x, int y, int z, int level);
+
+    // Give every voxel of a section the same packed light, freeing its per-voxel storage
+    void fillSection(int section, std::uint8_t light);
+
+    // Check if a section has the same light everywhere (and no per-voxel storage)
+    [[nodiscard]] bool isSectionUniform(int section) const;
+
+    // Approximate number of bytes used by the storage
+    [[nodiscard]] std::size_t memoryUsage() const;
+
+    // Pack sky and block light levels into one byte
+    [[nodiscard]] static constexpr std::uint8_t pack(int sky, int block) {
+        return static_cast<std::uint8_t>(sky << 4 | block);
+    }
+
+private:
+    // Light of one section: a byte per voxel, or none when every voxel has the uniform value
+    struct Section {
+        std::vector<std::uint8_t> data;
+        std::uint8_t uniform = 0;
+    };
+
+    std::array<Section, ChunkStorage::SECTION_COUNT> sections;
+
+    // Index of a voxel inside its section (same order as ChunkStorage)
+    [[nodiscard]] static int sectionIndex(int x, int y, int z);
+};
+
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef MINECRAFTCLONE_VISIBILITYGRAPH_H
+#define MINECRAFTCLONE_VISIBILITYGRAPH_H
+
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "BlockRegistry.h"
+#include "ChunkStorage.h"
+
+// Occlusion culling between chunk sections (cave culling). When a section is meshed, a flood fill over
+// its non-opaque blocks records which of its six faces are connected through them. Rendering walks
+// from the section of the camera to its neighbours, only leaving a section through a face connected to
+// the one it came in by and never stepping back towards the camera. Sections the walk cannot reach are
+// behind solid ground (caves under the player, valleys behind a mountain) and do not need to be drawn.
+// Faces are numbered like BlockRegistry::Face, so the opposite of a face is face ^ 1.
+namespace VisibilityGraph {
+    // Step to the neighbouring section through each face (chunk x, section, chunk z)
+    constexpr std::array<std::array<int, 3>, BlockRegistry::FACE_COUNT> STEPS = {{
+            {0, 0, -1}, {0, 0, 1}, {0, -1, 0}, {0, 1, 0}, {-1, 0, 0}, {1, 0, 0}
+    }};
+
+    // Face on the other side of a section
+    constexpr int opposite(int face) {
+        return face ^ 1;
+    }
+
+    // Which faces of a section can see each other through it, a symmetric 6x6 bit matrix
+    class SectionVisibility {
+    public:
+        // Every face sees every other one (a section of air, or one that was not meshed yet)
+        static SectionVisibility all() {
+            SectionVisibility visibility;
+            visibility.bits = (std::uint64_t(1) << (BlockRegistry::FACE_COUNT * BlockRegistry::FACE_COUNT)) - 1;
+            return visibility;
+        }
+
+        // Record that two faces see each other
+        void connect(int a, int b) {
+            bits |= std::uint64_t(1) << (a * BlockRegistry::FACE_COUNT + b);
+            bits |= std::uint64_t(1) << (b * BlockRegistry::FACE_COUNT + a);
+        }
+
+        // Check if two faces see each other
+        [[nodiscard]] bool connects(int a, int b) const {
+            return (bits >> (a * BlockRegistry::FACE_COUNT + b)) & 1;
+        }
+
+    private:
+        std::uint64_t bits = 0;
+    };
+
+    // Walk the sections visible from the camera's section, in the chunks at most radius away from its chunk.
+    // getVisibility(chunk, section) returns the SectionVisibility of a section, isInView(chunk, section)
+    // tells if it is inside the view frustum (sections outside it end the walk) and visit(chunk, section)
+    // is called once for every section reached, the camera's own included.
+    template<typename GetVisibility, typename IsInView, typename Visit>
+    void walk(const sf::Vector2i& cameraChunk, int cameraSection, int radius, GetVisibility&& getVisibility,
+              IsInView&& isInView, Visit&& visit) {
+        const int width = 2 * radius + 1;
+        const int sectionCount = ChunkStorage::SECTION_COUNT;
+
+        // A section reached, the face it was entered by (-1 for the camera's) and the directions taken to reach it
+        struct Node {
+            sf::Vector2i chunk;
+            int section;
+            int enteredBy;
+            int directions;
+        };
+
+        // Above or below the column, the walk starts from the closest section
+        int startSection = cameraSection < 0 ? 0 : (cameraSection >= sectionCount ? sectionCount - 1 : cameraSection);
+
+        std::vector<bool> reached(static_cast<std::size_t>(width) * width * sectionCount, false);
+        auto slot = [&](const sf::Vector2i& chunk, int section) {
+            return (static_cast<std::size_t>(chunk.x - cameraChunk.x + radius) * width + (chunk.y - cameraChunk.y + radius)) *
+                   sectionCount + section;
+        };
+
+        std::vector<Node> queue;
+        queue.push_back({cameraChunk, startSection, -1, 0});
+        reached[slot(cameraChunk, startSection)] = true;
+
+        for (std::size_t next = 0; next < queue.size(); next++) {
+            Node node = queue[next];
+            visit(node.chunk, node.section);
+
+            SectionVisibility visibility = getVisibility(node.chunk, node.section);
+            for (int face = 0; face < BlockRegistry::FACE_COUNT; face++) {
+                // Never step back towards the camera, and only leave through faces seen from the entry
+                if (node.directions & (1 << opposite(face))) continue;
+                if (node.enteredBy >= 0 && !visibility.connects(node.enteredBy, face)) continue;
+
+                sf::Vector2i chunk(node.chunk.x + STEPS[face][0], node.chunk.y + STEPS[face][2]);
+                int section = node.section + STEPS[face][1];
+                if (section < 0 || section >= sectionCount) continue;
+                if (std::abs(chunk.x - cameraChunk.x) > radius || std::abs(chunk.y - cameraChunk.y) > radius) continue;
+
+                std::size_t index = slot(chunk, section);
+                if (reached[index]) continue;
+                reached[index] = true;  // Out of view from one side is out of view from all of them
+
+                if (!isInView(chunk, section)) continue;
+                queue.push_back({chunk, section, opposite(face), node.directions | (1 << face)});
+            }
+        }
+    }
+}
+
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef MINECRAFTCLONE_VOXELQUERY_H
+#define MINECRAFTCLONE_VOXELQUERY_H
+
+
+#include <algorithm>
+#include <cmath>
+#include <SFML/System/Vector3.hpp>
+#include "Block.h"
+#include "ChunkStorage.h"
+#include "../Utils/Math.h"
+
+// Collision and ray queries against the voxel grid. A box only ever touches the integer cells it overlaps,
+// so the queries rasterize the box into those cells and look each one up directly: the cost depends
+// on the size of the box, not on the size of the world. IsSolid is any callable taking the
+// sf::Vector3i of a cell and returning whether it blocks movement.
+namespace VoxelQuery {
+    // Same buffer as Math::AABB::intersects, so touching boxes collide like they always have
+    constexpr float EPSILON = 0.001f;
+
+    // Gap left between a box moved up to a contact and the block it hit, wider than the buffer so the
+    // resting contact does not count as a collision for the other axes
+    constexpr float CONTACT_GAP = 2.0f * EPSILON;
+
+    // Call a function for every cell overlapped by a box (grown by the collision buffer)
+    template<typename Function>
+    void forEachCell(const Math::AABB& box, Function&& function) {
+        int minX = static_cast<int>(std::floor(box.min.x - EPSILON));
+        int minY = static_cast<int>(std::floor(box.min.y - EPSILON));
+        int minZ = static_cast<int>(std::floor(box.min.z - EPSILON));
+        int maxX = static_cast<int>(std::floor(box.max.x + EPSILON));
+        int maxY = static_cast<int>(std::floor(box.max.y + EPSILON));
+        int maxZ = static_cast<int>(std::floor(box.max.z + EPSILON));
+
+        for (int y = minY; y <= maxY; y++) {
+            for (int z = minZ; z <= maxZ; z++) {
+                for (int x = minX; x <= maxX; x++) {
+                    if (!function(sf::Vector3i(x, y, z))) return;  // The function returns false to stop early
+                }
+            }
+        }
+    }
+
+    // Check if a box overlaps any solid cell
+    template<typename IsSolid>
+    bool overlapsSolid(const Math::AABB& box, IsSolid&& isSolid) {
+        bool collides = false;
+        forEachCell(box, [&](const sf::Vector3i& cell) {
+            collides = isSolid(cell) && Block::getAABB(cell).intersects(box);
+            return !collides;
+        });
+        return collides;
+    }
+
+    // Sweep a box along a displacement and return the first contact with a solid cell
+    template<typename IsSolid>
+    Math::SweepResult sweep(const Math::AABB& box, const sf::Vector3f& displacement, IsSolid&& isSolid) {
+        // Only the cells covered by the box over the whole move can be hit
+        Math::AABB swept = {{std::min(box.min.x, box.min.x + displacement.x),
+                             std::min(box.min.y, box.min.y + displacement.y),
+                             std::min(box.min.z, box.min.z + displacement.z)},
+                            {std::max(box.max.x, box.max.x + displacement.x),
+                             std::max(box.max.y, box.max.y + displacement.y),
+                             std::max(box.max.z, box.max.z + displacement.z)}};
+
+        Math::SweepResult closest;
+        forEachCell(swept, [&](const sf::Vector3i& cell) {
+            if (isSolid(cell)) {
+                Math::SweepResult result = Math::sweepAABB(box, displacement, Block::getAABB(cell));
+                if (result.hit && (!closest.hit || result.time < closest.time)) {
+                    closest = result;
+                }
+            }
+            return true;
+        });
+        return closest;
+    }
+
+    // First block hit by a ray
+    struct RaycastHit {
+        bool hit = false;
+        sf::Vector3i block;                 // Position of the block that was hit
+        sf::Vector3i normal;                // Normal of the face the ray entered the block through
+        float distance = 0.0f;              // Distance along the ray to the entry point
+        BlockType type = BlockType::AIR;
+    };
+
+    // Ray for batched queries
+    struct Ray {
+        sf::Vector3f origin;
+        sf::Vector3f direction;
+        float maxDistance = 0.0f;
+    };
+
+    // Step through the cells along a ray (Amanatides-Woo) and return the first visible block. The block
+    // containing the origin is skipped. ChunkLookup takes chunk grid coordinates and returns the
+    // const ChunkStorage* of the chunk (nullptr if not loaded); it is only called when the ray crosses
+    // into another chunk, the blocks in between are read from the cached storage.
+    template<typename ChunkLookup>
+    RaycastHit raycast(const sf::Vector3f& origin, const sf::Vector3f& direction, float maxDistance, ChunkLookup&& getStorage) {
+        float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+        if (length == 0.0f) return {};
+
+        const float start[3] = {origin.x, origin.y, origin.z};
+        const float delta[3] = {direction.x / length, direction.y / length, direction.z / length};
+        int cell[3], step[3];
+        float tMax[3], tDelta[3];
+
+        for (int axis = 0; axis < 3; axis++) {
+            cell[axis] = static_cast<int>(std::floor(start[axis]));
+            if (delta[axis] > 0.0f) {
+                step[axis] = 1;
+                tMax[axis] = (static_cast<float>(cell[axis]) + 1.0f - start[axis]) / delta[axis];
+                tDelta[axis] = 1.0f / delta[axis];
+            } else if (delta[axis] < 0.0f) {
+                step[axis] = -1;
+                tMax[axis] = (start[axis] - static_cast<float>(cell[axis])) / -delta[axis];
+                tDelta[axis] = 1.0f / -delta[axis];
+            } else {
+                step[axis] = 0;  // Never crosses a cell boundary on this axis
+                tMax[axis] = INFINITY;
+                tDelta[axis] = INFINITY;
+            }
+        }
+
+        const int chunkSize = ChunkStorage::SIZE;
+        sf::Vector2i chunkPos(Math::floorDiv(cell[0], chunkSize), Math::floorDiv(cell[2], chunkSize));
+        const ChunkStorage* storage = getStorage(chunkPos);
+
+        for (;;) {
+            // Cross the closest cell boundary
+            int axis = (tMax[0] < tMax[1] && tMax[0] < tMax[2]) ? 0 : (tMax[1] < tMax[2] ? 1 : 2);
+            float distance = tMax[axis];
+            if (distance > maxDistance) return {};
+
+            cell[axis] += step[axis];
+            tMax[axis] += tDelta[axis];
+
+            // Above or below the world and moving away from it: nothing left to hit
+            if ((cell[1] >= ChunkStorage::HEIGHT && step[1] >= 0) || (cell[1] < 0 && step[1] <= 0)) return {};
+
+            if (axis != 1) {
+                sf::Vector2i cellChunk(Math::floorDiv(cell[0], chunkSize), Math::floorDiv(cell[2], chunkSize));
+                if (cellChunk != chunkPos) {
+                    chunkPos = cellChunk;
+                    storage = getStorage(chunkPos);
+                }
+            }
+            if (!storage) continue;  // Chunks that are not loaded are empty
+
+            BlockType type = storage->get(cell[0] - chunkPos.x * chunkSize, cell[1], cell[2] - chunkPos.y * chunkSize);
+            if (BlockRegistry::get(type).visible) {
+                RaycastHit hit;
+                hit.hit = true;
+                hit.block = {cell[0], cell[1], cell[2]};
+                int normal[3] = {0, 0, 0};
+                normal[axis] = -step[axis];
+                hit.normal = {normal[0], normal[1], normal[2]};
+                hit.distance = distance;
+                hit.type = type;
+                return hit;
+            }
+        }
+    }
+}
+
+
+#endif
@@ -1,19 +1,33 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <random>
 #include "World.h"
 #include "../Config.h"
-#include "../Utils/Texture.h"
+#include "../Utils/Profiler.h"
 
-World::World(): renderDistance(Config::World::RENDER_DISTANCE), skyColor(Config::World::SKY_COLOR),
-                chunkSize(Config::World::CHUNK_SIZE), seed(std::random_device{}()), noiseGenerator(seed) {}
+World::World(): World(std::random_device{}()) {}
 
-// Initialize the world by generating chunks
-void World::init() {
-    for (int x = -Config::World::CHUNKS_GENERATION; x < Config::World::CHUNKS_GENERATION; x++) {
-        for (int z = -Config::World::CHUNKS_GENERATION; z < Config::World::CHUNKS_GENERATION; z++) {
-            generateChunkAt(x * chunkSize, z * chunkSize);  // Generate chunk at world coordinates
-        }
-    }
+World::World(unsigned int seed): renderDistance(Config::World::RENDER_DISTANCE), timeOfDay(Config::World::START_TIME_OF_DAY),
+                                 chunkSize(Config::World::CHUNK_SIZE), seed(seed), noiseGenerator(seed),
+                                 jobSystem(Config::World::WORKER_THREADS) {
+    updateSky();
+}
+
+World::World(const std::string& saveDirectory): World(WorldSave::readSeed(saveDirectory).value_or(std::random_device{}())) {
+    save = std::make_unique<WorldSave>(saveDirectory);
+    save->writeSeed(seed);
+}
+
+World::~World() {
+    saveChanges();
+}
+
+// Initialize the world by queueing the chunks around the spawn position
+void World::init(const sf::Vector3f& spawnPosition) {
+    streamingCenter = getChunkPosition(spawnPosition);
+    streamChunks(streamingCenter);
 
     setBlockAt({-12, 20, 0}, BlockType::DIRT);
     setBlockAt({-10, 20, 0}, BlockType::GRASS);
@@ -26,78 +40,182 @@ void World::init() {
     setBlockAt({4, 20, 0}, BlockType::CRAFTING_TABLE);
     setBlockAt({6, 20, 0}, BlockType::FURNACE);
     setBlockAt({8, 20, 0}, BlockType::IRON_ORE);
+    setBlockAt({10, 20, 0}, BlockType::LIT_FURNACE);
 }
 
-void World::update(float deltaTime) {
-    // Currently empty, could update blocks in the future
+// Run one simulation tick: advance the clock
+void World::tick(float deltaTime) {
+    setTimeOfDay(timeOfDay + deltaTime / Config::World::DAY_LENGTH);
 }
 
-// Render the world using the player's position
-void World::render(const sf::Vector3f& playerPosition) const {
-    glClearColor(skyColor.x, skyColor.y, skyColor.z, 1.0f);
+// Update the world once per frame: stream chunks around the player and integrate the finished ones within a time budget
 
-    // Clear buffers
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void World::update(float frameTime, const sf::Vector3f& playerPosition) {
+    PROFILE_ZONE("World::update");
+    auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float, std::milli>(Config::World::CHUNK_INTEGRATION_BUDGET);
 
-    // Enable depth testing and texture
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_TEXTURE_2D);
+    streamingCenter = getChunkPosition(playerPosition);
 
-    // Enable face culling (cull back faces)
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);  // Cull the back faces
-    glFrontFace(GL_CW);  // Ensure counter-clockwise (CCW) is the front face
+    // Move finished chunks into the world until the frame budget is used up
+    GeneratedChunk generated;
+    while (std::chrono::steady_clock::now() - start < budget && generatedChunks.tryPop(generated)) {
+        if (!isWithinRadius(generated.position, getUnloadRadius())) {
+            // The player moved away while the chunk was generated
+            pendingChunks.erase(generated.position);
+            pendingEdits.erase(generated.position);
+            continue;
+        }
+        insertChunk(generated.position, std::move(generated.chunk));
+    }
 
-    // Bind the texture atlas
-    glBindTexture(GL_TEXTURE_2D, Texture::atlas.getNativeHandle());
+    streamChunks(streamingCenter);
 
-    // Calculate the chunk coordinates of the player
-    int playerChunkX = static_cast<int>(playerPosition.x) / chunkSize;
-    int playerChunkZ = static_cast<int>(playerPosition.z) / chunkSize;
+    autosaveTimer += frameTime;
+    if (autosaveTimer >= Config::World::AUTOSAVE_INTERVAL) {
+        saveChanges();
+    }
 
-    // Iterate through chunks within render distance and render opaque blocks
-    for (int chunkX = playerChunkX - renderDistance; chunkX <= playerChunkX + renderDistance; chunkX++) {
-        for (int chunkZ = playerChunkZ - renderDistance; chunkZ <= playerChunkZ + renderDistance; chunkZ++) {
-            sf::Vector2i chunkPos(chunkX, chunkZ);
+    evictionWindow += frameTime;
+    if (evictionWindow >= 1.0f) {
+        evictionsPerSecond = static_cast<float>(windowEvictions) / evictionWindow;
+        windowEvictions = 0;
+        evictionWindow = 0.0f;
+    }
+}
 
-            // Check if the chunk exists in the world
-            auto it = chunks.find(chunkPos);
-            if (it != chunks.end()) {
-                it->second.render();  // Render opaque blocks
+// Queue the missing chunks inside the load radius (closest first) and evict the chunks outside the unload radius
+void World::streamChunks(const sf::Vector2i& centerChunk) {
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        if (!isWithinRadius(it->first, getUnloadRadius())) {
+            if (save && it->second.hasUnsavedChanges()) {
+                save->saveChunk(it->first, it->second.getStorage());
             }
+            it = chunks.erase(it);
+            windowEvictions++;
+        } else {
+            ++it;
         }
     }
 
-    // Render non-opaque blocks without culling
-    glDisable(GL_CULL_FACE);  // Disable culling for transparent/non-opaque blocks
-
-    // Iterate through chunks within render distance and render non-opaque blocks
-    for (int chunkX = playerChunkX - renderDistance; chunkX <= playerChunkX + renderDistance; chunkX++) {
-        for (int chunkZ = playerChunkZ - renderDistance; chunkZ <= playerChunkZ + renderDistance; chunkZ++) {
-            sf::Vector2i chunkPos(chunkX, chunkZ);
+    if (pendingChunks.size() >= static_cast<std::size_t>(Config::World::MAX_PENDING_CHUNKS)) return;
 
-            // Check if the chunk exists in the world
-            auto it = chunks.find(chunkPos);
-            if (it != chunks.end()) {
-                it->second.renderNotOpaque();  // Render non-opaque blocks
+    const int radius = getLoadRadius();
+    std::vector<sf::Vector2i> missing;
+    for (int x = centerChunk.x - radius; x <= centerChunk.x + radius; x++) {
+        for (int z = centerChunk.y - radius; z <= centerChunk.y + radius; z++) {
+            sf::Vector2i chunkPos(x, z);
+            if (isWithinRadius(chunkPos, radius) && !chunks.count(chunkPos) && !pendingChunks.count(chunkPos)) {
+                missing.push_back(chunkPos);
             }
         }
     }
 
-    // Disable depth testing and texture
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_DEPTH_TEST);
+    // The chunks closest to the player are generated first
+    auto distance = [&centerChunk](const sf::Vector2i& chunkPos) {
+        sf::Vector2i offset = chunkPos - centerChunk;
+        return offset.x * offset.x + offset.y * offset.y;
+    };
+    std::sort(missing.begin(), missing.end(), [&distance](const sf::Vector2i& a, const sf::Vector2i& b) {
+        return distance(a) < distance(b);
+    });
+
+    for (const sf::Vector2i& chunkPos : missing) {
+        if (pendingChunks.size() >= static_cast<std::size_t>(Config::World::MAX_PENDING_CHUNKS)) break;
+        generateChunkAt(chunkPos.x * chunkSize, chunkPos.y * chunkSize);
+    }
+}
+
+// Queue every chunk edited since the last save to be written
+void World::saveChanges() {
+    autosaveTimer = 0.0f;
+    if (!save) return;
+
+    // Snapshots that could not be written last time are written again with this save
+    save->retryFailed();
+
+    for (auto& [chunkPos, chunk] : chunks) {
+        if (chunk.hasUnsavedChanges()) {
+            save->saveChunk(chunkPos, chunk.getStorage());  // The I/O thread encodes and writes a copy
+            chunk.markSaved();
+        }
+    }
+}
+
+// Block until the queued chunks have been written
+void World::waitForSaves() {
+    if (save) {
+        save->flush();
+    }
+}
+
+// Get the save of the world
+const WorldSave* World::getSave() const {
+    return save.get();
+}
+
+// Get the chunk grid coordinates containing a world position
+sf::Vector2i World::getChunkPosition(const sf::Vector3f& position) const {
+    return {static_cast<int>(std::floor(position.x / static_cast<float>(chunkSize))),
+            static_cast<int>(std::floor(position.z / static_cast<float>(chunkSize)))};
+}
+
+// Get the radius (in chunks) chunks are generated within
+int World::getLoadRadius() const {
+    return renderDistance + Config::World::LOAD_MARGIN;
+}
+
+// Get the radius (in chunks) chunks are evicted beyond
+int World::getUnloadRadius() const {
+    return getLoadRadius() + Config::World::UNLOAD_MARGIN;
+}
+
+// Check if a chunk is inside a radius (in chunks) around the streaming center
+bool World::isWithinRadius(const sf::Vector2i& chunkPosition, int radius) const {
+    sf::Vector2i offset = chunkPosition - streamingCenter;
+    return offset.x * offset.x + offset.y * offset.y <= radius * radius;
+}
+
+// Get the chunk streaming counters
+World::StreamingStats World::getStreamingStats() const {
+    return {chunks.size(), pendingChunks.size(), evictionsPerSecond};
 }
 
 // Check if a player AABB collides with any blocks in the world
 bool World::checkCollision(const Math::AABB& playerAABB) const {
-    for (const auto& [chunkPos, chunk] : chunks) {
-        if (chunk.checkCollision(playerAABB)) {
-            return true;
+    PROFILE_ZONE("World::checkCollision");
+    return VoxelQuery::overlapsSolid(playerAABB, [this](const sf::Vector3i& cell) { return isSolidAt(cell); });
+}
+
+// Sweep an AABB along a displacement and return the first contact with a solid block
+Math::SweepResult World::sweepCollision(const Math::AABB& box, const sf::Vector3f& displacement) const {
+    return VoxelQuery::sweep(box, displacement, [this](const sf::Vector3i& cell) { return isSolidAt(cell); });
+}
+
+// Find the first visible block along a ray
+VoxelQuery::RaycastHit World::raycast(const sf::Vector3f& origin, const sf::Vector3f& direction, float maxDistance) const {
+    return VoxelQuery::raycast(origin, direction, maxDistance, [this](const sf::Vector2i& chunkPos) -> const ChunkStorage* {
+        const Chunk* chunk = getChunk(chunkPos);
+        return chunk ? &chunk->getStorage() : nullptr;
+    });
+}
+
+// Cast many rays at once, spread over the job system
+std::vector<VoxelQuery::RaycastHit> World::raycast(const std::vector<VoxelQuery::Ray>& rays) {
+    const std::size_t raysPerJob = 64;
+
+    std::vector<VoxelQuery::RaycastHit> hits(rays.size());
+    jobSystem.parallelFor(rays.size(), raysPerJob, [this, &rays, &hits](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            hits[i] = raycast(rays[i].origin, rays[i].direction, rays[i].maxDistance);
         }
-    }
+    });
+    return hits;
+}
 
-    return false;
+// Check if the block at a position blocks movement
+bool World::isSolidAt(const sf::Vector3i& position) const {
+    return BlockRegistry::get(getBlockTypeAt(position)).solid;
 }
 
 // Set a block at a specific world position
@@ -105,7 +223,18 @@ void World::setBlockAt(const sf::Vector3i& position, BlockType type) {
     Chunk* chunk = getChunkAt(position);  // Get the chunk for the specified position
     if (chunk) {
         // Set the block in the chunk
+        BlockType previous = chunk->getBlockTypeAt(position);
         chunk->setBlockAt({position.x, position.y, position.z}, type);
+        markBorderNeighboursChanged(position);
+        updateLight(position, previous, type);
+        return;
+    }
+
+    // Keep the edit until the chunk has been generated
+    int chunkX = (position.x < 0) ? (position.x - chunkSize + 1) / chunkSize : position.x / chunkSize;
+    int chunkZ = (position.z < 0) ? (position.z - chunkSize + 1) / chunkSize : position.z / chunkSize;
+    if (pendingChunks.count({chunkX, chunkZ})) {
+        pendingEdits[{chunkX, chunkZ}].emplace_back(position, type);
     }
 }
 
@@ -124,12 +253,27 @@ const Block* World::getBlockAt(const sf::Vector3i& position) const {
     return nullptr;
 }
 
+// Get the block type at a specific world position
+BlockType World::getBlockTypeAt(const sf::Vector3i& position) const {
+    int chunkX = (position.x < 0) ? (position.x - chunkSize + 1) / chunkSize : position.x / chunkSize;
+    int chunkZ = (position.z < 0) ? (position.z - chunkSize + 1) / chunkSize : position.z / chunkSize;
+
+    auto it = chunks.find({chunkX, chunkZ});
+    if (it != chunks.end()) {
+        return it->second.getBlockTypeAt(position);
+    }
+    return BlockType::AIR;
+}
+
 // Remove a block at a specific world position
 void World::removeBlockAt(const sf::Vector3i& position) {
     Chunk* chunk = getChunkAt(position);  // Get the chunk for the specified position
     if (chunk) {
         // Remove the block from the chunk
+        BlockType previous = chunk->getBlockTypeAt(position);
         chunk->removeBlockAt({position.x, position.y, position.z});
+        markBorderNeighboursChanged(position);
+        updateLight(position, previous, BlockType::AIR);
     }
 }
 
@@ -146,11 +290,199 @@ Chunk* World::getChunkAt(const sf::Vector3i& position) {
     return nullptr;  // Return nullptr if the chunk doesn't exist
 }
 
-// Generate a chunk at the specified world coordinates (x, z)
+// Queue the generation of a chunk at the specified world coordinates (x, z)
 void World::generateChunkAt(int x, int z) {
-    sf::Vector2i chunkPos(x / chunkSize, z / chunkSize);  // Calculate chunk grid coordinates
+    sf::Vector2i chunkPos(Math::floorDiv(x, chunkSize), Math::floorDiv(z, chunkSize));  // Calculate chunk grid coordinates
+
+    if (chunks.count(chunkPos) || !pendingChunks.insert(chunkPos).second) return;  // Already generated or queued
+
+    // The noise generator is only read, so workers can share it
+    jobSystem.submit([this, chunkPos, x, z] {
+        PROFILE_ZONE("World::generateChunkAt job");
+        Chunk chunk;
+        ChunkStorage saved;
+        if (save && save->loadChunk(chunkPos, saved)) {
+            chunk.load(x, z, std::move(saved));  // Saved chunks keep the edits made to them
+        } else {
+            chunk.generate(x, z, noiseGenerator);  // Use the global noise generator for consistent terrain
+        }
+
+        // Each job lights its chunk with its own engine, the light reaches the neighbours once it is in the world
+        LightEngine engine;
+        engine.lightChunk(chunk);
+        generatedChunks.push({chunkPos, std::move(chunk)});
+    });
+}
 
-    Chunk chunk;
-    chunk.generate(x, z, noiseGenerator);  // Use the global noise generator for consistent terrain
+// Move a generated chunk into the world
+void World::insertChunk(const sf::Vector2i& chunkPos, Chunk chunk) {
+    PROFILE_ZONE("World::insertChunk");
+    pendingChunks.erase(chunkPos);
     chunks[chunkPos] = std::move(chunk);  // Move the generated chunk into the map
+
+    // Apply the edits made while the chunk was being generated, and light it again with them
+    auto edits = pendingEdits.find(chunkPos);
+    if (edits != pendingEdits.end()) {
+        for (const auto& [position, type] : edits->second) {
+            chunks[chunkPos].setBlockAt(position, type);
+        }
+        pendingEdits.erase(edits);
+        lightEngine.lightChunk(chunks[chunkPos]);
+    }
+
+    // Light flows across the borders with the chunks already in the world
+    LightEngine::Neighbourhood neighbourhood = getNeighbourhood(chunkPos);
+    lightEngine.stitch(neighbourhood);
+    markLightChanged(neighbourhood, false);
+
+    // The neighbours can now cull the faces along their shared border
+    for (const sf::Vector2i& offset : {sf::Vector2i(-1, 0), sf::Vector2i(1, 0), sf::Vector2i(0, -1), sf::Vector2i(0, 1)}) {
+        auto it = chunks.find(chunkPos + offset);
+        if (it != chunks.end()) {
+            it->second.markChanged();
+        }
+    }
+}
+
+// Check if the chunk containing a position has been generated
+bool World::isChunkLoaded(const sf::Vector3f& position) const {
+    return chunks.count(getChunkPosition(position)) > 0;
+}
+
+// Get the chunk at chunk grid coordinates
+const Chunk* World::getChunk(const sf::Vector2i& chunkPosition) const {
+    auto it = chunks.find(chunkPosition);
+    if (it != chunks.end()) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+// Get the block storage of the four chunks around a chunk
+std::array<const ChunkStorage*, 4> World::getNeighbours(const sf::Vector2i& chunkPosition) const {
+    std::array<const ChunkStorage*, 4> neighbours{};
+    const std::array<sf::Vector2i, 4> offsets = {sf::Vector2i(-1, 0), sf::Vector2i(1, 0), sf::Vector2i(0, -1), sf::Vector2i(0, 1)};
+
+    for (int i = 0; i < 4; i++) {
+        if (const Chunk* chunk = getChunk(chunkPosition + offsets[i])) {
+            neighbours[i] = &chunk->getStorage();
+        }
+    }
+    return neighbours;
+}
+
+// Get the 3x3 chunks around a chunk
+LightEngine::Neighbourhood World::getNeighbourhood(const sf::Vector2i& chunkPosition) {
+    LightEngine::Neighbourhood neighbourhood{};
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            auto it = chunks.find(chunkPosition + sf::Vector2i(dx, dz));
+            neighbourhood[(dz + 1) * 3 + dx + 1] = it != chunks.end() ? &it->second : nullptr;
+        }
+    }
+    return neighbourhood;
+}
+
+// Update the light around a block that was replaced
+void World::updateLight(const sf::Vector3i& position, BlockType previous, BlockType type) {
+    if (previous == type || position.y < 0 || position.y >= ChunkStorage::HEIGHT) return;
+
+    sf::Vector2i chunkPos(Math::floorDiv(position.x, chunkSize), Math::floorDiv(position.z, chunkSize));
+    LightEngine::Neighbourhood neighbourhood = getNeighbourhood(chunkPos);
+    lightEngine.blockChanged(neighbourhood, position.x - chunkPos.x * chunkSize, position.y, position.z - chunkPos.y * chunkSize,
+                             previous, type);
+    markLightChanged(neighbourhood, true);
+}
+
+// Mark the sections whose light changed in the last update of the light engine
+void World::markLightChanged(const LightEngine::Neighbourhood& neighbourhood, bool edited) {
+    const std::array<std::uint32_t, 9>& changed = lightEngine.getChangedSections();
+    for (std::size_t slot = 0; slot < neighbourhood.size(); slot++) {
+        if (!neighbourhood[slot] || changed[slot] == 0) continue;
+
+        for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+            if (!(changed[slot] >> section & 1u)) continue;
+            if (edited) {
+                neighbourhood[slot]->markSectionEdited(section);  // Meshed with the edit that changed the light
+            } else {
+                neighbourhood[slot]->markSectionChanged(section);
+            }
+        }
+    }
+}
+
+// Mark the sections next to a block in the neighbouring chunks as edited when the block lies on their shared border
+void World::markBorderNeighboursChanged(const sf::Vector3i& position) {
+    if (position.y < 0 || position.y >= ChunkStorage::HEIGHT) return;
+
+    int localX = ((position.x % chunkSize) + chunkSize) % chunkSize;
+    int localZ = ((position.z % chunkSize) + chunkSize) % chunkSize;
+
+    std::vector<sf::Vector3i> offsets;
+    if (localX == 0) offsets.emplace_back(-1, 0, 0);
+    if (localX == chunkSize - 1) offsets.emplace_back(1, 0, 0);
+    if (localZ == 0) offsets.emplace_back(0, 0, -1);
+    if (localZ == chunkSize - 1) offsets.emplace_back(0, 0, 1);
+
+    for (const sf::Vector3i& offset : offsets) {
+        if (Chunk* chunk = getChunkAt(position + offset)) {
+            chunk->markSectionEdited(position.y / ChunkStorage::SECTION_HEIGHT);
+        }
+    }
+}
+
+// Get the render distance in chunks
+int World::getRenderDistance() const {
+    return renderDistance;
+}
+
+// Set the render distance in chunks
+void World::setRenderDistance(int distance) {
+    renderDistance = std::clamp(distance, 1, Config::World::MAX_RENDER_DISTANCE);
+}
+
+// Get the sky color at the current time of day
+sf::Vector3f World::getSkyColor() const {
+    return skyColor;
+}
+
+// Get the share of the sky light that reaches the ground at the current time of day
+float World::getSkyLight() const {
+    return skyLight;
+}
+
+// Get the time of day
+float World::getTimeOfDay() const {
+    return timeOfDay;
+}
+
+// Set the time of day, wrapped into 0 to 1
+void World::setTimeOfDay(float time) {
+    timeOfDay = time - std::floor(time);
+    updateSky();
+}
+
+// Follow the time of day with the sky color and the sky light: full day for most of the daytime, full night around
+// midnight, and a blend at dawn and dusk
+void World::updateSky() {
+    const float pi = 3.14159265f;
+    float daylight = std::clamp(0.5f - 1.5f * std::cos(2.0f * pi * timeOfDay), 0.0f, 1.0f);
+
+    skyColor = Config::World::NIGHT_SKY_COLOR + (Config::World::SKY_COLOR - Config::World::NIGHT_SKY_COLOR) * daylight;
+    skyLight = Config::World::NIGHT_SKY_LIGHT + (1.0f - Config::World::NIGHT_SKY_LIGHT) * daylight;
+}
+
+// Get the size of each chunk
+int World::getChunkSize() const {
+    return chunkSize;
+}
+
+// Get the seed the terrain is generated from
+unsigned int World::getSeed() const {
+    return seed;
+}
+
+// Get the job system running chunk generation
+JobSystem& World::getJobSystem() {
+    return jobSystem;
 }
\ No newline at end of file
@@ -2,65 +2,223 @@
 #define MINECRAFTCLONE_WORLD_H
 
 
+#include <array>
+#include <memory>
+#include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include "Block.h"
 #include "../Utils/Math.h"
-#include "../Player/Player.h"
+#include "../Utils/JobSystem.h"
+#include "../Utils/CompletionQueue.h"
 #include "Chunk.h"
-
-class Player;
+#include "LightEngine.h"
+#include "VoxelQuery.h"
+#include "../Save/WorldSave.h"
 
 class World {
 public:
-    // Constructor to initialize the world
+    // Constructor to initialize the world with a random seed
     World();
 
-    // Initialize the world with blocks
-    void init();
+    // Constructor to initialize the world with a fixed seed (the same seed always generates the same terrain)
+    explicit World(unsigned int seed);
+
+    // Constructor to open the world saved in a folder (a new world with a random seed if it holds none)
+    explicit World(const std::string& saveDirectory);
+
+    // Save the edited chunks before the world is destroyed
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
 
-    // Update the world (could handle block updates in the future)
-    void update(float deltaTime);
+    // Counters describing the chunk streaming around the player
+    struct StreamingStats {
+        std::size_t residentChunks = 0;     // Chunks in the world
+        std::size_t pendingRequests = 0;    // Chunks queued for generation
+        float evictionsPerSecond = 0.0f;    // Chunks unloaded over the last second
+    };
 
-    // Render all blocks in the world
-    void render(const sf::Vector3f& playerPosition) const;
+    // Initialize the world around a spawn position (chunks are generated in the background)
+    void init(const sf::Vector3f& spawnPosition);
 
-    // Check if a player AABB collides with any blocks in the world
+    // Run one simulation tick of deltaTime seconds: advance the time of day
+    void tick(float deltaTime);
+
+    // Update the world once per frame: stream chunks around the player, move chunks finished by the workers into
+    // the world within the frame budget and autosave (frameTime is the real time since the last frame)
+    void update(float frameTime, const sf::Vector3f& playerPosition);
+
+    // Check if a player AABB collides with any blocks in the world (only the cells it overlaps are looked up)
     bool checkCollision(const Math::AABB& playerAABB) const;
 
+    // Sweep an AABB along a displacement and return the time of impact and contact normal of the first solid block hit
+    [[nodiscard]] Math::SweepResult sweepCollision(const Math::AABB& box, const sf::Vector3f& displacement) const;
+
+    // Find the first visible block along a ray (the block containing the origin is skipped)
+    [[nodiscard]] VoxelQuery::RaycastHit raycast(const sf::Vector3f& origin, const sf::Vector3f& direction, float maxDistance) const;
+
+    // Cast many rays at once, spread over the job system (the world must not be modified until it returns)
+    [[nodiscard]] std::vector<VoxelQuery::RaycastHit> raycast(const std::vector<VoxelQuery::Ray>& rays);
+
     // Get the block at a specific position in the world
     [[nodiscard]] const Block* getBlockAt(const sf::Vector3i& position) const;
 
+    // Get the block type at a specific position in the world (AIR if empty or not generated)
+    [[nodiscard]] BlockType getBlockTypeAt(const sf::Vector3i& position) const;
+
     // Set a block at a specific position
     void setBlockAt(const sf::Vector3i& position, BlockType type);
 
     // Remove a block at a specific position
     void removeBlockAt(const sf::Vector3i& position);
 
+    // Check if the chunk containing a position has been generated
+    [[nodiscard]] bool isChunkLoaded(const sf::Vector3f& position) const;
+
+    // Get the chunk at chunk grid coordinates (nullptr if it is not generated)
+    [[nodiscard]] const Chunk* getChunk(const sf::Vector2i& chunkPosition) const;
+
+    // Get the block storage of the four chunks around a chunk (-X, +X, -Z, +Z), used for meshing
+    [[nodiscard]] std::array<const ChunkStorage*, 4> getNeighbours(const sf::Vector2i& chunkPosition) const;
+
+    // Queue every chunk edited since the last save to be written (does nothing without a save folder)
+    void saveChanges();
+
+    // Block until the queued chunks have been written
+    void waitForSaves();
+
+    // Get the save of the world (nullptr if it is not saved)
+    [[nodiscard]] const WorldSave* getSave() const;
+
+    // Get the chunk streaming counters
+    [[nodiscard]] StreamingStats getStreamingStats() const;
+
+    // Get the render distance in chunks
+    [[nodiscard]] int getRenderDistance() const;
+
+    // Set the render distance in chunks (clamped to 1..MAX_RENDER_DISTANCE), the load radius follows it
+    void setRenderDistance(int distance);
+
+    // Get the radius (in chunks) chunks are generated within, and the one they are evicted beyond
+    [[nodiscard]] int getLoadRadius() const;
+    [[nodiscard]] int getUnloadRadius() const;
+
+    // Get the sky color at the current time of day
+    [[nodiscard]] sf::Vector3f getSkyColor() const;
+
+    // Get the share of the sky light that reaches the ground at the current time of day (1 at day)
+    [[nodiscard]] float getSkyLight() const;
+
+    // Get the time of day, from 0 to 1 (0 = midnight, 0.5 = noon)
+    [[nodiscard]] float getTimeOfDay() const;
+
+    // Set the time of day, wrapped into 0 to 1
+    void setTimeOfDay(float time);
+
+    // Get the size of each chunk
+    [[nodiscard]] int getChunkSize() const;
+
+    // Get the seed the terrain is generated from
+    [[nodiscard]] unsigned int getSeed() const;
+
+    // Get the job system running chunk generation (and meshing for the renderer)
+    JobSystem& getJobSystem();
+
 private:
+    // Follow the time of day with the sky color and the sky light
+    void updateSky();
+
+    // Check if the block at a position blocks movement (blocks in chunks not generated yet do not)
+    [[nodiscard]] bool isSolidAt(const sf::Vector3i& position) const;
+
     // Helper function to get the chunk containing the specified position
     Chunk* getChunkAt(const sf::Vector3i& position);
 
-    // Generate a chunk at a specified world position
+    // Get the 3x3 chunks around a chunk, for the light engine
+    [[nodiscard]] LightEngine::Neighbourhood getNeighbourhood(const sf::Vector2i& chunkPosition);
+
+    // Update the light around a block that was replaced and mark the sections whose light changed as edited
+    void updateLight(const sf::Vector3i& position, BlockType previous, BlockType type);
+
+    // Mark the sections whose light changed in the last update of the light engine
+    void markLightChanged(const LightEngine::Neighbourhood& neighbourhood, bool edited);
+
+    // Mark the sections next to a block in the neighbouring chunks as edited when the block lies on their shared border
+    void markBorderNeighboursChanged(const sf::Vector3i& position);
+
+    // Queue the missing chunks inside the load radius (closest first) and evict the chunks outside the unload radius
+    void streamChunks(const sf::Vector2i& centerChunk);
+
+    // Get the chunk grid coordinates containing a world position
+    [[nodiscard]] sf::Vector2i getChunkPosition(const sf::Vector3f& position) const;
+
+    // Check if a chunk is inside a radius (in chunks) around the streaming center
+    [[nodiscard]] bool isWithinRadius(const sf::Vector2i& chunkPosition, int radius) const;
+
+    // Queue the generation of a chunk at a specified world position
     void generateChunkAt(int x, int z);
 
+    // Move a generated chunk into the world
+    void insertChunk(const sf::Vector2i& chunkPosition, Chunk chunk);
+
+    // A chunk generated by a worker, waiting to be moved into the world
+    struct GeneratedChunk {
+        sf::Vector2i position;
+        Chunk chunk;
+    };
+
     // Store chunks in the world (keyed by chunk position)
     std::unordered_map<sf::Vector2i, Chunk> chunks;
 
     // Define the render distance (how many chunks around the player are generated and rendered)
-    const int renderDistance;
+    int renderDistance;
 
-    // Define the sky color
-    const sf::Vector3f skyColor;
+    // Time of day, and the sky color and sky light that follow it. The light stored in the chunks is always the
+    // light at day, the sky light only scales it when drawing, so the time of day never changes a chunk.
+    float timeOfDay;
+    sf::Vector3f skyColor;
+    float skyLight = 1.0f;
 
     // Define the size of each chunk
     const int chunkSize;
 
+    // Seed for the Perlin noise generator (declared before the generator, which is built from it)
+    const unsigned int seed;
+
     // Perlin noise generator for terrain generation
     PerlinNoise noiseGenerator;
 
-    // Seed for the Perlin noise generator
-    const unsigned int seed;
+    // Chunks queued for generation but not in the world yet
+    std::unordered_set<sf::Vector2i> pendingChunks;
+
+    // Edits made to chunks that are still being generated, applied when they arrive
+    std::unordered_map<sf::Vector2i, std::vector<std::pair<sf::Vector3i, BlockType>>> pendingEdits;
+
+    // Incremental light updates of the chunks in the world (the workers light new chunks with their own)
+    LightEngine lightEngine;
+
+    // Chunks finished by the workers
+    CompletionQueue<GeneratedChunk> generatedChunks;
+
+    // Chunk the streaming rings are centered on (the one containing the player)
+    sf::Vector2i streamingCenter;
+
+    // Saved world on disk, if any (declared before the job system, whose jobs load chunks from it)
+    std::unique_ptr<WorldSave> save;
+
+    // Seconds since the edited chunks were last saved
+    float autosaveTimer = 0.0f;
+
+    // Evictions counted over the current one second window, and the rate of the last full window
+    int windowEvictions = 0;
+    float evictionWindow = 0.0f;
+    float evictionsPerSecond = 0.0f;
+
+    // Worker threads (declared last so they are stopped before the members their jobs use)
+    JobSystem jobSystem;
 };
 
 
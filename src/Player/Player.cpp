@@ -1,6 +1,7 @@
 #include <iostream>
 #include "Player.h"
 #include "../Config.h"
+#include "../Utils/Profiler.h"
 
 Player::Player() : position(Config::Player::POSITION),
                    pitch(Config::Player::PITCH), yaw(Config::Player::YAW), speed(Config::Player::MOVE_SPEED),
@@ -9,15 +10,21 @@ Player::Player() : position(Config::Player::POSITION),
                    sensitivity(Config::Player::SENSITIVITY), gravity(Config::Player::GRAVITY),
                    jumpVelocity(Config::Player::JUMP_VELOCITY), verticalVelocity(0.0f), maxReach(Config::Player::MAX_REACH),
                    isGrounded(false), isSprinting(false), isCrouching(false), currentBlock(BlockType::PLANKS),
-                   spaceHeld(false) {}
+                   spaceHeld(false) {
+    previousPosition = position;
+    previousCameraHeight = getCameraHeight();
+}
 
 void Player::update(float deltaTime, sf::RenderWindow& window, World& world) {
+    PROFILE_ZONE("Player::update");
+
+    // Keep the state of the previous tick for the camera interpolation
+    previousPosition = position;
+    previousCameraHeight = getCameraHeight();
+
     // Handle keyboard input for movement and jumping
     handleInput(deltaTime, world);
 
-    // Handle mouse input for looking around
-    handleMouseInput(deltaTime, window);
-
     // Handle the escape key to unlock the mouse
     handleEscape(window);
 
@@ -82,18 +89,19 @@ void Player::render(sf::RenderWindow& window) const {
     glPopMatrix();  // Restore previous modelview matrix
 }
 
-void Player::apply() const {
-    // Reset the matrix and apply the player transformations
-    glLoadIdentity();
+void Player::apply(float alpha) const {
+    // Interpolate the eye between the last two ticks, the look direction is already turned every frame
+    sf::Vector3f eye = previousPosition + (position - previousPosition) * alpha;
+    eye.y += previousCameraHeight + (getCameraHeight() - previousCameraHeight) * alpha;
 
-    // Rotate based on yaw (left/right) and pitch (up/down)
-    glRotatef(pitch, 1.0f, 0.0f, 0.0f);  // Looking up/down
-    glRotatef(yaw, 0.0f, 1.0f, 0.0f);    // Looking left/right
+    // Replace the matrix with the camera: rotated by yaw (left/right) and pitch (up/down), moved to the player
+    Math::Matrix4 view = Math::viewMatrix(eye, yaw, pitch);
+    glLoadMatrixf(view.data());
+}
 
-    // Move the player to its position
+float Player::getCameraHeight() const {
     // Adjust camera height based on whether the player is crouching
-    float cameraHeight = isCrouching ? crouchHeight : normalHeight - 0.1f;
-    glTranslatef(-position.x, -(position.y + cameraHeight), -position.z);
+    return isCrouching ? crouchHeight : normalHeight - 0.1f;
 }
 
 void Player::handleInput(float deltaTime, World& world) {
@@ -263,12 +271,14 @@ void Player::handleBlockChange(float deltaTime, World& world) {
         currentBlock = BlockType::PLANKS;
     } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num5)) {
         currentBlock = BlockType::WATER;
+    } else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Num6)) {
+        currentBlock = BlockType::LIT_FURNACE;
     } else if (sf::Mouse::isButtonPressed(sf::Mouse::Middle)) {
         currentBlock = getLookingBlock(world);
     }
 }
 
-void Player::handleMouseInput(float deltaTime, sf::RenderWindow& window) {
+void Player::handleMouseInput(sf::RenderWindow& window) {
     if (!isMouseLocked) return;
 
     // Get the center of the window
@@ -327,10 +337,12 @@ sf::Vector3f Player::getPosition() const {
 
 void Player::setPosition(const sf::Vector3f& position) {
     this->position = position;
+    previousPosition = position;  // Teleport without interpolating across the jump
 }
 
 void Player::updateVerticalMovement(float deltaTime, World& world) {
     if (isFlying) return;  // Skip gravity/jumping logic when flying
+    if (!world.isChunkLoaded(position)) return;  // Wait for the ground to be generated before falling
 
     if (!isGrounded || verticalVelocity != 0) {
         verticalVelocity -= gravity * deltaTime;
@@ -344,6 +356,12 @@ void Player::updateVerticalMovement(float deltaTime, World& world) {
             position.y = newPosition.y;
             isGrounded = false;
         } else {
+            // Move up to the contact so the player lands on (or bumps into) the block instead of stopping short of it
+            Math::SweepResult sweep = world.sweepCollision(getAABB(), {0.0f, verticalVelocity * deltaTime, 0.0f});
+            if (sweep.hit) {
+                position.y += verticalVelocity * deltaTime * sweep.time + sweep.normal.y * VoxelQuery::CONTACT_GAP;
+            }
+
             if (verticalVelocity > 0) {
                 verticalVelocity = 0.0f;
             } else {
@@ -435,7 +453,7 @@ void Player::placeBlock(World& world, BlockType blockType) const {
     }
 }
 
-std::tuple<sf::Vector3i, sf::Vector3f, sf::Vector3f> Player::raycast(World& world) const {
+std::tuple<sf::Vector3i, sf::Vector3f, sf::Vector3f> Player::raycast(const World& world) const {
     sf::Vector3f rayOrigin = position;
     rayOrigin.y += isCrouching ? Config::Player::CROUCH_HEIGHT : Config::Player::NORMAL_HEIGHT;
     rayOrigin.y -= 0.1f;  // Adjust the ray origin to start at eye level
@@ -443,73 +461,12 @@ std::tuple<sf::Vector3i, sf::Vector3f, sf::Vector3f> Player::raycast(World& worl
     sf::Vector3f rayDirection = getLookDirection();
     rayDirection /= std::sqrt(rayDirection.x * rayDirection.x + rayDirection.y * rayDirection.y + rayDirection.z * rayDirection.z);  // Normalize the direction vector
 
-    // Initialize the block position (in global block coordinates)
-    sf::Vector3i blockPos(std::floor(rayOrigin.x), std::floor(rayOrigin.y), std::floor(rayOrigin.z));
-
-    // Step values for stepping through the grid in the x, y, and z directions
-    sf::Vector3f tMax, tDelta, step;
-
-    // X-axis stepping
-    if (rayDirection.x > 0) {
-        step.x = 1;
-        tMax.x = (blockPos.x + 1 - rayOrigin.x) / rayDirection.x;
-        tDelta.x = 1.0f / rayDirection.x;
-    } else {
-        step.x = -1;
-        tMax.x = (rayOrigin.x - blockPos.x) / -rayDirection.x;
-        tDelta.x = 1.0f / -rayDirection.x;
-    }
-
-    // Y-axis stepping
-    if (rayDirection.y > 0) {
-        step.y = 1;
-        tMax.y = (blockPos.y + 1 - rayOrigin.y) / rayDirection.y;
-        tDelta.y = 1.0f / rayDirection.y;
-    } else {
-        step.y = -1;
-        tMax.y = (rayOrigin.y - blockPos.y) / -rayDirection.y;
-        tDelta.y = 1.0f / -rayDirection.y;
-    }
-
-    // Z-axis stepping
-    if (rayDirection.z > 0) {
-        step.z = 1;
-        tMax.z = (blockPos.z + 1 - rayOrigin.z) / rayDirection.z;
-        tDelta.z = 1.0f / rayDirection.z;
-    } else {
-        step.z = -1;
-        tMax.z = (rayOrigin.z - blockPos.z) / -rayDirection.z;
-        tDelta.z = 1.0f / -rayDirection.z;
-    }
-
-    // Traverse the grid to find the first block hit or exceed max distance
-    for (float distance = 0.0f; distance < maxReach; ) {
-        sf::Vector3f hitNormal(0.0f, 0.0f, 0.0f);
-
-        if (tMax.x < tMax.y && tMax.x < tMax.z) {
-            blockPos.x += step.x;
-            distance = tMax.x;
-            tMax.x += tDelta.x;
-            hitNormal = { -step.x, 0.0f, 0.0f };
-        } else if (tMax.y < tMax.z) {
-            blockPos.y += step.y;
-            distance = tMax.y;
-            tMax.y += tDelta.y;
-            hitNormal = { 0.0f, -step.y, 0.0f };
-        } else {
-            blockPos.z += step.z;
-            distance = tMax.z;
-            tMax.z += tDelta.z;
-            hitNormal = { 0.0f, 0.0f, -step.z };
-        }
-
-        // Check if the block at the current block position is solid (or visible)
-        if (const Block* block = world.getBlockAt(blockPos)) {
-            if (block->checkIfVisible()) {
-                sf::Vector3f hitPoint = rayOrigin + rayDirection * distance;
-                return { blockPos, hitPoint, hitNormal };  // Return the block hit and hit details
-            }
-        }
+    // Step through the blocks along the view ray to find the first visible one
+    VoxelQuery::RaycastHit hit = world.raycast(rayOrigin, rayDirection, maxReach);
+    if (hit.hit) {
+        sf::Vector3f hitPoint = rayOrigin + rayDirection * hit.distance;
+        sf::Vector3f hitNormal(static_cast<float>(hit.normal.x), static_cast<float>(hit.normal.y), static_cast<float>(hit.normal.z));
+        return { hit.block, hitPoint, hitNormal };  // Return the block hit and hit details
     }
 
     // No block hit within the max distance
@@ -521,9 +478,10 @@ BlockType Player::getLookingBlock(World& world) const {
     auto [blockPos, hitPoint, hitNormal] = raycast(world);  // Assume max reach distance is 5 units
 
     if (blockPos != sf::Vector3i(-1000, -1000, -1000)) {
-        // Get the block at the position returned by the raycast
-        if (const Block* block = world.getBlockAt(blockPos)) {
-            return block->getType();
+        // Get the block type at the position returned by the raycast
+        BlockType type = world.getBlockTypeAt(blockPos);
+        if (BlockRegistry::get(type).visible) {
+            return type;
         }
     }
     return BlockType::DIRT;
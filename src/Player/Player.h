@@ -12,9 +12,10 @@ class Player {
 public:
     Player();
 
-    void update(float deltaTime, sf::RenderWindow& window, World& world);
+    void update(float deltaTime, sf::RenderWindow& window, World& world);  // Run one simulation tick
     void render(sf::RenderWindow& window) const;
-    void apply() const;
+    void apply(float alpha) const;  // Apply the camera, its eye interpolated between the last two ticks (alpha 0 = previous, 1 = last)
+    void handleMouseInput(sf::RenderWindow& window);  // Turn the camera by the mouse movement (every frame, not every tick)
     void lockMouse(sf::RenderWindow& window);
     void unlockMouse(sf::RenderWindow& window);
     void handleEscape(sf::RenderWindow& window);
@@ -34,7 +35,7 @@ public:
 
     [[nodiscard]] Math::AABB getAABB() const;
 
-    std::tuple<sf::Vector3i, sf::Vector3f, sf::Vector3f> raycast(World& world) const;  // Raycast from the player's position to find the first block hit
+    std::tuple<sf::Vector3i, sf::Vector3f, sf::Vector3f> raycast(const World& world) const;  // Raycast from the player's position to find the first block hit
 
     void breakBlock(World& world) const;                            // Break a block at the player's position
     void placeBlock(World& world, BlockType blockType) const;       // Place a block at the player's position
@@ -44,6 +45,10 @@ private:
     sf::Vector3f position;
     float pitch, yaw;
 
+    // Camera state at the start of the last tick, for the interpolation between ticks
+    sf::Vector3f previousPosition;
+    float previousCameraHeight;
+
     float speed;
     const float sprintSpeed;
     const float crouchSpeed;
@@ -76,11 +81,12 @@ private:
     bool spacePressedOnce = false;  // Track if space was pressed once
 
     void handleInput(float deltaTime, World& world);                     // Handle player input
-    void handleMouseInput(float deltaTime, sf::RenderWindow& window);    // Handle mouse input
     void handleBlockChange(float deltaTime, World& world);                             // Handle block change
 
     void updateVerticalMovement(float deltaTime, World& world);          // Update vertical movement
     void toggleFlying();                                                 // Toggle flying mode
+
+    [[nodiscard]] float getCameraHeight() const;                         // Height of the camera above the feet
 };
 
 #endif
@@ -0,0 +1,53 @@
+#include <utility>
+#include "ChunkMesh.h"
+
+ChunkMesh::ChunkMesh() = default;
+
+ChunkMesh::~ChunkMesh() {
+    release();
+}
+
+ChunkMesh::ChunkMesh(ChunkMesh&& other) noexcept
+        : arena(std::exchange(other.arena, nullptr)), allocations(std::exchange(other.allocations, {})) {}
+
+ChunkMesh& ChunkMesh::operator=(ChunkMesh&& other) noexcept {
+    if (this != &other) {
+        release();
+        arena = std::exchange(other.arena, nullptr);
+        allocations = std::exchange(other.allocations, {});
+    }
+    return *this;
+}
+
+// Upload the mesh data of a chunk into the arena through the uploader
+void ChunkMesh::upload(const ChunkMeshData& data, const sf::Vector2i& chunkPosition, MeshArena& meshArena, MeshUploader& uploader) {
+    release();
+    arena = &meshArena;
+
+    for (int layer = 0; layer < BlockRegistry::LAYER_COUNT; layer++) {
+        allocations[layer] = arena->upload(data.layers[layer], chunkPosition, uploader);
+    }
+}
+
+// Get the allocation of one render layer
+const MeshArena::Allocation& ChunkMesh::getAllocation(BlockRegistry::Layer layer) const {
+    return allocations[layer];
+}
+
+// Check if the mesh has nothing to draw in any layer
+bool ChunkMesh::isEmpty() const {
+    for (const MeshArena::Allocation& allocation : allocations) {
+        if (allocation.indexCount > 0) return false;
+    }
+    return true;
+}
+
+// Free the allocations
+void ChunkMesh::release() {
+    if (arena) {
+        for (const MeshArena::Allocation& allocation : allocations) arena->free(allocation);
+    }
+
+    arena = nullptr;
+    allocations = {};
+}
@@ -0,0 +1,38 @@
+#ifndef MINECRAFTCLONE_CHUNKMESH_H
+#define MINECRAFTCLONE_CHUNKMESH_H
+
+
+#include <array>
+#include "MeshArena.h"
+#include "../Core/ChunkMesher.h"
+
+// GPU copy of a chunk mesh: one allocation in the mesh arena per render layer
+class ChunkMesh {
+public:
+    ChunkMesh();
+    ~ChunkMesh();
+
+    ChunkMesh(const ChunkMesh&) = delete;
+    ChunkMesh& operator=(const ChunkMesh&) = delete;
+    ChunkMesh(ChunkMesh&& other) noexcept;
+    ChunkMesh& operator=(ChunkMesh&& other) noexcept;
+
+    // Upload the mesh data of a chunk into the arena through the uploader (replacing the previous contents)
+    void upload(const ChunkMeshData& data, const sf::Vector2i& chunkPosition, MeshArena& arena, MeshUploader& uploader);
+
+    // Get the allocation of one render layer (its index count is 0 if the layer has nothing to draw)
+    [[nodiscard]] const MeshArena::Allocation& getAllocation(BlockRegistry::Layer layer) const;
+
+    // Check if the mesh has nothing to draw in any layer
+    [[nodiscard]] bool isEmpty() const;
+
+private:
+    MeshArena* arena = nullptr;  // Arena holding the allocations (nullptr until the first upload)
+    std::array<MeshArena::Allocation, BlockRegistry::LAYER_COUNT> allocations{};
+
+    // Free the allocations
+    void release();
+};
+
+
+#endif
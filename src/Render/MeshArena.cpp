@@ -0,0 +1,185 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include "MeshArena.h"
+#include "../Config.h"
+
+MeshArena::MeshArena()
+        : vertexAllocator(Config::World::MESH_ARENA_VERTICES, PAGE_VERTICES), indexAllocator(Config::World::MESH_ARENA_INDICES) {
+    resizePageTable();
+}
+
+MeshArena::~MeshArena() {
+    if (vertexBuffer != 0) glDeleteBuffers(1, &vertexBuffer);
+    if (indexBuffer != 0) glDeleteBuffers(1, &indexBuffer);
+    if (pageTable != 0) glDeleteTextures(1, &pageTable);
+}
+
+// Allocate one render layer of the mesh of a chunk and upload it through the uploader
+MeshArena::Allocation MeshArena::upload(const MeshData& mesh, const sf::Vector2i& chunkPosition, MeshUploader& uploader) {
+    Allocation allocation;
+    if (mesh.indices.empty()) return allocation;
+
+    allocation.vertices = allocate(vertexAllocator, vertexBuffer, sizeof(ChunkVertex), mesh.vertices.size());
+    allocation.indices = allocate(indexAllocator, indexBuffer, sizeof(MeshData::Index), mesh.indices.size());
+    allocation.indexCount = static_cast<int>(mesh.indices.size());
+
+    if (allocationChunks.size() <= allocation.vertices) allocationChunks.resize(allocation.vertices + 1);
+    allocationChunks[allocation.vertices] = chunkPosition;
+    setPages(allocation.vertices, chunkPosition);
+
+    uploader.write(vertexBuffer, vertexAllocator.getOffset(allocation.vertices) * sizeof(ChunkVertex), mesh.vertices.data(),
+                   mesh.vertices.size() * sizeof(ChunkVertex));
+    uploader.write(indexBuffer, indexAllocator.getOffset(allocation.indices) * sizeof(MeshData::Index), mesh.indices.data(),
+                   mesh.indices.size() * sizeof(MeshData::Index));
+    return allocation;
+}
+
+// Free the ranges of a layer
+void MeshArena::free(const Allocation& allocation) {
+    if (allocation.indexCount == 0) return;
+    vertexAllocator.free(allocation.vertices);
+    indexAllocator.free(allocation.indices);
+}
+
+// Get the offset in bytes of the indices of a layer
+std::size_t MeshArena::getIndexOffset(const Allocation& allocation) const {
+    return indexAllocator.getOffset(allocation.indices) * sizeof(MeshData::Index);
+}
+
+// Get the first vertex of a layer
+int MeshArena::getBaseVertex(const Allocation& allocation) const {
+    return static_cast<int>(vertexAllocator.getOffset(allocation.vertices));
+}
+
+// Bind the buffers, the vertex attribute and the page table
+void MeshArena::bind(unsigned int vertexAttribute, int textureUnit) {
+    if (vertexBuffer == 0) return;
+
+    // Upload the rows of the page table changed since the last frame (all of them after a growth)
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    if (pageTable == 0) {
+        glGenTextures(1, &pageTable);
+        glBindTexture(GL_TEXTURE_2D, pageTable);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+    glBindTexture(GL_TEXTURE_2D, pageTable);
+
+    auto rows = static_cast<GLsizei>(pages.size() / 2 / PAGE_TABLE_WIDTH);
+    if (pageTableResized) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32I, static_cast<GLsizei>(PAGE_TABLE_WIDTH), rows, 0, GL_RG_INTEGER, GL_INT,
+                     pages.data());
+        pageTableResized = false;
+    } else if (dirtyRowBegin < dirtyRowEnd) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(dirtyRowBegin), static_cast<GLsizei>(PAGE_TABLE_WIDTH),
+                        static_cast<GLsizei>(dirtyRowEnd - dirtyRowBegin), GL_RG_INTEGER, GL_INT,
+                        pages.data() + dirtyRowBegin * PAGE_TABLE_WIDTH * 2);
+    }
+    dirtyRowBegin = dirtyRowEnd = 0;
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribIPointer(vertexAttribute, 2, GL_UNSIGNED_INT, sizeof(ChunkVertex), nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+}
+
+// Get the arena counters
+MeshArena::Stats MeshArena::getStats() const {
+    Stats stats;
+    stats.vertexCapacity = vertexAllocator.getCapacity();
+    stats.vertexUsed = vertexAllocator.getUsed();
+    stats.indexCapacity = indexAllocator.getCapacity();
+    stats.indexUsed = indexAllocator.getUsed();
+    stats.vertexFragmentation = vertexAllocator.getFragmentation();
+    stats.indexFragmentation = indexAllocator.getFragmentation();
+    stats.compactions = compactions;
+    stats.growths = growths;
+    return stats;
+}
+
+// Allocate count elements, compacting or growing the arena when they do not fit
+ArenaAllocator::Handle MeshArena::allocate(ArenaAllocator& allocator, unsigned int& buffer, std::size_t elementSize,
+                                          std::size_t count) {
+    if (buffer == 0) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(allocator.getCapacity() * elementSize), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    std::optional<ArenaAllocator::Handle> handle = allocator.allocate(count);
+    if (handle) return *handle;
+
+    // Gather the free space when there is enough of it, grow the arena otherwise (or if that was still not enough)
+    std::size_t previousCapacity = allocator.getCapacity();
+    std::vector<ArenaAllocator::Move> moves;
+    if (allocator.getCapacity() - allocator.getUsed() >= count) {
+        moves = allocator.compact();
+        compactions++;
+        handle = allocator.allocate(count);
+    }
+    if (!handle) {
+        allocator.grow(std::max(2 * previousCapacity, allocator.getUsed() + 2 * count));
+        growths++;
+        handle = allocator.allocate(count);
+    }
+    relocate(allocator, buffer, elementSize, previousCapacity, moves);
+
+    // The pages follow the vertices: a larger table, and the moved allocations written at their new place
+    if (&allocator == &vertexAllocator) {
+        resizePageTable();
+        for (const ArenaAllocator::Move& move : moves) setPages(move.handle, allocationChunks[move.handle]);
+    }
+    return *handle;
+}
+
+// Move a GL buffer into a new one of the allocator's capacity
+void MeshArena::relocate(const ArenaAllocator& allocator, unsigned int& buffer, std::size_t elementSize,
+                         std::size_t previousCapacity, const std::vector<ArenaAllocator::Move>& moves) {
+    unsigned int relocated = 0;
+    glGenBuffers(1, &relocated);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, relocated);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(allocator.getCapacity() * elementSize), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+
+    // Everything at the same offset first, then the moved allocations over it at their new offsets
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(previousCapacity * elementSize));
+    for (const ArenaAllocator::Move& move : moves) {
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(move.from * elementSize),
+                            static_cast<GLintptr>(move.to * elementSize), static_cast<GLsizeiptr>(move.size * elementSize));
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    buffer = relocated;
+}
+
+// Size the page table for the capacity of the vertex arena
+void MeshArena::resizePageTable() {
+    std::size_t rows = (vertexAllocator.getCapacity() / PAGE_VERTICES + PAGE_TABLE_WIDTH - 1) / PAGE_TABLE_WIDTH;
+    if (rows * PAGE_TABLE_WIDTH * 2 == pages.size()) return;
+
+    pages.resize(rows * PAGE_TABLE_WIDTH * 2, 0);
+    pageTableResized = true;
+}
+
+// Write the chunk of a vertex allocation into the pages it covers
+void MeshArena::setPages(ArenaAllocator::Handle handle, const sf::Vector2i& chunkPosition) {
+    std::size_t first = vertexAllocator.getOffset(handle) / PAGE_VERTICES;
+    std::size_t end = first + vertexAllocator.getSize(handle) / PAGE_VERTICES;
+    for (std::size_t page = first; page < end; page++) {
+        pages[page * 2] = chunkPosition.x;
+        pages[page * 2 + 1] = chunkPosition.y;
+    }
+
+    std::size_t rowBegin = first / PAGE_TABLE_WIDTH;
+    std::size_t rowEnd = (end + PAGE_TABLE_WIDTH - 1) / PAGE_TABLE_WIDTH;
+    if (dirtyRowBegin == dirtyRowEnd) {
+        dirtyRowBegin = rowBegin;
+        dirtyRowEnd = rowEnd;
+    } else {
+        dirtyRowBegin = std::min(dirtyRowBegin, rowBegin);
+        dirtyRowEnd = std::max(dirtyRowEnd, rowEnd);
+    }
+}
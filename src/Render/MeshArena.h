@@ -0,0 +1,98 @@
+#ifndef MINECRAFTCLONE_MESHARENA_H
+#define MINECRAFTCLONE_MESHARENA_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "MeshUploader.h"
+#include "../Core/ChunkMesher.h"
+#include "../Utils/ArenaAllocator.h"
+
+// Every chunk section mesh in one vertex buffer and one index buffer, suballocated with ArenaAllocator, so
+// one render layer of all the visible sections is drawn by a single glMultiDrawElementsBaseVertex.
+// Vertices stay local to their chunk: the vertex buffer is split in pages of PAGE_VERTICES vertices, every
+// vertex allocation starts on a page and a page table texture holds the chunk of each page, which the
+// shader finds from gl_VertexID (it includes the base vertex of the draw). An allocation that does not
+// fit compacts the arena when its free space is enough once gathered and grows it otherwise; both copy
+// the buffer into a new one on the GPU.
+class MeshArena {
+public:
+    static constexpr std::size_t PAGE_VERTICES = 16;
+    static constexpr std::size_t PAGE_TABLE_WIDTH = 1024;  // Pages per row of the page table texture
+
+    // Counters of the arena
+    struct Stats {
+        std::size_t vertexCapacity = 0;  // In vertices
+        std::size_t vertexUsed = 0;
+        std::size_t indexCapacity = 0;   // In indices
+        std::size_t indexUsed = 0;
+        float vertexFragmentation = 0.0f;
+        float indexFragmentation = 0.0f;
+        std::uint64_t compactions = 0;
+        std::uint64_t growths = 0;
+    };
+
+    // Ranges of one render layer of a mesh in the arena
+    struct Allocation {
+        ArenaAllocator::Handle vertices = 0;
+        ArenaAllocator::Handle indices = 0;
+        int indexCount = 0;  // 0 when nothing is allocated
+    };
+
+    MeshArena();
+    ~MeshArena();
+
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    // Allocate one render layer of the mesh of a chunk and upload it through the uploader
+    Allocation upload(const MeshData& mesh, const sf::Vector2i& chunkPosition, MeshUploader& uploader);
+
+    // Free the ranges of a layer
+    void free(const Allocation& allocation);
+
+    // Get the offset in bytes of the indices of a layer in the index buffer
+    [[nodiscard]] std::size_t getIndexOffset(const Allocation& allocation) const;
+
+    // Get the first vertex of a layer in the vertex buffer (its indices start from 0)
+    [[nodiscard]] int getBaseVertex(const Allocation& allocation) const;
+
+    // Bind the buffers, point a vertex attribute at the packed vertices and bind the page table to a texture unit
+    // (nothing is bound before the first upload)
+    void bind(unsigned int vertexAttribute, int textureUnit);
+
+    // Get the arena counters
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    ArenaAllocator vertexAllocator;
+    ArenaAllocator indexAllocator;
+    unsigned int vertexBuffer = 0;  // GL names (0 until the first upload)
+    unsigned int indexBuffer = 0;
+    unsigned int pageTable = 0;
+
+    std::vector<std::int32_t> pages;                 // Chunk x and z of every page, the page table texels
+    std::vector<sf::Vector2i> allocationChunks;      // Chunk of every vertex allocation, by handle
+    std::size_t dirtyRowBegin = 0, dirtyRowEnd = 0;  // Rows of the page table changed since the last bind
+    bool pageTableResized = true;
+    std::uint64_t compactions = 0;
+    std::uint64_t growths = 0;
+
+    // Allocate count elements, compacting or growing the arena and its GL buffer when they do not fit
+    ArenaAllocator::Handle allocate(ArenaAllocator& allocator, unsigned int& buffer, std::size_t elementSize, std::size_t count);
+
+    // Move a GL buffer into a new one of the allocator's capacity: same offsets, except the allocations moved
+    static void relocate(const ArenaAllocator& allocator, unsigned int& buffer, std::size_t elementSize,
+                         std::size_t previousCapacity, const std::vector<ArenaAllocator::Move>& moves);
+
+    // Size the page table for the capacity of the vertex arena
+    void resizePageTable();
+
+    // Write the chunk of a vertex allocation into the pages it covers
+    void setPages(ArenaAllocator::Handle handle, const sf::Vector2i& chunkPosition);
+};
+
+
+#endif
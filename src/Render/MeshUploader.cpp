@@ -0,0 +1,120 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "MeshUploader.h"
+#include "../Config.h"
+
+MeshUploader::MeshUploader() : ring(Config::World::UPLOAD_RING_SIZE) {}
+
+MeshUploader::~MeshUploader() {
+    for (const PendingFence& pending : fences) {
+        glDeleteSync(static_cast<GLsync>(pending.sync));
+    }
+    if (ringBuffer != 0) glDeleteBuffers(1, &ringBuffer);
+}
+
+// Copy size bytes of data into a GL buffer at an offset
+void MeshUploader::write(unsigned int buffer, std::size_t offset, const void* data, std::size_t size) {
+    if (size == 0) return;
+    frameBytes += size;
+
+    // Larger than the whole ring: handed to the driver directly
+    if (size > ring.getCapacity()) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return;
+    }
+
+    if (ringBuffer == 0) {
+        glGenBuffers(1, &ringBuffer);
+        glBindBuffer(GL_COPY_READ_BUFFER, ringBuffer);
+        glBufferData(GL_COPY_READ_BUFFER, static_cast<GLsizeiptr>(ring.getCapacity()), nullptr, GL_STREAM_DRAW);
+    }
+
+    // A full ring waits for the GPU to copy its oldest data out, fencing this frame's writes first if they filled it
+    std::optional<std::size_t> staging = ring.allocate(size);
+    if (!staging) {
+        auto start = std::chrono::steady_clock::now();
+        while (!staging) {
+            if (fences.empty()) fence();
+            waitOldest();
+            staging = ring.allocate(size);
+        }
+        frameStall += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        stats.stalls++;
+    }
+
+    // The range is not read by any pending GPU command, no synchronization is needed to write it
+    glBindBuffer(GL_COPY_READ_BUFFER, ringBuffer);
+    void* mapped = glMapBufferRange(GL_COPY_READ_BUFFER, static_cast<GLintptr>(*staging), static_cast<GLsizeiptr>(size),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (mapped) {
+        std::memcpy(mapped, data, size);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(*staging),
+                            static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size), data);
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+// Check if the writes of this frame are still within the budget
+bool MeshUploader::hasBudget() const {
+    return frameBytes < Config::World::UPLOAD_BYTES_PER_FRAME;
+}
+
+// Fence the writes of the frame and free the ring space of the fences the GPU has passed
+void MeshUploader::endFrame() {
+    if (ringBuffer != 0) fence();
+    retireSignalled();
+
+    stats.bytesLastFrame = frameBytes;
+    stats.stallLastFrame = frameStall;
+    stats.maxStall = std::max(stats.maxStall, frameStall);
+    stats.ringUsed = ring.getUsed();
+    frameBytes = 0;
+    frameStall = 0.0f;
+}
+
+// Get the upload counters
+MeshUploader::Stats MeshUploader::getStats() const {
+    return stats;
+}
+
+// Fence the writes made since the last fence
+void MeshUploader::fence() {
+    fences.push_back({ring.fence(), glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+}
+
+// Wait for the oldest fence and free its ring space
+void MeshUploader::waitOldest() {
+    PendingFence pending = fences.front();
+    fences.pop_front();
+
+    // Flush so the fence is sure to be reached, then wait as long as it takes
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(static_cast<GLsync>(pending.sync), flags, 1000000) == GL_TIMEOUT_EXPIRED) flags = 0;
+
+    glDeleteSync(static_cast<GLsync>(pending.sync));
+    ring.retire(pending.token);
+}
+
+// Free the ring space of the fences the GPU has passed, without waiting
+void MeshUploader::retireSignalled() {
+    while (!fences.empty()) {
+        GLenum status = glClientWaitSync(static_cast<GLsync>(fences.front().sync), 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+        glDeleteSync(static_cast<GLsync>(fences.front().sync));
+        ring.retire(fences.front().token);
+        fences.pop_front();
+    }
+}
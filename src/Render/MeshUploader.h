@@ -0,0 +1,70 @@
+#ifndef MINECRAFTCLONE_MESHUPLOADER_H
+#define MINECRAFTCLONE_MESHUPLOADER_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include "../Utils/RingAllocator.h"
+
+// Streams mesh data into GL buffers through one large staging buffer used as a ring (see RingAllocator).
+// A write is copied into an unsynchronized mapped range of the ring and then copied by the GPU into its
+// destination buffer, so neither the driver nor the CPU waits on buffers still read by earlier frames.
+// The writes of a frame are closed with a fence, and their ring space is reused once the GPU has passed
+// it. Only when the ring is full of data the GPU has not copied yet does a write wait (a stall).
+class MeshUploader {
+public:
+    // Counters of the uploads
+    struct Stats {
+        std::size_t bytesLastFrame = 0;  // Bytes written in the last frame
+        float stallLastFrame = 0.0f;     // Milliseconds waited on fences in the last frame
+        float maxStall = 0.0f;           // Worst frame so far
+        std::uint64_t stalls = 0;        // Writes that had to wait for the GPU
+        std::size_t ringUsed = 0;        // Bytes of the ring the GPU may still read
+    };
+
+    MeshUploader();
+    ~MeshUploader();
+
+    MeshUploader(const MeshUploader&) = delete;
+    MeshUploader& operator=(const MeshUploader&) = delete;
+
+    // Copy size bytes of data into a GL buffer at an offset in bytes (the buffer must already hold the range)
+    void write(unsigned int buffer, std::size_t offset, const void* data, std::size_t size);
+
+    // Check if the writes of this frame are still within the budget of Config::World
+    [[nodiscard]] bool hasBudget() const;
+
+    // Fence the writes of the frame and free the ring space of the fences the GPU has passed
+    void endFrame();
+
+    // Get the upload counters
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    // Fence of the ring allocator and the GL fence (a GLsync) signalled when the GPU reaches it
+    struct PendingFence {
+        std::uint64_t token;
+        void* sync;
+    };
+
+    RingAllocator ring;
+    unsigned int ringBuffer = 0;  // GL buffer name (0 until the first write)
+    std::deque<PendingFence> fences;
+
+    std::size_t frameBytes = 0;
+    float frameStall = 0.0f;
+    Stats stats;
+
+    // Fence the writes made since the last fence
+    void fence();
+
+    // Wait for the oldest fence and free its ring space
+    void waitOldest();
+
+    // Free the ring space of the fences the GPU has passed, without waiting
+    void retireSignalled();
+};
+
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef MINECRAFTCLONE_PROJECTION_H
+#define MINECRAFTCLONE_PROJECTION_H
+
+
+#include <SFML/OpenGL.hpp>
+#include "../Utils/Math.h"
+
+namespace Projection {
+    // Custom gluPerspective function (the matrix is built by Math so the frustum culling sees the same one)
+    inline void setPerspectiveMatrix(float fov, float aspectRatio, float nearPlane, float farPlane) {
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(Math::perspectiveMatrix(fov, aspectRatio, nearPlane, farPlane).data());
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+    }
+}
+
+
+#endif
@@ -0,0 +1,495 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "WorldRenderer.h"
+#include "../Config.h"
+#include "../Utils/Profiler.h"
+#include "../Utils/Texture.h"
+
+namespace {
+    // Texture unit of the page table of the mesh arena (the atlas is on unit 0)
+    const int PAGE_TABLE_UNIT = 1;
+
+    // Unpacks the vertices of ChunkVertex: the shifts and masks follow its bit layout. The chunk of a vertex
+    // comes from the page table of MeshArena (PAGE_VERTICES vertices per page, PAGE_TABLE_WIDTH pages per row,
+    // defined by shaderSource). Each light level is 80% as bright as the one above it, and ambient occlusion
+    // darkens a fully occluded corner to half. The sky light of the vertices is the light at day, scaled by the
+    // time of day through skyLight.
+    const char* VERTEX_SHADER = R"(
+        uniform isampler2D pageTable;
+        uniform float skyLight;
+
+        in uvec2 packedVertex;
+
+        out vec3 texCoord;
+
+        void main() {
+            uint position = packedVertex.x;
+            vec3 local = vec3(float(position & 31u), float((position >> 5u) & 511u), float((position >> 14u) & 31u));
+            float tile = float((position >> 22u) & 255u);
+            texCoord = vec3(float(packedVertex.y & 511u), float((packedVertex.y >> 9u) & 511u), tile);
+
+            float ao = float((packedVertex.y >> 18u) & 3u);
+            float sky = float((packedVertex.y >> 20u) & 15u);
+            float block = float((packedVertex.y >> 24u) & 15u);
+            float shade = max(pow(0.8, 15.0 - max(sky * skyLight, block)), 0.05) * (0.5 + ao / 6.0);
+
+            int page = gl_VertexID / PAGE_VERTICES;
+            ivec2 chunk = texelFetch(pageTable, ivec2(page % PAGE_TABLE_WIDTH, page / PAGE_TABLE_WIDTH), 0).xy;
+            vec3 world = local + vec3(float(chunk.x * CHUNK_SIZE), 0.0, float(chunk.y * CHUNK_SIZE));
+
+            gl_Position = gl_ModelViewProjectionMatrix * vec4(world, 1.0);
+            gl_FrontColor = vec4(gl_Color.rgb * shade, gl_Color.a);
+        }
+    )";
+
+    const char* FRAGMENT_SHADER = R"(
+        uniform sampler2D atlas;
+        uniform float alphaCutoff;
+
+        in vec3 texCoord;
+
+        void main() {
+            // Repeat the tile across merged faces: texCoord.xy is in blocks, texCoord.z is the tile index
+            float tile = floor(texCoord.z + 0.5);
+            vec2 origin = vec2(mod(tile, 16.0), floor(tile / 16.0));
+            vec4 color = texture(atlas, (origin + fract(texCoord.xy)) / 16.0) * gl_Color;
+
+            if (color.a < alphaCutoff) discard;
+            gl_FragColor = color;
+        }
+    )";
+
+    // Put the version and the layout constants shared with the C++ side in front of a shader
+    std::string shaderSource(const char* body) {
+        return "#version 130\n"
+               "#define PAGE_VERTICES " + std::to_string(MeshArena::PAGE_VERTICES) + "\n"
+               "#define PAGE_TABLE_WIDTH " + std::to_string(MeshArena::PAGE_TABLE_WIDTH) + "\n"
+               "#define CHUNK_SIZE " + std::to_string(ChunkStorage::SIZE) + "\n" + body;
+    }
+
+    // Stop the game when the renderer cannot run on this GL context
+    [[noreturn]] void fail(const char* reason) {
+        std::fprintf(stderr, "Cannot render the world: %s\n", reason);
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+WorldRenderer::WorldRenderer(JobSystem& jobSystem)
+        : jobSystem(jobSystem), finishedMeshes(std::make_shared<CompletionQueue<MeshResult>>()) {
+    // Load the GL entry points for buffer objects (once per process). The renderer targets GL 3.3, the
+    // version Game requests (what it uses, base vertex multi-draws, fence sync and integer attributes, is core in 3.2).
+    static const bool glLoaded = gladLoadGL() != 0;
+    if (!glLoaded) fail("the OpenGL functions could not be loaded");
+    if (!GLAD_GL_VERSION_3_3) fail("OpenGL 3.3 or newer is required");
+
+    if (!shader.loadFromMemory(shaderSource(VERTEX_SHADER), shaderSource(FRAGMENT_SHADER))) {
+        fail("the chunk shader did not compile");
+    }
+    shader.setUniform("atlas", 0);
+    shader.setUniform("pageTable", PAGE_TABLE_UNIT);
+
+    GLint location = glGetAttribLocation(shader.getNativeHandle(), "packedVertex");
+    if (location < 0) fail("the chunk shader has no packedVertex attribute");
+    vertexAttribute = static_cast<unsigned int>(location);
+}
+
+// Render the chunks around the player
+void WorldRenderer::render(const World& world, const sf::Vector3f& playerPosition, const std::optional<sf::Vector3i>& lookedAtBlock) {
+    PROFILE_ZONE("WorldRenderer::render");
+    const sf::Vector3f skyColor = world.getSkyColor();
+    const int chunkSize = world.getChunkSize();
+
+    // Choose the rings of detail for the render distance within the vertex budget
+    if (world.getRenderDistance() != lodRenderDistance) {
+        lodRenderDistance = world.getRenderDistance();
+        lodRings = ChunkMesher::lodRingsFor(lodRenderDistance, Config::World::VERTEX_BUDGET);
+    }
+    const int renderDistance = lodRings.drawDistance;
+
+    glClearColor(skyColor.x, skyColor.y, skyColor.z, 1.0f);
+
+    // Clear buffers
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Calculate the chunk coordinates of the player
+    sf::Vector2i playerChunk(static_cast<int>(std::floor(playerPosition.x / chunkSize)),
+                             static_cast<int>(std::floor(playerPosition.z / chunkSize)));
+
+    frameIndex++;
+    stats.sectionsRequested = 0;
+    stats.sectionsUploaded = 0;
+
+    // Remesh the sections that changed: edited ones right away, the others on the workers (both up to a limit, the
+    // sections left over stay dirty until a later frame)
+    collectDirtySections(world, playerChunk, playerPosition, lookedAtBlock);
+    stats.dirtySections = dirtySections.size();
+
+    int editedMeshed = 0;
+    for (const DirtySection& dirty : dirtySections) {
+        const Chunk& chunk = *world.getChunk(dirty.position);
+        if (dirty.edited && editedMeshed < Config::World::EDITED_SECTIONS_PER_FRAME) {
+            meshSection(world, chunk, dirty);
+            editedMeshed++;
+        } else if (stats.sectionsRequested < Config::World::MESH_REQUESTS_PER_FRAME) {
+            requestMesh(world, chunk, dirty);
+            stats.sectionsRequested++;
+        }
+    }
+
+    // Drop the meshes of the chunks that went out of range
+    for (auto it = meshes.begin(); it != meshes.end(); ) {
+        sf::Vector2i offset = it->first - playerChunk;
+        if (std::abs(offset.x) > renderDistance || std::abs(offset.y) > renderDistance || !world.getChunk(it->first)) {
+            it = meshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    uploadFinishedMeshes(world);
+    uploader.endFrame();
+    cullSections(world);
+
+    // Enable depth testing and texture
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_TEXTURE_2D);
+
+    // Enable face culling (cull back faces)
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_BACK);  // Cull the back faces
+    glFrontFace(GL_CW);  // Ensure counter-clockwise (CCW) is the front face
+
+    // Bind the texture atlas and the chunk shader
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, Texture::atlas.getNativeHandle());
+    shader.setUniform("skyLight", world.getSkyLight());
+    sf::Shader::bind(&shader);
+
+    glEnableVertexAttribArray(vertexAttribute);
+    arena.bind(vertexAttribute, PAGE_TABLE_UNIT);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    // Opaque blocks
+    shader.setUniform("alphaCutoff", 0.0f);
+    drawLayer(BlockRegistry::OPAQUE);
+
+    // Cutout blocks (leaves) are seen from both sides and drop their transparent texels
+    glDisable(GL_CULL_FACE);
+    shader.setUniform("alphaCutoff", 0.5f);
+    drawLayer(BlockRegistry::CUTOUT);
+
+    // Translucent blocks (water) are blended without writing depth
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);  // Standard alpha blending
+    glDepthMask(GL_FALSE);
+    glColor4f(1.0f, 1.0f, 1.0f, 0.65f);
+    shader.setUniform("alphaCutoff", 0.0f);
+    drawLayer(BlockRegistry::TRANSLUCENT);
+
+    // Restore the state
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    glDisableVertexAttribArray(vertexAttribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    sf::Shader::bind(nullptr);
+
+    // Disable depth testing and texture
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_DEPTH_TEST);
+}
+
+// Get the remeshing counters
+WorldRenderer::RemeshStats WorldRenderer::getRemeshStats() const {
+    return stats;
+}
+
+// Find the sections of the chunks in range that changed since their last meshing or moved to another level of detail,
+// in priority order
+void WorldRenderer::collectDirtySections(const World& world, const sf::Vector2i& playerChunk, const sf::Vector3f& playerPosition,
+                                         const std::optional<sf::Vector3i>& lookedAtBlock) {
+    PROFILE_ZONE("WorldRenderer::collectDirtySections");
+    const int chunkSize = world.getChunkSize();
+    const int renderDistance = lodRings.drawDistance;
+    const int sectionHeight = ChunkStorage::SECTION_HEIGHT;
+
+    // The section holding the looked at block comes first
+    sf::Vector2i lookedAtChunk;
+    int lookedAtSection = -1;
+    if (lookedAtBlock) {
+        lookedAtChunk = {Math::floorDiv(lookedAtBlock->x, chunkSize), Math::floorDiv(lookedAtBlock->z, chunkSize)};
+        lookedAtSection = lookedAtBlock->y / sectionHeight;
+    }
+
+    // Level of detail of the ring of distance a chunk is in
+    auto ringLod = [&](const sf::Vector2i& position) {
+        sf::Vector2i offset = position - playerChunk;
+        return ChunkMesher::lodForDistance(std::max(std::abs(offset.x), std::abs(offset.y)), lodRings);
+    };
+
+    dirtySections.clear();
+    for (int chunkX = playerChunk.x - renderDistance; chunkX <= playerChunk.x + renderDistance; chunkX++) {
+        for (int chunkZ = playerChunk.y - renderDistance; chunkZ <= playerChunk.y + renderDistance; chunkZ++) {
+            sf::Vector2i chunkPos(chunkX, chunkZ);
+            const Chunk* chunk = world.getChunk(chunkPos);
+            if (!chunk) continue;
+
+            // Level of detail of the ring the chunk is in, and the neighbours in another ring
+            int lod = ringLod(chunkPos);
+            std::uint8_t seams = 0;
+            const sf::Vector2i neighbourOffsets[4] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+            for (int i = 0; i < 4; i++) {
+                if (ringLod(chunkPos + neighbourOffsets[i]) != lod) seams |= 1 << i;
+            }
+
+            CachedMesh& cached = meshes[chunkPos];
+            for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+                SectionMesh& sectionMesh = cached[section];
+
+                // Remember when an edit was first seen, its latency is counted in frames from here
+                std::uint32_t editRevision = chunk->getSectionEditRevision(section);
+                if (editRevision > sectionMesh.seenEditRevision) {
+                    sectionMesh.seenEditRevision = editRevision;
+                    sectionMesh.editFrame = frameIndex;
+                }
+
+                if (sectionMesh.requestedRevision == chunk->getSectionRevision(section) && sectionMesh.requestedLod == lod &&
+                    sectionMesh.requestedSeams == seams) continue;
+
+                float priority = -1.0f;
+                if (chunkPos != lookedAtChunk || section != lookedAtSection) {
+                    sf::Vector3f center((chunkX + 0.5f) * chunkSize, (section + 0.5f) * sectionHeight, (chunkZ + 0.5f) * chunkSize);
+                    sf::Vector3f offset = center - playerPosition;
+                    priority = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+                }
+                dirtySections.push_back({chunkPos, section, lod, seams, priority, editRevision > sectionMesh.requestedRevision});
+            }
+        }
+    }
+
+    std::sort(dirtySections.begin(), dirtySections.end(), [](const DirtySection& a, const DirtySection& b) {
+        return a.priority < b.priority;
+    });
+}
+
+// Get the neighbours a section is meshed against, without the ones at another level of detail
+ChunkMesher::Neighbours WorldRenderer::getMeshNeighbours(const World& world, const DirtySection& dirty) {
+    // Faces towards a missing neighbour are kept, which closes the seam from this side. Above level 0 the
+    // mesher closes the sides of the chunk by itself and does not read the neighbours at all.
+    ChunkMesher::Neighbours neighbours = world.getNeighbours(dirty.position);
+    for (int i = 0; i < 4; i++) {
+        if (dirty.lod > 0 || (dirty.seams & (1 << i))) neighbours[i] = nullptr;
+    }
+    return neighbours;
+}
+
+// Get the light a section is meshed with
+ChunkMesher::Light WorldRenderer::getMeshLight(const World& world, const Chunk& chunk, const ChunkMesher::Neighbours& neighbours,
+                                               const DirtySection& dirty) {
+    const std::array<sf::Vector2i, 4> offsets = {sf::Vector2i(-1, 0), sf::Vector2i(1, 0), sf::Vector2i(0, -1), sf::Vector2i(0, 1)};
+
+    ChunkMesher::Light light{&chunk.getLight(), {}};
+    for (int i = 0; i < 4; i++) {
+        if (neighbours[i]) light.neighbours[i] = &world.getChunk(dirty.position + offsets[i])->getLight();
+    }
+    return light;
+}
+
+// Record the meshing of a dirty section as started and number it
+std::uint32_t WorldRenderer::startMeshing(const Chunk& chunk, const DirtySection& dirty) {
+    SectionMesh& sectionMesh = meshes[dirty.position][dirty.section];
+    sectionMesh.requestedRevision = chunk.getSectionRevision(dirty.section);
+    sectionMesh.requestedLod = dirty.lod;
+    sectionMesh.requestedSeams = dirty.seams;
+    return ++sectionMesh.request;
+}
+
+// Mesh a section on the main thread and upload it right away
+void WorldRenderer::meshSection(const World& world, const Chunk& chunk, const DirtySection& dirty) {
+    PROFILE_ZONE("WorldRenderer::meshSection");
+    std::uint32_t request = startMeshing(chunk, dirty);
+
+    ChunkMeshData data;
+    if (!chunk.getStorage().isSectionEmpty(dirty.section)) {
+        ChunkMesher::Neighbours neighbours = getMeshNeighbours(world, dirty);
+        ChunkMesher::Volume volume = ChunkMesher::gather(chunk.getStorage(), neighbours, dirty.section, dirty.lod,
+                                                         getMeshLight(world, chunk, neighbours, dirty));
+        data = ChunkMesher::build(volume, dirty.section, dirty.lod);
+    }
+    uploadSection(world, dirty.position, dirty.section, chunk.getSectionRevision(dirty.section), request, data);
+}
+
+// Start meshing a section on the workers
+void WorldRenderer::requestMesh(const World& world, const Chunk& chunk, const DirtySection& dirty) {
+    std::uint32_t revision = chunk.getSectionRevision(dirty.section);
+    std::uint32_t request = startMeshing(chunk, dirty);
+
+    // A section of air has no faces, its mesh is only cleared
+    if (chunk.getStorage().isSectionEmpty(dirty.section)) {
+        uploadSection(world, dirty.position, dirty.section, revision, request, ChunkMeshData());
+        return;
+    }
+
+    // Copy the blocks and light on the main thread so the workers never read a chunk that is being edited
+    ChunkMesher::Neighbours neighbours = getMeshNeighbours(world, dirty);
+    auto volume = std::make_shared<ChunkMesher::Volume>(ChunkMesher::gather(chunk.getStorage(), neighbours, dirty.section, dirty.lod,
+                                                                            getMeshLight(world, chunk, neighbours, dirty)));
+
+    jobSystem.submit([queue = finishedMeshes, volume, position = dirty.position, section = dirty.section, lod = dirty.lod,
+                      revision, request] {
+        queue->push({position, section, revision, request, ChunkMesher::build(*volume, section, lod)});
+    });
+}
+
+// Upload a section mesh unless a later meshing is already uploaded, and time the edit it shows
+void WorldRenderer::uploadSection(const World& world, const sf::Vector2i& chunkPosition, int section, std::uint32_t revision,
+                                  std::uint32_t request, const ChunkMeshData& data) {
+    auto it = meshes.find(chunkPosition);
+    if (it == meshes.end() || request <= it->second[section].uploadedRequest) return;
+
+    SectionMesh& sectionMesh = it->second[section];
+    std::uint32_t previousRevision = sectionMesh.revision;
+    sectionMesh.mesh.upload(data, chunkPosition, arena, uploader);
+    sectionMesh.visibility = data.visibility;
+    sectionMesh.revision = revision;
+    sectionMesh.uploadedRequest = request;
+    stats.sectionsUploaded++;
+
+    // The mesh shows an edit the previous mesh did not: it is drawn later in this frame
+    const Chunk* chunk = world.getChunk(chunkPosition);
+    std::uint32_t editRevision = chunk ? chunk->getSectionEditRevision(section) : 0;
+    if (editRevision > previousRevision && editRevision <= revision) {
+        auto latency = std::chrono::steady_clock::now() - chunk->getSectionEditTime(section);
+        stats.lastEditLatency = std::chrono::duration<float, std::milli>(latency).count();
+        stats.maxEditLatency = std::max(stats.maxEditLatency, stats.lastEditLatency);
+        stats.lastEditFrames = static_cast<int>(frameIndex - sectionMesh.editFrame);
+        stats.editsShown++;
+        if (stats.lastEditFrames == 0) stats.editsShownNextFrame++;
+    }
+}
+
+// Upload the meshes finished by the workers, within the frame budgets of time and bytes
+void WorldRenderer::uploadFinishedMeshes(const World& world) {
+    PROFILE_ZONE("WorldRenderer::uploadFinishedMeshes");
+    auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float, std::milli>(Config::World::MESH_UPLOAD_BUDGET);
+
+    // Meshes of chunks that went out of range or already replaced by a newer mesh are skipped
+    MeshResult result;
+    while (std::chrono::steady_clock::now() - start < budget && uploader.hasBudget() && finishedMeshes->tryPop(result)) {
+        uploadSection(world, result.position, result.section, result.revision, result.request, result.data);
+    }
+}
+
+// Get the culling counters
+WorldRenderer::CullStats WorldRenderer::getCullStats() const {
+    return cullStats;
+}
+
+// Get the mesh upload counters
+MeshUploader::Stats WorldRenderer::getUploadStats() const {
+    return uploader.getStats();
+}
+
+// Get the mesh arena counters
+MeshArena::Stats WorldRenderer::getArenaStats() const {
+    return arena.getStats();
+}
+
+// Get the rings of detail chosen for the current render distance
+ChunkMesher::LodRings WorldRenderer::getLodRings() const {
+    return lodRings;
+}
+
+// Find the section meshes to draw: inside the view frustum and reached by the visibility walk from the camera
+void WorldRenderer::cullSections(const World& world) {
+    PROFILE_ZONE("WorldRenderer::cullSections");
+    // The modelview matrix holds the camera set by Player::apply
+    Math::Matrix4 projection, view;
+    glGetFloatv(GL_PROJECTION_MATRIX, projection.data());
+    glGetFloatv(GL_MODELVIEW_MATRIX, view.data());
+    Math::Frustum frustum = Math::Frustum::fromMatrix(Math::multiply(projection, view));
+
+    const int chunkSize = world.getChunkSize();
+    const int sectionHeight = ChunkStorage::SECTION_HEIGHT;
+    auto sectionBox = [&](const sf::Vector2i& chunkPos, int section) {
+        return Math::AABB(chunkPos.x * chunkSize, section * sectionHeight, chunkPos.y * chunkSize, chunkSize, sectionHeight, chunkSize);
+    };
+
+    cullStats = {};
+    int inFrustum = 0;
+    for (auto& [chunkPos, cached] : meshes) {
+        for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+            SectionMesh& sectionMesh = cached[section];
+            sectionMesh.visible = false;
+            if (sectionMesh.mesh.isEmpty()) continue;
+
+            cullStats.sectionsConsidered++;
+            if (frustum.intersects(sectionBox(chunkPos, section))) inFrustum++;
+        }
+    }
+
+    // The camera is where the inverse of the view matrix (a rotation and a translation) puts the origin
+    sf::Vector3f eye(-(view[0] * view[12] + view[1] * view[13] + view[2] * view[14]),
+                     -(view[4] * view[12] + view[5] * view[13] + view[6] * view[14]),
+                     -(view[8] * view[12] + view[9] * view[13] + view[10] * view[14]));
+    sf::Vector2i cameraChunk(Math::floorDiv(static_cast<int>(std::floor(eye.x)), chunkSize),
+                             Math::floorDiv(static_cast<int>(std::floor(eye.z)), chunkSize));
+    int cameraSection = Math::floorDiv(static_cast<int>(std::floor(eye.y)), sectionHeight);
+
+    // Sections without a mesh yet (or outside the loaded chunks) are treated as air, nothing is hidden behind them
+    VisibilityGraph::walk(cameraChunk, cameraSection, world.getRenderDistance(),
+            [&](const sf::Vector2i& chunkPos, int section) {
+                auto it = meshes.find(chunkPos);
+                return it != meshes.end() ? it->second[section].visibility : VisibilityGraph::SectionVisibility::all();
+            },
+            [&](const sf::Vector2i& chunkPos, int section) {
+                return frustum.intersects(sectionBox(chunkPos, section));
+            },
+            [&](const sf::Vector2i& chunkPos, int section) {
+                auto it = meshes.find(chunkPos);
+                if (it == meshes.end() || it->second[section].mesh.isEmpty()) return;
+
+                // The camera's own section is reached even when it is outside the frustum
+                if (!frustum.intersects(sectionBox(chunkPos, section))) return;
+                it->second[section].visible = true;
+                cullStats.sectionsDrawn++;
+            });
+
+    cullStats.sectionsCulled = cullStats.sectionsConsidered - inFrustum;
+    cullStats.sectionsOccluded = inFrustum - cullStats.sectionsDrawn;
+}
+
+// Draw one render layer of the visible section meshes with one multi-draw
+void WorldRenderer::drawLayer(BlockRegistry::Layer layer) {
+    PROFILE_ZONE("WorldRenderer::drawLayer");
+    drawCounts.clear();
+    drawOffsets.clear();
+    drawBaseVertices.clear();
+
+    for (const auto& [chunkPos, cached] : meshes) {
+        for (const SectionMesh& section : cached) {
+            if (!section.visible) continue;
+
+            const MeshArena::Allocation& allocation = section.mesh.getAllocation(layer);
+            if (allocation.indexCount == 0) continue;
+
+            drawCounts.push_back(allocation.indexCount);
+            drawOffsets.push_back(reinterpret_cast<const void*>(arena.getIndexOffset(allocation)));
+            drawBaseVertices.push_back(arena.getBaseVertex(allocation));
+        }
+    }
+    if (drawCounts.empty()) return;
+
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, drawCounts.data(), GL_UNSIGNED_SHORT, drawOffsets.data(),
+                                  static_cast<GLsizei>(drawCounts.size()), drawBaseVertices.data());
+    cullStats.drawCommands += static_cast<int>(drawCounts.size());
+}
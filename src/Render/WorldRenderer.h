@@ -0,0 +1,175 @@
+#ifndef MINECRAFTCLONE_WORLDRENDERER_H
+#define MINECRAFTCLONE_WORLDRENDERER_H
+
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <SFML/Graphics/Shader.hpp>
+#include "ChunkMesh.h"
+#include "../Core/World.h"
+#include "../Utils/CompletionQueue.h"
+#include "../Utils/JobSystem.h"
+
+// Draws the world from cached meshes, one per chunk section. A section is meshed once and only meshed
+// again when its revision changes (block edits or a neighbour being generated), so an edit only costs
+// the sections it touches. Dirty sections are meshed closest first, starting with the section the
+// player is looking at. Sections changed by a block edit are meshed on the main thread so the edit
+// shows in the next frame; the others are meshed on the job system and uploaded on the main thread.
+// Section meshes outside the view frustum of the current camera, or that cannot be seen from the camera's
+// section through the visibility graph of the sections (hidden behind solid ground), are not drawn.
+// Distant chunks are meshed at a lower level of detail, chosen by rings of distance from the player
+// (ChunkMesher::lodForDistance); a chunk is meshed again when its ring changes. The rings are chosen for the
+// render distance so the estimated vertices of the view stay within Config::World::VERTEX_BUDGET, moving
+// closer (and the draw distance shrinking) for longer render distances. Where two levels meet,
+// both sides of the seam are closed with faces so no gap opens between them. Meshes are uploaded through
+// a staging ring (MeshUploader) within a budget of bytes per frame into one arena (MeshArena), so each
+// render pass draws every visible section with a single multi-draw.
+class WorldRenderer {
+public:
+    // Counters of the section remeshing
+    struct RemeshStats {
+        std::size_t dirtySections = 0;          // Sections whose mesh is older than their blocks
+        int sectionsRequested = 0;              // Sections handed to the workers in the last frame
+        int sectionsUploaded = 0;               // Section meshes uploaded in the last frame
+        float lastEditLatency = 0.0f;           // Milliseconds from the latest edit shown to the frame showing it
+        float maxEditLatency = 0.0f;            // Worst edit latency so far
+        int lastEditFrames = 0;                 // Frames drawn before the latest edit shown (0: the next frame)
+        std::uint64_t editsShown = 0;           // Edited section meshes uploaded
+        std::uint64_t editsShownNextFrame = 0;  // Edited section meshes uploaded in the first frame after the edit
+    };
+
+    // Counters of the culling in the last frame
+    struct CullStats {
+        int sectionsConsidered = 0;  // Section meshes with something to draw
+        int sectionsCulled = 0;      // Outside the view frustum
+        int sectionsOccluded = 0;    // Inside the view frustum but not reached from the camera's section
+        int sectionsDrawn = 0;
+        int drawCommands = 0;        // Section layers drawn, over one multi-draw per render pass
+    };
+
+    explicit WorldRenderer(JobSystem& jobSystem);
+
+    // Render the chunks around the player (lookedAtBlock is the block under the crosshair, if any)
+    void render(const World& world, const sf::Vector3f& playerPosition, const std::optional<sf::Vector3i>& lookedAtBlock);
+
+    // Get the remeshing counters
+    [[nodiscard]] RemeshStats getRemeshStats() const;
+
+    // Get the culling counters
+    [[nodiscard]] CullStats getCullStats() const;
+
+    // Get the mesh upload counters
+    [[nodiscard]] MeshUploader::Stats getUploadStats() const;
+
+    // Get the mesh arena counters
+    [[nodiscard]] MeshArena::Stats getArenaStats() const;
+
+    // Get the rings of detail chosen for the current render distance
+    [[nodiscard]] ChunkMesher::LodRings getLodRings() const;
+
+private:
+    struct SectionMesh {
+        ChunkMesh mesh;
+        std::uint32_t revision = 0;           // Revision of the section the uploaded mesh was built from
+        std::uint32_t requestedRevision = 0;  // Revision of the section the latest meshing was started for
+        int requestedLod = 0;                 // Level of detail the latest meshing was started for
+        std::uint8_t requestedSeams = 0;      // Neighbours at another level the latest meshing closed the faces to
+        std::uint32_t request = 0;            // Meshings started, numbers them so an older one is never uploaded last
+        std::uint32_t uploadedRequest = 0;    // Number of the meshing the uploaded mesh comes from
+        std::uint32_t seenEditRevision = 0;   // Latest edit revision the renderer has seen
+        std::uint64_t editFrame = 0;          // Frame in which that edit was first seen
+        bool visible = false;                 // Inside the view frustum and reached from the camera this frame
+
+        // Faces of the section that see each other, from the uploaded mesh
+        VisibilityGraph::SectionVisibility visibility = VisibilityGraph::SectionVisibility::all();
+    };
+
+    using CachedMesh = std::array<SectionMesh, ChunkStorage::SECTION_COUNT>;
+
+    // A section mesh built by a worker, waiting to be uploaded
+    struct MeshResult {
+        sf::Vector2i position;
+        int section = 0;
+        std::uint32_t revision = 0;
+        std::uint32_t request = 0;
+        ChunkMeshData data;
+    };
+
+    // A section whose mesh is older than its blocks, or meshed at another level of detail
+    struct DirtySection {
+        sf::Vector2i position;
+        int section;
+        int lod;
+        std::uint8_t seams;  // Neighbours (ChunkMesher::Neighbours order) at another level of detail
+        float priority;      // Lower is meshed first
+        bool edited;         // Changed by a block edit that no meshing has picked up yet
+    };
+
+    MeshArena arena;  // Holds the section meshes, declared first so it outlives them
+    MeshUploader uploader;
+
+    std::unordered_map<sf::Vector2i, CachedMesh> meshes;  // Section meshes of the chunks around the player
+
+    sf::Shader shader;             // Unpacks the chunk vertices and maps the texture coordinates of merged faces onto their atlas tile
+    unsigned int vertexAttribute;  // Location of the packed vertex in the shader
+
+    JobSystem& jobSystem;
+
+    // Meshes finished by the workers (shared with the jobs, which may outlive the renderer)
+    std::shared_ptr<CompletionQueue<MeshResult>> finishedMeshes;
+
+    std::vector<DirtySection> dirtySections;  // Rebuilt every frame
+
+    ChunkMesher::LodRings lodRings;  // Rings of detail within the vertex budget, chosen again when the render distance changes
+    int lodRenderDistance = 0;       // Render distance the rings were chosen for
+
+    // Arguments of the multi-draw of a render pass, rebuilt for every pass
+    std::vector<int> drawCounts;
+    std::vector<const void*> drawOffsets;
+    std::vector<int> drawBaseVertices;
+    std::uint64_t frameIndex = 0;
+    RemeshStats stats;
+    CullStats cullStats;
+
+    // Find the sections of the chunks in range that changed since their last meshing or moved to another
+    // level of detail, in priority order
+    void collectDirtySections(const World& world, const sf::Vector2i& playerChunk, const sf::Vector3f& playerPosition,
+                              const std::optional<sf::Vector3i>& lookedAtBlock);
+
+    // Get the neighbours a section is meshed against, without the ones at another level of detail
+    static ChunkMesher::Neighbours getMeshNeighbours(const World& world, const DirtySection& dirty);
+
+    // Get the light a section is meshed with: the chunk's and the light of the neighbours it is meshed against
+    static ChunkMesher::Light getMeshLight(const World& world, const Chunk& chunk, const ChunkMesher::Neighbours& neighbours,
+                                           const DirtySection& dirty);
+
+    // Record the meshing of a dirty section as started and number it
+    std::uint32_t startMeshing(const Chunk& chunk, const DirtySection& dirty);
+
+    // Mesh a section on the main thread and upload it right away
+    void meshSection(const World& world, const Chunk& chunk, const DirtySection& dirty);
+
+    // Start meshing a section on the workers
+    void requestMesh(const World& world, const Chunk& chunk, const DirtySection& dirty);
+
+    // Upload a section mesh unless a later meshing is already uploaded, and time the edit it shows
+    void uploadSection(const World& world, const sf::Vector2i& chunkPosition, int section, std::uint32_t revision,
+                       std::uint32_t request, const ChunkMeshData& data);
+
+    // Upload the meshes finished by the workers, within the frame budgets of time and bytes
+    void uploadFinishedMeshes(const World& world);
+
+    // Find the section meshes to draw: inside the view frustum of the current projection and modelview
+    // matrices and reached by the visibility walk from the camera's section
+    void cullSections(const World& world);
+
+    // Draw one render layer of the visible section meshes
+    void drawLayer(BlockRegistry::Layer layer);
+};
+
+
+#endif
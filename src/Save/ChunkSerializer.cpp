@@ -0,0 +1,258 @@
+#include <cstring>
+#include "ChunkSerializer.h"
+
+namespace {
+    constexpr int VOLUME = ChunkStorage::SECTION_VOLUME;
+    static_assert(ChunkStorage::SECTION_COUNT <= 16, "The section mask is 16 bits");
+
+    // Packed words can only be used as they are in the file on a little-endian machine
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    constexpr bool LITTLE_ENDIAN_HOST = false;
+#else
+    constexpr bool LITTLE_ENDIAN_HOST = true;
+#endif
+
+    void writeU16(std::vector<std::uint8_t>& out, std::uint16_t value) {
+        out.push_back(static_cast<std::uint8_t>(value));
+        out.push_back(static_cast<std::uint8_t>(value >> 8));
+    }
+
+    void writeU64(std::vector<std::uint8_t>& out, std::uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            out.push_back(static_cast<std::uint8_t>(value >> (i * 8)));
+        }
+    }
+
+    // Bounds-checked reads from a payload
+    class Reader {
+    public:
+        Reader(const std::uint8_t* data, std::size_t size) : data(data), size(size), offset(0) {}
+
+        bool readU8(std::uint8_t& value) {
+            if (offset + 1 > size) return false;
+            value = data[offset++];
+            return true;
+        }
+
+        bool readU16(std::uint16_t& value) {
+            if (offset + 2 > size) return false;
+            value = static_cast<std::uint16_t>(data[offset] | (data[offset + 1] << 8));
+            offset += 2;
+            return true;
+        }
+
+        // Take the next count bytes in place
+        bool readBytes(std::size_t count, const std::uint8_t*& bytes) {
+            if (offset + count > size) return false;
+            bytes = data + offset;
+            offset += count;
+            return true;
+        }
+
+        bool skipTo(std::size_t alignment) {
+            std::size_t aligned = (offset + alignment - 1) / alignment * alignment;
+            if (aligned > size) return false;
+            offset = aligned;
+            return true;
+        }
+
+    private:
+        const std::uint8_t* data;
+        std::size_t size;
+        std::size_t offset;
+    };
+
+    // Palette index of an entry in bit-packed words
+    int getIndex(const std::uint64_t* words, int bitsPerEntry, int index) {
+        int bitIndex = index * bitsPerEntry;
+        std::uint64_t mask = (std::uint64_t(1) << bitsPerEntry) - 1;
+        return static_cast<int>((words[bitIndex >> 6] >> (bitIndex & 63)) & mask);
+    }
+
+    int getIndex(const ChunkStorage::SectionData& section, int index) {
+        if (section.bitsPerEntry == 0) return 0;  // Uniform section, no words
+        return getIndex(section.data.data(), section.bitsPerEntry, index);
+    }
+
+    // Store one palette index over a run of entries of zeroed words, whole words at a time where the run
+    // covers them
+    void fillRun(std::vector<std::uint64_t>& data, int bitsPerEntry, int start, int length, std::uint64_t index) {
+        const int entriesPerWord = 64 / bitsPerEntry;
+        const std::uint64_t pattern = index * (~std::uint64_t(0) / ((std::uint64_t(1) << bitsPerEntry) - 1));
+
+        int position = start;
+        int end = start + length;
+        for (; position < end && position % entriesPerWord != 0; position++) {
+            int bitIndex = position * bitsPerEntry;
+            data[bitIndex >> 6] |= index << (bitIndex & 63);
+        }
+        for (; end - position >= entriesPerWord; position += entriesPerWord) {
+            data[position / entriesPerWord] = pattern;
+        }
+        for (; position < end; position++) {
+            int bitIndex = position * bitsPerEntry;
+            data[bitIndex >> 6] |= index << (bitIndex & 63);
+        }
+    }
+
+    // Smallest entry width able to index a palette
+    int bitsForPalette(std::size_t paletteSize) {
+        int bits = 1;
+        while ((std::size_t(1) << bits) < paletteSize) bits *= 2;
+        return bits;
+    }
+
+    void encodeSection(const ChunkStorage::SectionData& section, std::vector<std::uint8_t>& out) {
+        out.push_back(static_cast<std::uint8_t>(section.palette.size() - 1));
+        for (BlockType type : section.palette) {
+            out.push_back(static_cast<std::uint8_t>(type));
+        }
+
+        // Runs of the same palette index, in storage order
+        std::vector<std::uint8_t> runs;
+        int runIndex = getIndex(section, 0);
+        int runLength = 0;
+        for (int i = 0; i < VOLUME; i++) {
+            int index = getIndex(section, i);
+            if (index != runIndex) {
+                runs.push_back(static_cast<std::uint8_t>(runIndex));
+                writeU16(runs, static_cast<std::uint16_t>(runLength));
+                runIndex = index;
+                runLength = 0;
+            }
+            runLength++;
+        }
+        runs.push_back(static_cast<std::uint8_t>(runIndex));
+        writeU16(runs, static_cast<std::uint16_t>(runLength));
+
+        std::size_t packedSize = 1 + 7 + section.data.size() * sizeof(std::uint64_t);  // Worst case padding
+        if (runs.size() < packedSize) {
+            out.push_back(ChunkSerializer::RLE);
+            out.insert(out.end(), runs.begin(), runs.end());
+            return;
+        }
+
+        out.push_back(ChunkSerializer::PACKED);
+        out.push_back(static_cast<std::uint8_t>(section.bitsPerEntry));
+        while (out.size() % 8 != 0) out.push_back(0);
+        for (std::uint64_t word : section.data) {
+            writeU64(out, word);
+        }
+    }
+
+    bool decodeSection(Reader& reader, ChunkStorage::SectionData& section, const std::shared_ptr<const void>& backing) {
+        std::uint8_t paletteSize, encoding;
+        if (!reader.readU8(paletteSize)) return false;
+
+        section.palette.resize(paletteSize + 1);
+        for (BlockType& type : section.palette) {
+            std::uint8_t value;
+            if (!reader.readU8(value) || value >= BLOCK_TYPE_COUNT) return false;
+            type = static_cast<BlockType>(value);
+        }
+
+        if (!reader.readU8(encoding)) return false;
+
+        if (encoding == ChunkSerializer::RLE) {
+            // A single type palette loads as a uniform section, the runs are only checked
+            section.bitsPerEntry = section.palette.size() == 1 ? 0 : bitsForPalette(section.palette.size());
+            section.data.assign(VOLUME * section.bitsPerEntry / 64, 0);
+
+            int position = 0;
+            while (position < VOLUME) {
+                std::uint8_t index;
+                std::uint16_t length;
+                if (!reader.readU8(index) || !reader.readU16(length)) return false;
+                if (index >= section.palette.size() || length == 0 || position + length > VOLUME) return false;
+
+                if (section.bitsPerEntry > 0) fillRun(section.data, section.bitsPerEntry, position, length, index);
+                position += length;
+            }
+            return true;
+        }
+
+        if (encoding == ChunkSerializer::PACKED) {
+            std::uint8_t bits;
+            if (!reader.readU8(bits) || (bits != 1 && bits != 2 && bits != 4 && bits != 8)) return false;
+            if (!reader.skipTo(8)) return false;
+
+            section.bitsPerEntry = bits;
+            std::size_t wordCount = VOLUME * bits / 64;
+            const std::uint8_t* bytes;
+            if (!reader.readBytes(wordCount * sizeof(std::uint64_t), bytes)) return false;
+
+            const std::uint64_t* words;
+            bool aligned = reinterpret_cast<std::uintptr_t>(bytes) % alignof(std::uint64_t) == 0;
+            if (backing && LITTLE_ENDIAN_HOST && aligned) {
+                // Reference the words where they are in the mapped file
+                words = reinterpret_cast<const std::uint64_t*>(bytes);
+                section.borrowedData = words;
+                section.backing = backing;
+            } else {
+                section.data.resize(wordCount);
+                if (LITTLE_ENDIAN_HOST) {
+                    std::memcpy(section.data.data(), bytes, wordCount * sizeof(std::uint64_t));
+                } else {
+                    for (std::size_t i = 0; i < wordCount; i++) {
+                        std::uint64_t word = 0;
+                        for (int b = 0; b < 8; b++) word |= std::uint64_t(bytes[i * 8 + b]) << (b * 8);
+                        section.data[i] = word;
+                    }
+                }
+                words = section.data.data();
+            }
+
+            // Every index must point into the palette (always true when the palette fills the index width)
+            if (section.palette.size() < (std::size_t(1) << bits)) {
+                for (int i = 0; i < VOLUME; i++) {
+                    if (getIndex(words, bits, i) >= static_cast<int>(section.palette.size())) return false;
+                }
+            }
+            return true;
+        }
+
+        return false;
+    }
+}
+
+// Encode a chunk column
+std::vector<std::uint8_t> ChunkSerializer::encode(const ChunkStorage& storage) {
+    std::vector<std::uint8_t> out;
+    out.push_back(VERSION);
+
+    std::uint16_t mask = 0;
+    for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+        if (!storage.isSectionEmpty(section)) mask |= static_cast<std::uint16_t>(1u << section);
+    }
+    writeU16(out, mask);
+
+    for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+        if (mask & (1u << section)) {
+            encodeSection(storage.getSectionData(section), out);
+        }
+    }
+    return out;
+}
+
+// Decode a chunk column
+bool ChunkSerializer::decode(const std::uint8_t* payload, std::size_t size, ChunkStorage& storage,
+                             const std::shared_ptr<const void>& backing) {
+    Reader reader(payload, size);
+
+    std::uint8_t version;
+    std::uint16_t mask;
+    if (!reader.readU8(version) || version != VERSION || !reader.readU16(mask)) return false;
+
+    ChunkStorage decoded;
+    for (int section = 0; section < ChunkStorage::SECTION_COUNT; section++) {
+        if (!(mask & (1u << section))) continue;
+
+        ChunkStorage::SectionData sectionData;
+        if (!decodeSection(reader, sectionData, backing) || !decoded.setSectionData(section, std::move(sectionData))) {
+            return false;
+        }
+    }
+
+    storage = std::move(decoded);
+    return true;
+}
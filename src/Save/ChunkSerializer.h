@@ -0,0 +1,43 @@
+#ifndef MINECRAFTCLONE_CHUNKSERIALIZER_H
+#define MINECRAFTCLONE_CHUNKSERIALIZER_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../Core/ChunkStorage.h"
+
+// Binary encoding of a chunk column for the region files. Sections that only hold air are skipped,
+// the others store their palette followed by either run-length encoded palette indices or the
+// bit-packed indices as they are in memory, whichever is smaller:
+//
+//   u8  version
+//   u16 mask of the stored sections
+//   per stored section:
+//     u8  palette size - 1, then one byte per palette entry
+//     u8  encoding
+//     RLE:    (u8 palette index, u16 run length) runs covering the whole section
+//     PACKED: u8 bits per entry, zero padding to an 8 byte boundary, then the 64-bit words
+//
+// Values are little-endian. The padding keeps the packed words aligned in the region file, so a
+// payload read from a mapped file can hand its packed words to the storage without copying them.
+namespace ChunkSerializer {
+    constexpr std::uint8_t VERSION = 1;
+
+    enum Encoding : std::uint8_t {
+        RLE = 0,
+        PACKED = 1
+    };
+
+    // Encode a chunk column
+    [[nodiscard]] std::vector<std::uint8_t> encode(const ChunkStorage& storage);
+
+    // Decode a chunk column, returns false if the payload is malformed. When backing is given, the payload
+    // lives in memory it keeps alive (a mapped region file) and packed sections reference their words there.
+    bool decode(const std::uint8_t* payload, std::size_t size, ChunkStorage& storage,
+                const std::shared_ptr<const void>& backing = nullptr);
+}
+
+
+#endif
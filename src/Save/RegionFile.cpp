@@ -0,0 +1,253 @@
+#include <algorithm>
+#include "RegionFile.h"
+#include "../Utils/Math.h"
+
+namespace {
+    void putU32(std::uint8_t* out, std::uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            out[i] = static_cast<std::uint8_t>(value >> (i * 8));
+        }
+    }
+
+    std::uint32_t getU32(const std::uint8_t* in) {
+        return std::uint32_t(in[0]) | (std::uint32_t(in[1]) << 8) | (std::uint32_t(in[2]) << 16) | (std::uint32_t(in[3]) << 24);
+    }
+}
+
+// Open a region file, creating it if it does not exist
+RegionFile::RegionFile(const std::string& path) : path(path), open(false) {
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open()) {
+        std::ofstream create(path, std::ios::binary);  // fstream cannot open a missing file for reading and writing
+        create.close();
+        file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    }
+
+    open = file.is_open() && readHeader();
+}
+
+// Check if the file could be opened and its header is valid
+bool RegionFile::isOpen() const {
+    return open;
+}
+
+// Check if a chunk is stored
+bool RegionFile::hasChunk(int localX, int localZ) const {
+    return entries[entryIndex(localX, localZ)].length > 0;
+}
+
+// Read the payload of a chunk
+bool RegionFile::readChunk(int localX, int localZ, std::vector<std::uint8_t>& payload) {
+    const Entry& entry = entries[entryIndex(localX, localZ)];
+    if (!open || entry.length == 0) return false;
+
+    payload.resize(entry.length);
+    file.seekg(static_cast<std::streamoff>(entry.sector) * SECTOR_SIZE);
+    file.read(reinterpret_cast<char*>(payload.data()), entry.length);
+    if (!file) {
+        file.clear();
+        return false;
+    }
+    return true;
+}
+
+// Get the payload of a chunk in the mapped file. The file is mapped again when the chunk lies past the
+// end of the current mapping; chunks still referencing the old one keep it alive.
+bool RegionFile::mapChunk(int localX, int localZ, MappedChunk& chunk) {
+    const Entry& entry = entries[entryIndex(localX, localZ)];
+    if (!open || entry.length == 0) return false;
+
+    std::size_t end = static_cast<std::size_t>(entry.sector) * SECTOR_SIZE + entry.length;
+    if (!mapping || mapping->size() < end) {
+        if (mapping) oldMappings.push_back(mapping);
+        mapping = std::make_shared<const MappedFile>(path);
+        if (!mapping->isOpen() || mapping->size() < end) {
+            mapping.reset();
+            return false;
+        }
+    }
+
+    chunk.data = mapping->data() + static_cast<std::size_t>(entry.sector) * SECTOR_SIZE;
+    chunk.length = entry.length;
+    chunk.mapping = mapping;
+    return true;
+}
+
+// Write the payload of a chunk. The payload is written before the table entry, so an interrupted
+// write of a moved chunk leaves the previous copy in place.
+bool RegionFile::writeChunk(int localX, int localZ, const std::vector<std::uint8_t>& payload) {
+    if (!open || payload.empty() || payload.size() > MAX_CHUNK_LENGTH) return false;
+
+    int index = entryIndex(localX, localZ);
+    Entry entry = entries[index];
+    std::uint32_t length = static_cast<std::uint32_t>(payload.size());
+    std::uint32_t sectorCount = sectorsFor(length);
+
+    // Sectors left while the file was mapped can be reused once nothing references the mapping
+    bool mapped = isMappingHeld();
+    if (!mapped) {
+        for (const Entry& retired : retiredEntries) markSectors(retired, false);
+        retiredEntries.clear();
+    }
+
+    // Keep the chunk where it is if it still fits, the sectors it no longer needs are freed. A mapped
+    // payload may still be read, so it is left untouched and the chunk moves.
+    bool inPlace = !mapped && entry.length > 0 && sectorsFor(entry.length) >= sectorCount;
+    if (entry.length > 0) {
+        if (mapped) retiredEntries.push_back(entry);
+        else markSectors(entry, false);
+    }
+    std::uint32_t sector = inPlace ? entry.sector : allocate(sectorCount);
+
+    entry = {sector, length};
+    markSectors(entry, true);
+
+    // Pad the payload to whole sectors
+    std::vector<char> padding(sectorCount * SECTOR_SIZE - length, 0);
+    file.seekp(static_cast<std::streamoff>(sector) * SECTOR_SIZE);
+    file.write(reinterpret_cast<const char*>(payload.data()), length);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    entries[index] = entry;
+    if (!file || !writeEntry(index)) {
+        file.clear();
+        return false;
+    }
+
+    file.flush();
+    return true;
+}
+
+// Get the location of a chunk payload
+RegionFile::Entry RegionFile::getEntry(int localX, int localZ) const {
+    return entries[entryIndex(localX, localZ)];
+}
+
+// Check if a mapping handed out by mapChunk is still held outside the region file
+bool RegionFile::isMappingHeld() {
+    oldMappings.erase(std::remove_if(oldMappings.begin(), oldMappings.end(),
+                                     [](const std::weak_ptr<const MappedFile>& old) { return old.expired(); }),
+                      oldMappings.end());
+    return !oldMappings.empty() || mapping.use_count() > 1;
+}
+
+// Get the region containing a chunk
+int RegionFile::toRegion(int chunkCoordinate) {
+    return Math::floorDiv(chunkCoordinate, SIZE);
+}
+
+// Get the coordinate of a chunk inside its region
+int RegionFile::toLocal(int chunkCoordinate) {
+    return chunkCoordinate - toRegion(chunkCoordinate) * SIZE;
+}
+
+// Get the file name of a region
+std::string RegionFile::fileName(int regionX, int regionZ) {
+    return "r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".region";
+}
+
+// Read the header of an existing file, or write the header of a new one
+bool RegionFile::readHeader() {
+    file.seekg(0, std::ios::end);
+    std::streamoff fileSize = file.tellg();
+    if (fileSize == 0) {
+        return writeHeader();
+    }
+    if (fileSize < static_cast<std::streamoff>(HEADER_SIZE)) return false;
+
+    std::vector<std::uint8_t> header(HEADER_SIZE);
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(header.data()), HEADER_SIZE);
+    if (!file || getU32(header.data()) != MAGIC || getU32(header.data() + 4) != VERSION) return false;
+
+    std::uint32_t sectorCount = static_cast<std::uint32_t>((fileSize + SECTOR_SIZE - 1) / SECTOR_SIZE);
+    usedSectors.assign(std::max(sectorCount, HEADER_SECTORS), false);
+    markSectors({0, HEADER_SIZE}, true);
+
+    for (int i = 0; i < CHUNK_COUNT; i++) {
+        Entry entry = {getU32(header.data() + 8 + i * 8), getU32(header.data() + 12 + i * 8)};
+
+        // Drop entries longer than any chunk, pointing outside the file or into the header, or overlapping an
+        // entry read before them (rewriting one in place would overwrite the other)
+        if (entry.length > 0) {
+            std::uint64_t end = static_cast<std::uint64_t>(entry.sector) + sectorsFor(entry.length);
+            if (entry.length > MAX_CHUNK_LENGTH || entry.sector < HEADER_SECTORS || end > sectorCount ||
+                !areSectorsFree(entry)) {
+                entry = {};
+            }
+        }
+        entries[i] = entry;
+        if (entry.length > 0) markSectors(entry, true);
+    }
+    return true;
+}
+
+bool RegionFile::writeHeader() {
+    std::vector<std::uint8_t> header(HEADER_SECTORS * SECTOR_SIZE, 0);
+    putU32(header.data(), MAGIC);
+    putU32(header.data() + 4, VERSION);
+
+    entries.fill({});
+    usedSectors.assign(HEADER_SECTORS, true);
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file.flush();
+    return static_cast<bool>(file);
+}
+
+// Write the table entry of one chunk
+bool RegionFile::writeEntry(int index) {
+    std::uint8_t bytes[8];
+    putU32(bytes, entries[index].sector);
+    putU32(bytes + 4, entries[index].length);
+
+    file.seekp(8 + index * 8);
+    file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    return static_cast<bool>(file);
+}
+
+// Find the first run of free sectors long enough, growing the file if there is none
+std::uint32_t RegionFile::allocate(std::uint32_t sectorCount) {
+    std::uint32_t runStart = 0, runLength = 0;
+    for (std::uint32_t sector = HEADER_SECTORS; sector < usedSectors.size(); sector++) {
+        if (usedSectors[sector]) {
+            runLength = 0;
+            continue;
+        }
+        if (runLength == 0) runStart = sector;
+        if (++runLength == sectorCount) return runStart;
+    }
+
+    // Extend the free run at the end of the file (if any) past the current end
+    std::uint32_t start = runLength > 0 ? runStart : static_cast<std::uint32_t>(usedSectors.size());
+    usedSectors.resize(start + sectorCount, false);
+    return start;
+}
+
+void RegionFile::markSectors(const Entry& entry, bool used) {
+    std::uint32_t end = entry.sector + sectorsFor(entry.length);
+    if (usedSectors.size() < end) usedSectors.resize(end, false);
+    for (std::uint32_t sector = entry.sector; sector < end; sector++) {
+        usedSectors[sector] = used;
+    }
+}
+
+// Check if none of the sectors of an entry is in use yet
+bool RegionFile::areSectorsFree(const Entry& entry) const {
+    std::uint64_t end = std::min<std::uint64_t>(static_cast<std::uint64_t>(entry.sector) + sectorsFor(entry.length),
+                                                usedSectors.size());
+    for (std::uint64_t sector = entry.sector; sector < end; sector++) {
+        if (usedSectors[sector]) return false;
+    }
+    return true;
+}
+
+std::uint32_t RegionFile::sectorsFor(std::uint32_t length) {
+    // In 64 bits so the largest lengths do not wrap around to 0 sectors
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(length) + SECTOR_SIZE - 1) / SECTOR_SIZE);
+}
+
+int RegionFile::entryIndex(int localX, int localZ) {
+    return localZ * SIZE + localX;
+}
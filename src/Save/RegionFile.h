@@ -0,0 +1,112 @@
+#ifndef MINECRAFTCLONE_REGIONFILE_H
+#define MINECRAFTCLONE_REGIONFILE_H
+
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Utils/MappedFile.h"
+
+// File holding the chunks of a 32x32 chunk region. The file is split into 512 byte sectors: the first
+// sectors hold a header and an offset table with the first sector and byte length of every chunk, the
+// rest hold the chunk payloads. A chunk is rewritten in place when its new payload fits in the sectors
+// it already has, otherwise it moves to the first free run of sectors, so writing one chunk never
+// rewrites the rest of the file.
+//
+// Chunks can also be read straight from a memory mapping of the file. While a mapping handed out by
+// mapChunk is held, no sector is overwritten: rewritten chunks always move, and the sectors they
+// leave are only reused once every mapping has been released.
+class RegionFile {
+public:
+    static constexpr int SIZE = 32;                 // Chunks per side of a region
+    static constexpr int CHUNK_COUNT = SIZE * SIZE;
+    static constexpr std::uint32_t SECTOR_SIZE = 512;
+    static constexpr std::uint32_t MAGIC = 0x4E474552;  // "REGN"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t MAX_CHUNK_LENGTH = 1 << 20;  // Far above any encoded chunk, larger entries are corrupt
+
+    // Header: magic, version, then one (first sector, byte length) entry per chunk
+    static constexpr std::uint32_t HEADER_SIZE = 8 + CHUNK_COUNT * 8;
+    static constexpr std::uint32_t HEADER_SECTORS = (HEADER_SIZE + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+    // Location of a chunk payload in the file (length 0 means the chunk is not stored)
+    struct Entry {
+        std::uint32_t sector = 0;
+        std::uint32_t length = 0;
+    };
+
+    // Payload of a chunk inside the mapped file, valid as long as the mapping is held
+    struct MappedChunk {
+        const std::uint8_t* data = nullptr;
+        std::uint32_t length = 0;
+        std::shared_ptr<const MappedFile> mapping;
+    };
+
+    // Open a region file, creating it if it does not exist
+    explicit RegionFile(const std::string& path);
+
+    // Check if the file could be opened and its header is valid
+    [[nodiscard]] bool isOpen() const;
+
+    // Check if a chunk is stored (local chunk coordinates inside the region)
+    [[nodiscard]] bool hasChunk(int localX, int localZ) const;
+
+    // Read the payload of a chunk, returns false if it is not stored
+    bool readChunk(int localX, int localZ, std::vector<std::uint8_t>& payload);
+
+    // Get the payload of a chunk in the mapped file without copying it, returns false if it is not stored
+    // or the file cannot be mapped
+    bool mapChunk(int localX, int localZ, MappedChunk& chunk);
+
+    // Write the payload of a chunk
+    bool writeChunk(int localX, int localZ, const std::vector<std::uint8_t>& payload);
+
+    // Get the location of a chunk payload
+    [[nodiscard]] Entry getEntry(int localX, int localZ) const;
+
+    // Get the region containing a chunk and the chunk's coordinates inside it
+    static int toRegion(int chunkCoordinate);
+    static int toLocal(int chunkCoordinate);
+
+    // Get the file name of a region
+    static std::string fileName(int regionX, int regionZ);
+
+private:
+    const std::string path;
+    std::fstream file;
+    bool open;
+
+    std::array<Entry, CHUNK_COUNT> entries;
+    std::vector<bool> usedSectors;  // Sectors holding the header or a payload
+
+    std::shared_ptr<const MappedFile> mapping;                 // Mapping of the file, replaced when the file grows
+    std::vector<std::weak_ptr<const MappedFile>> oldMappings;  // Replaced mappings that may still be held
+    std::vector<Entry> retiredEntries;                         // Payloads left while mapped, still marked used
+
+    // Check if a mapping handed out by mapChunk is still held outside the region file
+    bool isMappingHeld();
+
+    // Read the header of an existing file, or write the header of a new one
+    bool readHeader();
+    bool writeHeader();
+
+    // Write the table entry of one chunk
+    bool writeEntry(int index);
+
+    // Find the first run of free sectors long enough, growing the file if there is none
+    std::uint32_t allocate(std::uint32_t sectorCount);
+
+    void markSectors(const Entry& entry, bool used);
+
+    // Check if none of the sectors of an entry is in use yet
+    [[nodiscard]] bool areSectorsFree(const Entry& entry) const;
+
+    static std::uint32_t sectorsFor(std::uint32_t length);
+    static int entryIndex(int localX, int localZ);
+};
+
+
+#endif
@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "WorldSave.h"
+#include "ChunkSerializer.h"
+
+namespace {
+    const char* SEED_FILE = "world.txt";
+}
+
+// Open (or create) a save folder and start the I/O thread
+WorldSave::WorldSave(const std::string& directory, ReadMode readMode)
+    : directory(directory), readMode(readMode), running(true), chunksWritten(0), bytesWritten(0), chunksLoaded(0),
+      chunksMapped(0), writeFailures(0) {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    ioThread = std::thread(&WorldSave::ioLoop, this);
+}
+
+// Write the snapshots that are still queued and stop the I/O thread
+WorldSave::~WorldSave() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        running = false;
+    }
+    pendingCondition.notify_all();
+    ioThread.join();
+
+    if (!failed.empty()) {
+        std::fprintf(stderr, "%zu chunks of %s could not be saved, their edits are lost\n", failed.size(), directory.c_str());
+    }
+}
+
+// Read the seed stored in a save folder
+std::optional<unsigned int> WorldSave::readSeed(const std::string& directory) {
+    std::ifstream file(std::filesystem::path(directory) / SEED_FILE);
+    std::string key;
+    unsigned int seed;
+    if (file >> key >> seed && key == "seed") {
+        return seed;
+    }
+    return std::nullopt;
+}
+
+// Store the seed of the world
+bool WorldSave::writeSeed(unsigned int seed) {
+    std::ofstream file(std::filesystem::path(directory) / SEED_FILE);
+    file << "seed " << seed << "\n";
+    return static_cast<bool>(file);
+}
+
+// Load a chunk, from the queued snapshots first and then from its region file
+bool WorldSave::loadChunk(const sf::Vector2i& chunkPosition, ChunkStorage& storage) {
+    {
+        // A chunk being written is neither in pending nor complete in its region yet
+        std::unique_lock<std::mutex> lock(pendingMutex);
+        writtenCondition.wait(lock, [this, &chunkPosition] { return writingChunk != chunkPosition; });
+
+        for (const auto* snapshots : {&pending, &failed}) {
+            auto it = snapshots->find(chunkPosition);
+            if (it != snapshots->end()) {
+                storage = it->second;
+                return true;
+            }
+        }
+    }
+
+    int localX = RegionFile::toLocal(chunkPosition.x);
+    int localZ = RegionFile::toLocal(chunkPosition.y);
+    RegionFile::MappedChunk mapped;
+    std::vector<std::uint8_t> payload;
+    {
+        std::lock_guard<std::mutex> lock(regionMutex);
+        RegionFile* region = getRegion(chunkPosition, false);
+        if (!region) return false;
+
+        // Fall back to a buffered read if the file cannot be mapped
+        bool isMapped = readMode == ReadMode::MAPPED && region->mapChunk(localX, localZ, mapped);
+        if (!isMapped && !region->readChunk(localX, localZ, payload)) return false;
+    }
+
+    // Decode outside the lock so several threads can load at once. The mapping held by a mapped chunk
+    // keeps the region from overwriting the payload while it is decoded.
+    chunksLoaded++;
+    if (mapped.mapping) {
+        chunksMapped++;
+        return ChunkSerializer::decode(mapped.data, mapped.length, storage, mapped.mapping);
+    }
+    return ChunkSerializer::decode(payload.data(), payload.size(), storage);
+}
+
+// Queue a snapshot of a chunk to be written
+void WorldSave::saveChunk(const sf::Vector2i& chunkPosition, ChunkStorage storage) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        pending[chunkPosition] = std::move(storage);
+    }
+    pendingCondition.notify_one();
+}
+
+// Block until every queued snapshot has been written
+void WorldSave::flush() {
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    writtenCondition.wait(lock, [this] { return pending.empty() && !writingChunk; });
+}
+
+// Get the save counters
+WorldSave::Stats WorldSave::getStats() const {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return {pending.size(), chunksWritten.load(), bytesWritten.load(), chunksLoaded.load(), chunksMapped.load(),
+            failed.size(), writeFailures.load()};
+}
+
+// Queue the snapshots whose write failed again
+void WorldSave::retryFailed() {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (failed.empty()) return;
+        for (auto& [chunkPosition, storage] : failed) {
+            pending.try_emplace(chunkPosition, std::move(storage));
+        }
+        failed.clear();
+    }
+    pendingCondition.notify_one();
+}
+
+// Main loop of the I/O thread: take a snapshot, encode it and write it to its region
+void WorldSave::ioLoop() {
+    std::unique_lock<std::mutex> lock(pendingMutex);
+
+    while (true) {
+        pendingCondition.wait(lock, [this] { return !running || !pending.empty(); });
+        if (pending.empty()) return;  // Only stops once everything is written
+
+        auto node = pending.extract(pending.begin());
+        writingChunk = node.key();
+        lock.unlock();
+
+        std::vector<std::uint8_t> payload = ChunkSerializer::encode(node.mapped());
+        bool written;
+        {
+            std::lock_guard<std::mutex> regionLock(regionMutex);
+            RegionFile* region = getRegion(node.key(), true);
+            written = region && region->writeChunk(RegionFile::toLocal(node.key().x), RegionFile::toLocal(node.key().y), payload);
+        }
+        if (written) {
+            chunksWritten++;
+            bytesWritten += payload.size();
+        } else {
+            writeFailures++;
+            std::fprintf(stderr, "Could not save chunk (%d, %d) in %s, it is kept for the next save\n", node.key().x,
+                         node.key().y, directory.c_str());
+        }
+
+        lock.lock();
+        if (written) {
+            failed.erase(node.key());  // An older snapshot that failed is replaced by this one
+        } else if (!pending.count(node.key())) {
+            failed.insert_or_assign(node.key(), std::move(node.mapped()));  // Unless a newer snapshot is already queued
+        }
+        writingChunk.reset();
+        writtenCondition.notify_all();
+    }
+}
+
+// Get the region file containing a chunk
+RegionFile* WorldSave::getRegion(const sf::Vector2i& chunkPosition, bool create) {
+    sf::Vector2i regionPosition(RegionFile::toRegion(chunkPosition.x), RegionFile::toRegion(chunkPosition.y));
+
+    auto it = regions.find(regionPosition);
+    if (it == regions.end()) {
+        std::string path = (std::filesystem::path(directory) / RegionFile::fileName(regionPosition.x, regionPosition.y)).string();
+        if (!create && !std::filesystem::exists(path)) return nullptr;  // Loading does not create empty regions
+
+        it = regions.emplace(regionPosition, std::make_unique<RegionFile>(path)).first;
+    }
+    if (!it->second->isOpen()) {
+        regions.erase(it);  // Open it again next time, the error may be gone by the retry
+        return nullptr;
+    }
+    return it->second.get();
+}
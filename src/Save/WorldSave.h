@@ -0,0 +1,110 @@
+#ifndef MINECRAFTCLONE_WORLDSAVE_H
+#define MINECRAFTCLONE_WORLDSAVE_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <SFML/System/Vector2.hpp>
+#include "RegionFile.h"
+#include "../Core/ChunkStorage.h"
+#include "../Utils/Math.h"
+
+// Saved world on disk: a folder with the world seed and one region file per 32x32 chunks. Chunks are
+// handed over as snapshots and encoded and written on a background I/O thread; loads can be made from
+// any thread and see snapshots that are still waiting to be written. A snapshot whose write fails (disk full,
+// I/O error) is kept, still visible to loads, until retryFailed queues it again.
+//
+// Loads decode chunks straight from memory mappings of the region files by default: only the pages of
+// the chunks that are loaded are read from disk, and packed sections keep pointing into the mapping
+// until they are first modified. The buffered mode reads each payload into a heap buffer instead.
+class WorldSave {
+public:
+    // How chunk payloads are read from the region files
+    enum class ReadMode {
+        MAPPED,
+        BUFFERED
+    };
+
+    // Counters of the saves
+    struct Stats {
+        std::size_t pendingChunks = 0;      // Snapshots waiting for the I/O thread
+        std::uint64_t chunksWritten = 0;
+        std::uint64_t bytesWritten = 0;     // Encoded payload bytes
+        std::uint64_t chunksLoaded = 0;     // Chunks read from region files
+        std::uint64_t chunksMapped = 0;     // Chunks decoded from a mapped region file
+        std::size_t failedChunks = 0;       // Snapshots whose write failed, waiting for a retry
+        std::uint64_t writeFailures = 0;    // Writes that failed since the save was opened
+    };
+
+    // Open (or create) a save folder and start the I/O thread
+    explicit WorldSave(const std::string& directory, ReadMode readMode = ReadMode::MAPPED);
+
+    // Write the snapshots that are still queued and stop the I/O thread
+    ~WorldSave();
+
+    WorldSave(const WorldSave&) = delete;
+    WorldSave& operator=(const WorldSave&) = delete;
+
+    // Read the seed stored in a save folder (empty if the folder holds no world yet)
+    static std::optional<unsigned int> readSeed(const std::string& directory);
+
+    // Store the seed of the world
+    bool writeSeed(unsigned int seed);
+
+    // Load a chunk, returns false if it has never been saved
+    bool loadChunk(const sf::Vector2i& chunkPosition, ChunkStorage& storage);
+
+    // Queue a snapshot of a chunk to be written (replaces an older snapshot of the same chunk still queued)
+    void saveChunk(const sf::Vector2i& chunkPosition, ChunkStorage storage);
+
+    // Block until every queued snapshot has been written (or has failed)
+    void flush();
+
+    // Queue the snapshots whose write failed again (a newer snapshot of the same chunk replaces them)
+    void retryFailed();
+
+    // Get the save counters
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    const std::string directory;
+    const ReadMode readMode;
+
+    // Snapshots waiting for the I/O thread
+    std::unordered_map<sf::Vector2i, ChunkStorage> pending;
+    std::unordered_map<sf::Vector2i, ChunkStorage> failed;  // Snapshots whose write failed
+    std::optional<sf::Vector2i> writingChunk;  // Chunk the I/O thread took from pending and is writing
+    bool running;
+    mutable std::mutex pendingMutex;
+    std::condition_variable pendingCondition;  // Signalled when a snapshot is queued or the thread stops
+    std::condition_variable writtenCondition;  // Signalled when the I/O thread finishes writing a chunk
+
+    // Open region files, shared by the I/O thread and the threads loading chunks
+    std::unordered_map<sf::Vector2i, std::unique_ptr<RegionFile>> regions;
+    std::mutex regionMutex;
+
+    std::atomic<std::uint64_t> chunksWritten;
+    std::atomic<std::uint64_t> bytesWritten;
+    std::atomic<std::uint64_t> chunksLoaded;
+    std::atomic<std::uint64_t> chunksMapped;
+    std::atomic<std::uint64_t> writeFailures;
+
+    std::thread ioThread;
+
+    // Main loop of the I/O thread
+    void ioLoop();
+
+    // Get the region file containing a chunk, nullptr if it cannot be opened or does not exist and
+    // create is false (regionMutex must be held)
+    RegionFile* getRegion(const sf::Vector2i& chunkPosition, bool create);
+};
+
+
+#endif
@@ -0,0 +1,38 @@
+#include "Assets.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <climits>
+#include <unistd.h>
+#endif
+
+namespace {
+    // Get the folder containing the running executable
+    std::string getExecutableDirectory() {
+#ifdef _WIN32
+        char buffer[MAX_PATH];
+        DWORD length = GetModuleFileNameA(nullptr, buffer, MAX_PATH);
+#else
+        char buffer[PATH_MAX];
+        ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+        if (length < 0) return ".";
+#endif
+        std::string path(buffer, static_cast<std::size_t>(length));
+        return path.substr(0, path.find_last_of("/\\"));
+    }
+}
+
+Assets *Assets::assets = nullptr;
+
+Assets::Assets() : executableDirectory(getExecutableDirectory()) {
+    font.loadFromFile(executableDirectory + "/assets/fonts/roboto.ttf");
+}
+
+Assets &Assets::get() {
+    if (assets == nullptr) {
+        assets = new Assets();
+    }
+
+    return *assets;
+}
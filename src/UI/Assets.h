@@ -0,0 +1,26 @@
+#ifndef MINECRAFTCLONE_ASSETS_H
+#define MINECRAFTCLONE_ASSETS_H
+
+
+#include <string>
+#include <SFML/Graphics/Font.hpp>
+
+// Resources of the user interface, loaded once from the assets folder next to the executable
+class Assets {
+public:
+    sf::Font font;
+
+    // Folder containing the executable
+    std::string executableDirectory;
+
+private:
+    static Assets* assets;
+    Assets();
+
+public:
+    Assets(const Assets& other) = default;
+    static Assets& get();
+};
+
+
+#endif
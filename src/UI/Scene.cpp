@@ -1,6 +1,9 @@
 #include "Scene.h"
 #include "../Config.h"
+#include "../Render/Projection.h"
+#include "../Utils/Profiler.h"
 
+#include <algorithm>
 #include <utility>
 
 const std::function<void(Scene*)>& Scene::getSceneChanger() const {
@@ -35,7 +38,7 @@ MenuScene::MenuScene(std::function<void(Scene *)> sceneChanger, sf::RenderWindow
 
 void MenuScene::update(float& deltaTime) {}
 
-void MenuScene::render() const
+void MenuScene::render(float /* alpha */) const
 {
     layout.render(window);
 }
@@ -50,35 +53,55 @@ void MenuScene::onClick(sf::Vector2f position) {
 
 void MenuScene::onResize(unsigned int width, unsigned int height) {}
 
-GameScene::GameScene(std::function<void(Scene*)> sceneChanger, sf::RenderWindow& window) : Scene(std::move(sceneChanger), window), world() {
+GameScene::GameScene(std::function<void(Scene*)> sceneChanger, sf::RenderWindow& window)
+        : Scene(std::move(sceneChanger), window), world(Config::World::SAVE_DIRECTORY), worldRenderer(world.getJobSystem()) {
     // Setup OpenGL perspective matrix
     float fov = Config::Player::FOV;
     float aspectRatio = static_cast<float>(Config::Window::WIDTH) / static_cast<float>(Config::Window::HEIGHT);
     float nearPlane = 0.1f;
     float farPlane = 100.f;
 
+    // Far enough to reach the corners of the farthest chunks at the longest render distance (distant ones are cheap
+    // to draw at a lower level of detail)
+    farPlane = std::max(farPlane, 1.5f * (Config::World::MAX_RENDER_DISTANCE + 1) * Config::World::CHUNK_SIZE);
+
     // Set the perspective matrix for the game
-    Math::setPerspectiveMatrix(fov, aspectRatio, nearPlane, farPlane);
+    Projection::setPerspectiveMatrix(fov, aspectRatio, nearPlane, farPlane);
 
     // Lock the mouse to the center of the window
     player.lockMouse(window);
 
     // World initialization
-    world.init();
+    world.init(player.getPosition());
 }
 
 void GameScene::update(float& deltaTime) {
+    PROFILE_ZONE("Scene::update");
+
     player.update(deltaTime, window, world);  // Update the player based on input
 
-    world.update(deltaTime);  // Update the world
+    world.tick(deltaTime);  // Advance the time of day
+}
+
+void GameScene::frame(float frameTime) {
+    PROFILE_ZONE("Scene::frame");
+
+    player.handleMouseInput(window);  // Look around every frame, the mouse is not quantised to ticks
+
+    world.update(frameTime, player.getPosition());  // Stream chunks around the player within the frame budget
 }
 
-void GameScene::render() const {
+void GameScene::render(float alpha) const {
+    PROFILE_ZONE("Scene::render");
+
     // Render the 3D world (with the player’s transformations applied)
-    player.apply();  // Apply player transformations (camera)
+    player.apply(alpha);  // Apply player transformations (camera, between the last two ticks)
 
-    // Render the world in 3D
-    world.render(player.getPosition());
+    // Render the world in 3D, remeshing the block under the crosshair first
+    std::optional<sf::Vector3i> lookedAtBlock;
+    sf::Vector3i blockPos = std::get<0>(player.raycast(world));
+    if (blockPos != sf::Vector3i(-1000, -1000, -1000)) lookedAtBlock = blockPos;
+    worldRenderer.render(world, player.getPosition(), lookedAtBlock);
 
     // Render the crosshair
     player.render(window);
@@ -90,3 +113,15 @@ void GameScene::onResize(unsigned int width, unsigned int height) {}
 void GameScene::onClick(sf::Vector2f position) {
     player.lockMouse(window);
 }
+
+void GameScene::onKeyPress(sf::Keyboard::Key key) {
+    // Change the render distance, the renderer picks the rings of detail for it
+    if (key == sf::Keyboard::PageUp) world.setRenderDistance(world.getRenderDistance() + 1);
+    if (key == sf::Keyboard::PageDown) world.setRenderDistance(world.getRenderDistance() - 1);
+}
+
+void GameScene::onClose() {
+    // Write the edited chunks before the game exits
+    world.saveChanges();
+    world.waitForSaves();
+}
@@ -8,6 +8,7 @@
 #include "../Core/Block.h"
 #include "../Core/World.h"
 #include "../Player/Player.h"
+#include "../Render/WorldRenderer.h"
 
 class Scene {
 private:
@@ -21,11 +22,23 @@ protected:
 public:
     explicit Scene(std::function<void(Scene*)> sceneChanger, sf::RenderWindow& window);
 
+    // Run one simulation tick of deltaTime seconds
     virtual void update(float& deltaTime) = 0;
-    virtual void render() const = 0;
+
+    // Do the work budgeted per frame, once per frame after the ticks (frameTime is the real time since the last frame)
+    virtual void frame(float /* frameTime */) {}
+
+    // Draw the scene, alpha of the way from the previous tick to the last one
+    virtual void render(float alpha) const = 0;
 
     virtual void onResize(unsigned int width, unsigned int height) = 0;
     virtual void onClick(sf::Vector2f position) = 0;
+
+    // Called when a key is pressed (the keys the game handles itself are not passed on)
+    virtual void onKeyPress(sf::Keyboard::Key /* key */) {}
+
+    // Called when the window is about to close
+    virtual void onClose() {}
 };
 
 class MenuScene : public Scene {
@@ -34,7 +47,7 @@ public:
     explicit MenuScene(std::function<void(Scene *)> sceneChanger, sf::RenderWindow& window);
 
     void update(float& deltaTime) override;
-    void render() const override;
+    void render(float alpha) const override;
 
     void onResize(unsigned int width, unsigned int height) override;
     void onClick(sf::Vector2f position) override;
@@ -43,14 +56,18 @@ public:
 class GameScene : public Scene {
     World world;  // The game world that contains blocks
     Player player;  // The player to move around the world
+    mutable WorldRenderer worldRenderer;  // Draws the world (its mesh cache is updated while rendering)
 public:
     explicit GameScene(std::function<void(Scene*)> sceneChanger, sf::RenderWindow& window);
 
     void update(float& deltaTime) override;
-    void render() const override;
+    void frame(float frameTime) override;
+    void render(float alpha) const override;
 
     void onResize(unsigned int width, unsigned int height) override;
     void onClick(sf::Vector2f position) override;
+    void onKeyPress(sf::Keyboard::Key key) override;
+    void onClose() override;
 };
 
 
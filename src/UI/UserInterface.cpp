@@ -1,4 +1,5 @@
 #include "UserInterface.h"
+#include "Assets.h"
 #include "../Config.h"
 
 sf::Vector2f UI::Widget::getPosition() const {
@@ -37,7 +38,7 @@ UI::Button::Button(const std::string& text) {
     buttonText.setString(text);
     buttonText.setCharacterSize(fontSize);
     buttonText.setFillColor(textColor);
-    buttonText.setFont(Config::Assets::get().font);
+    buttonText.setFont(Assets::get().font);
     buttonText.setPosition(position.x + size.x / 2 - buttonText.getGlobalBounds().width / 2, position.y + size.y / 2 - buttonText.getGlobalBounds().height / 2);
 }
 
@@ -111,7 +112,7 @@ UI::Label::Label(const std::string text) {
     labelText.setCharacterSize(fontSize);
     labelText.setFillColor(textColor);
     labelText.setPosition(position);
-    labelText.setFont(Config::Assets::get().font);
+    labelText.setFont(Assets::get().font);
 }
 
 void UI::Label::update(float& deltaTime) {}
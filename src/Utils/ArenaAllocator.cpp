@@ -0,0 +1,150 @@
+#include <algorithm>
+#include "ArenaAllocator.h"
+
+ArenaAllocator::ArenaAllocator(std::size_t capacity, std::size_t alignment) : capacity(0), alignment(alignment) {
+    grow(capacity);
+}
+
+// Allocate size units with the smallest free range that fits them
+std::optional<ArenaAllocator::Handle> ArenaAllocator::allocate(std::size_t size) {
+    std::size_t aligned = align(size);
+    if (aligned == 0) return std::nullopt;
+
+    auto best = freeBySize.lower_bound({aligned, 0});
+    if (best == freeBySize.end()) return std::nullopt;
+
+    // Take the front of the range, the rest of it stays free
+    std::size_t offset = best->second;
+    std::size_t rangeSize = best->first;
+    removeFree(freeByOffset.find(offset));
+    if (rangeSize > aligned) {
+        freeByOffset[offset + aligned] = rangeSize - aligned;
+        freeBySize.insert({rangeSize - aligned, offset + aligned});
+    }
+
+    Handle handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(allocations.size());
+        allocations.emplace_back();
+    }
+    allocations[handle] = {offset, aligned};
+    used += aligned;
+    return handle;
+}
+
+// Free an allocation
+void ArenaAllocator::free(Handle handle) {
+    Allocation& allocation = allocations[handle];
+    used -= allocation.size;
+    addFree(allocation.offset, allocation.size);
+    allocation.size = 0;
+    freeHandles.push_back(handle);
+}
+
+// Slide the allocations to the front of the arena, returns the ones moved
+std::vector<ArenaAllocator::Move> ArenaAllocator::compact() {
+    std::vector<Handle> live;
+    for (Handle handle = 0; handle < allocations.size(); handle++) {
+        if (allocations[handle].size > 0) live.push_back(handle);
+    }
+    std::sort(live.begin(), live.end(), [&](Handle a, Handle b) {
+        return allocations[a].offset < allocations[b].offset;
+    });
+
+    std::vector<Move> moves;
+    std::size_t end = 0;
+    for (Handle handle : live) {
+        Allocation& allocation = allocations[handle];
+        if (allocation.offset != end) {
+            moves.push_back({handle, allocation.offset, end, allocation.size});
+            allocation.offset = end;
+        }
+        end += allocation.size;
+    }
+
+    freeByOffset.clear();
+    freeBySize.clear();
+    if (end < capacity) addFree(end, capacity - end);
+    return moves;
+}
+
+// Add free space at the end of the arena
+void ArenaAllocator::grow(std::size_t newCapacity) {
+    newCapacity = align(newCapacity);
+    if (newCapacity <= capacity) return;
+
+    std::size_t previous = capacity;
+    capacity = newCapacity;
+    addFree(previous, capacity - previous);
+}
+
+std::size_t ArenaAllocator::getOffset(Handle handle) const {
+    return allocations[handle].offset;
+}
+
+// Get the size of an allocation, rounded up to the alignment
+std::size_t ArenaAllocator::getSize(Handle handle) const {
+    return allocations[handle].size;
+}
+
+std::size_t ArenaAllocator::getCapacity() const {
+    return capacity;
+}
+
+std::size_t ArenaAllocator::getUsed() const {
+    return used;
+}
+
+std::size_t ArenaAllocator::getAllocationCount() const {
+    return allocations.size() - freeHandles.size();
+}
+
+std::size_t ArenaAllocator::getFreeRangeCount() const {
+    return freeByOffset.size();
+}
+
+std::size_t ArenaAllocator::getLargestFree() const {
+    return freeBySize.empty() ? 0 : freeBySize.rbegin()->first;
+}
+
+// Get the share of the free space outside the largest free range
+float ArenaAllocator::getFragmentation() const {
+    std::size_t free = capacity - used;
+    if (free == 0) return 0.0f;
+    return 1.0f - static_cast<float>(getLargestFree()) / static_cast<float>(free);
+}
+
+// Round a size up to the alignment
+std::size_t ArenaAllocator::align(std::size_t size) const {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// Add a free range, merged with the free ranges right before and after it
+void ArenaAllocator::addFree(std::size_t offset, std::size_t size) {
+    auto next = freeByOffset.lower_bound(offset);
+    if (next != freeByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        removeFree(next);
+    }
+
+    auto previous = freeByOffset.lower_bound(offset);
+    if (previous != freeByOffset.begin()) {
+        --previous;
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            removeFree(previous);
+        }
+    }
+
+    freeByOffset[offset] = size;
+    freeBySize.insert({size, offset});
+}
+
+void ArenaAllocator::removeFree(std::map<std::size_t, std::size_t>::iterator range) {
+    freeBySize.erase({range->second, range->first});
+    freeByOffset.erase(range);
+}
@@ -0,0 +1,85 @@
+#ifndef MINECRAFTCLONE_ARENAALLOCATOR_H
+#define MINECRAFTCLONE_ARENAALLOCATOR_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Suballocates ranges of one large buffer (in any unit: bytes, vertices, indices). Free ranges are kept
+// sorted by offset, so a freed range merges with its free neighbours, and by size, so an allocation takes
+// the smallest free range that fits it (best fit). Allocations are named by handles that stay valid when
+// compact() slides every allocation to the front of the buffer to gather the free space in one range.
+// Holds no data: the owner of the buffer applies the moves compact() returns.
+class ArenaAllocator {
+public:
+    using Handle = std::uint32_t;
+
+    // An allocation moved by compact(): size units from one offset to a lower one
+    struct Move {
+        Handle handle;
+        std::size_t from;
+        std::size_t to;
+        std::size_t size;
+    };
+
+    // Arena of capacity units, allocations start on multiples of alignment and are rounded up to it
+    explicit ArenaAllocator(std::size_t capacity, std::size_t alignment = 1);
+
+    // Allocate size units, or nothing if no free range is large enough (compacting or growing may help)
+    std::optional<Handle> allocate(std::size_t size);
+
+    // Free an allocation, its handle may be reused
+    void free(Handle handle);
+
+    // Slide the allocations to the front of the arena in the order of their offsets, returns the ones moved.
+    // Moves are returned by increasing offset, each one lands below every range not moved yet.
+    std::vector<Move> compact();
+
+    // Add free space at the end of the arena (capacity is rounded up to the alignment)
+    void grow(std::size_t capacity);
+
+    [[nodiscard]] std::size_t getOffset(Handle handle) const;
+
+    // Get the size of an allocation, rounded up to the alignment
+    [[nodiscard]] std::size_t getSize(Handle handle) const;
+
+    [[nodiscard]] std::size_t getCapacity() const;
+    [[nodiscard]] std::size_t getUsed() const;
+    [[nodiscard]] std::size_t getAllocationCount() const;
+    [[nodiscard]] std::size_t getFreeRangeCount() const;
+    [[nodiscard]] std::size_t getLargestFree() const;
+
+    // Get the share of the free space outside the largest free range (0: all of it in one range)
+    [[nodiscard]] float getFragmentation() const;
+
+private:
+    struct Allocation {
+        std::size_t offset;
+        std::size_t size;  // 0 for a freed handle
+    };
+
+    std::size_t capacity;
+    std::size_t alignment;
+    std::size_t used = 0;
+
+    std::vector<Allocation> allocations;  // Indexed by handle
+    std::vector<Handle> freeHandles;
+    std::map<std::size_t, std::size_t> freeByOffset;             // Offset -> size of the free ranges
+    std::set<std::pair<std::size_t, std::size_t>> freeBySize;    // (size, offset) of the same ranges
+
+    // Round a size up to the alignment
+    [[nodiscard]] std::size_t align(std::size_t size) const;
+
+    // Add a free range, merged with the free ranges right before and after it
+    void addFree(std::size_t offset, std::size_t size);
+
+    void removeFree(std::map<std::size_t, std::size_t>::iterator range);
+};
+
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef MINECRAFTCLONE_COMPLETIONQUEUE_H
+#define MINECRAFTCLONE_COMPLETIONQUEUE_H
+
+
+#include <atomic>
+#include <utility>
+
+// Lock-free multi-producer, single-consumer queue (Vyukov's linked list queue).
+// Worker threads push finished results, the main thread pops them.
+template <typename T>
+class CompletionQueue {
+public:
+    CompletionQueue() : head(new Node()), tail(head.load()) {}
+
+    ~CompletionQueue() {
+        while (tail) {
+            Node* next = tail->next.load();
+            delete tail;
+            tail = next;
+        }
+    }
+
+    CompletionQueue(const CompletionQueue&) = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    // Push a value (any thread)
+    void push(T value) {
+        Node* node = new Node();
+        node->value = std::move(value);
+
+        Node* previous = head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Pop the oldest value if there is one (consumer thread only)
+    bool tryPop(T& value) {
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+
+        // The popped node becomes the new sentinel
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node*> head;  // Last pushed node (producers)
+    Node* tail;               // Sentinel before the oldest value (consumer)
+};
+
+
+#endif
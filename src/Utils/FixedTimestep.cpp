@@ -0,0 +1,58 @@
+#include <algorithm>
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(float tickRate, int maxTicksPerFrame)
+        : ticksPerSecond(tickRate), tickTime(1.0f / tickRate), maxTicksPerFrame(std::max(maxTicksPerFrame, 1)) {}
+
+// Add the real time of a frame and get the number of ticks to run for it
+int FixedTimestep::advance(float frameTime) {
+    frameTime = std::max(frameTime, 0.0f);
+    accumulator += frameTime;
+
+    int ticks = static_cast<int>(accumulator * ticksPerSecond);
+    accumulator -= ticks / ticksPerSecond;
+
+    // Drop what a single frame cannot catch up, keeping the fraction of a tick for the interpolation
+    if (ticks > maxTicksPerFrame) {
+        droppedTicks += ticks - maxTicksPerFrame;
+        ticks = maxTicksPerFrame;
+    }
+
+    windowTicks += ticks;
+    windowFrames++;
+    window += frameTime;
+    if (window >= 1.0) {
+        measuredTickRate = static_cast<float>(windowTicks / window);
+        measuredFrameRate = static_cast<float>(windowFrames / window);
+        windowTicks = 0;
+        windowFrames = 0;
+        window = 0.0;
+    }
+
+    return ticks;
+}
+
+// Get the length of a tick in seconds
+float FixedTimestep::getTickTime() const {
+    return tickTime;
+}
+
+// Get the fraction of a tick since the last one
+float FixedTimestep::getAlpha() const {
+    return std::clamp(static_cast<float>(accumulator * ticksPerSecond), 0.0f, 1.0f);
+}
+
+// Get the ticks run per second over the last full second
+float FixedTimestep::getMeasuredTickRate() const {
+    return measuredTickRate;
+}
+
+// Get the frames per second over the last full second
+float FixedTimestep::getMeasuredFrameRate() const {
+    return measuredFrameRate;
+}
+
+// Get the ticks dropped after hitches since the start
+long long FixedTimestep::getDroppedTicks() const {
+    return droppedTicks;
+}
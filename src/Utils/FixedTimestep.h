@@ -0,0 +1,50 @@
+#ifndef MINECRAFTCLONE_FIXEDTIMESTEP_H
+#define MINECRAFTCLONE_FIXEDTIMESTEP_H
+
+
+// Turns the real time of the frames into ticks of a fixed length, so the simulation steps the same way at any
+// frame rate. The time of each frame goes into an accumulator and a tick is taken for every full tick length
+// in it; the fraction of a tick left over tells the renderer how far to interpolate between the last two ticks.
+// A frame runs at most a fixed number of ticks: after a hitch the rest of the time is dropped, and the
+// simulation runs slower for a moment instead of falling further behind.
+// Tick and frame rates are measured over one second windows of real time.
+class FixedTimestep {
+public:
+    // Ticks of 1 / tickRate seconds, at most maxTicksPerFrame of them for one frame
+    FixedTimestep(float tickRate, int maxTicksPerFrame);
+
+    // Add the real time of a frame and get the number of ticks to run for it
+    int advance(float frameTime);
+
+    // Get the length of a tick in seconds
+    [[nodiscard]] float getTickTime() const;
+
+    // Get the fraction of a tick since the last one, from 0 to 1 (0 = draw the last tick, 1 = the next one)
+    [[nodiscard]] float getAlpha() const;
+
+    // Get the ticks run per second over the last full second
+    [[nodiscard]] float getMeasuredTickRate() const;
+
+    // Get the frames per second over the last full second
+    [[nodiscard]] float getMeasuredFrameRate() const;
+
+    // Get the ticks dropped after hitches since the start
+    [[nodiscard]] long long getDroppedTicks() const;
+
+private:
+    double ticksPerSecond;
+    float tickTime;
+    int maxTicksPerFrame;
+    double accumulator = 0.0;   // Real time not simulated yet, less than a tick after each frame
+    long long droppedTicks = 0;
+
+    // Ticks and frames counted over the current one second window, and the rates of the last full window
+    int windowTicks = 0;
+    int windowFrames = 0;
+    double window = 0.0;
+    float measuredTickRate = 0.0f;
+    float measuredFrameRate = 0.0f;
+};
+
+
+#endif
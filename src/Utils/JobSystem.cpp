@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <string>
+#include "JobSystem.h"
+#include "Profiler.h"
+
+JobSystem::JobSystem(unsigned int workerCount) : nextWorker(0), queuedJobs(0), unfinishedJobs(0), running(true) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    // Start the threads once every deque exists, so workers can steal from each other right away
+    for (unsigned int i = 0; i < workerCount; i++) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+// Queue a job on one of the workers
+void JobSystem::submit(Job job) {
+    unfinishedJobs++;
+
+    Worker& worker = *workers[nextWorker++ % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+    queuedJobs++;
+
+    // Take the sleep mutex so a worker that just found nothing to do cannot miss the notification
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeCondition.notify_one();
+}
+
+// Block until every submitted job has finished
+void JobSystem::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idleCondition.wait(lock, [this] { return unfinishedJobs == 0; });
+}
+
+// Run a body over [0, count) in ranges of grainSize, on the workers and the calling thread
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)>& body) {
+    if (count == 0) return;
+    grainSize = std::max<std::size_t>(grainSize, 1);
+
+    // Shared with the helper jobs, which may only start after the loop has finished and returned
+    struct Range {
+        std::atomic<std::size_t> next{0};
+        std::atomic<std::size_t> done{0};
+        std::size_t count = 0;
+        std::size_t grainSize = 0;
+        std::function<void(std::size_t, std::size_t)> body;
+    };
+    auto range = std::make_shared<Range>();
+    range->count = count;
+    range->grainSize = grainSize;
+    range->body = body;
+
+    auto run = [range] {
+        for (;;) {
+            std::size_t begin = range->next.fetch_add(range->grainSize);
+            if (begin >= range->count) return;
+
+            std::size_t end = std::min(begin + range->grainSize, range->count);
+            range->body(begin, end);
+            range->done.fetch_add(end - begin, std::memory_order_release);
+        }
+    };
+
+    std::size_t ranges = (count + grainSize - 1) / grainSize;
+    std::size_t helpers = std::min<std::size_t>(workers.size(), ranges - 1);
+    for (std::size_t i = 0; i < helpers; i++) {
+        submit(run);
+    }
+
+    run();
+
+    // Wait for the ranges other threads are still running
+    while (range->done.load(std::memory_order_acquire) < count) {
+        std::this_thread::yield();
+    }
+}
+
+// Get the number of worker threads
+unsigned int JobSystem::getWorkerCount() const {
+    return static_cast<unsigned int>(workers.size());
+}
+
+// Main loop of a worker thread
+void JobSystem::workerLoop(unsigned int index) {
+    Profiler::setThreadName("worker " + std::to_string(index));
+
+    while (running) {
+        Job job;
+
+        if (takeJob(index, job)) {
+            job();
+
+            if (--unfinishedJobs == 0) {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                idleCondition.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing to run or steal, sleep until a job is submitted
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeCondition.wait(lock, [this] { return !running || queuedJobs > 0; });
+    }
+}
+
+// Take a job from the worker's own deque (newest first) or steal the oldest job of another worker
+bool JobSystem::takeJob(unsigned int index, Job& job) {
+    {
+        Worker& own = *workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queuedJobs--;
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < workers.size(); offset++) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs--;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,68 @@
+#ifndef MINECRAFTCLONE_JOBSYSTEM_H
+#define MINECRAFTCLONE_JOBSYSTEM_H
+
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads with one job deque per worker. A worker pops its own
+// newest job first and steals the oldest job of another worker when it runs dry.
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    // Create the pool (0 workers means one per hardware thread)
+    explicit JobSystem(unsigned int workerCount = 0);
+
+    // Stop the workers; jobs that have not started yet are dropped
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Queue a job on one of the workers (can be called from any thread)
+    void submit(Job job);
+
+    // Block until every submitted job has finished
+    void wait();
+
+    // Run a body over [0, count) split into ranges of grainSize, on the workers and the calling thread.
+    // Returns once every range has run; the caller keeps working instead of waiting on unrelated jobs.
+    void parallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t begin, std::size_t end)>& body);
+
+    // Get the number of worker threads
+    [[nodiscard]] unsigned int getWorkerCount() const;
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<unsigned int> nextWorker;  // Round-robin target for submitted jobs
+    std::atomic<int> queuedJobs;           // Jobs waiting in a deque
+    std::atomic<int> unfinishedJobs;       // Jobs submitted but not finished yet
+    std::atomic<bool> running;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;  // Signalled when jobs are submitted
+    std::condition_variable idleCondition;  // Signalled when the last job finishes
+
+    // Main loop of a worker thread
+    void workerLoop(unsigned int index);
+
+    // Take a job from the worker's own deque or steal one from another worker
+    bool takeJob(unsigned int index, Job& job);
+};
+
+
+#endif
@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// Map a file. The file is opened with every share mode so the region writer can keep its own handle.
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0), fileHandle(nullptr), mappingHandle(nullptr) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return;  // Empty files cannot be mapped
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return;
+    mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) return;
+
+    bytes = static_cast<const std::uint8_t*>(view);
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+// Unmap the file
+MappedFile::~MappedFile() {
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+}
+
+#else
+
+// Map a file. The descriptor can be closed right away, the mapping keeps the file alive.
+MappedFile::MappedFile(const std::string& path) : bytes(nullptr), length(0) {
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return;
+
+    struct stat status {};
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+        if (view != MAP_FAILED) {
+            // Only the pages that are touched are wanted, do not read around them
+            madvise(view, static_cast<std::size_t>(status.st_size), MADV_RANDOM);
+            bytes = static_cast<const std::uint8_t*>(view);
+            length = static_cast<std::size_t>(status.st_size);
+        }
+    }
+    close(descriptor);
+}
+
+// Unmap the file
+MappedFile::~MappedFile() {
+    if (bytes) munmap(const_cast<std::uint8_t*>(bytes), length);
+}
+
+#endif
+
+// Check if the file is mapped
+bool MappedFile::isOpen() const {
+    return bytes != nullptr;
+}
+
+// Get the mapped bytes
+const std::uint8_t* MappedFile::data() const {
+    return bytes;
+}
+
+// Get the number of mapped bytes
+std::size_t MappedFile::size() const {
+    return length;
+}
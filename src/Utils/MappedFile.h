@@ -0,0 +1,43 @@
+#ifndef MINECRAFTCLONE_MAPPEDFILE_H
+#define MINECRAFTCLONE_MAPPEDFILE_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap, or a file mapping view on Windows). Nothing is read
+// up front: a page is loaded from disk the first time it is touched. The mapping is shared with the
+// file, so data written to the file through another handle shows up in the mapped pages.
+class MappedFile {
+public:
+    // Map a file, isOpen() is false if it does not exist, is empty or cannot be mapped
+    explicit MappedFile(const std::string& path);
+
+    // Unmap the file
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Check if the file is mapped
+    [[nodiscard]] bool isOpen() const;
+
+    // Get the mapped bytes (page aligned)
+    [[nodiscard]] const std::uint8_t* data() const;
+
+    // Get the number of mapped bytes (the file size when it was mapped)
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    const std::uint8_t* bytes;
+    std::size_t length;
+
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+
+#endif
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "Math.h"
 
@@ -16,3 +17,123 @@ bool Math::AABB::intersects(const AABB &other) const {
            (max.y > other.min.y - epsilon && min.y < other.max.y + epsilon) &&
            (max.z > other.min.z - epsilon && min.z < other.max.z + epsilon);
 }
+
+Math::SweepResult Math::sweepAABB(const AABB &moving, const sf::Vector3f &displacement, const AABB &target) {
+    const float movingMin[3] = {moving.min.x, moving.min.y, moving.min.z};
+    const float movingMax[3] = {moving.max.x, moving.max.y, moving.max.z};
+    const float targetMin[3] = {target.min.x, target.min.y, target.min.z};
+    const float targetMax[3] = {target.max.x, target.max.y, target.max.z};
+    const float delta[3] = {displacement.x, displacement.y, displacement.z};
+
+    // Intersect the time intervals in which the boxes overlap on each axis
+    float entry = -INFINITY;
+    float exit = INFINITY;
+    int entryAxis = -1;
+
+    for (int axis = 0; axis < 3; axis++) {
+        float axisEntry, axisExit;
+        if (delta[axis] > 0.0f) {
+            axisEntry = (targetMin[axis] - movingMax[axis]) / delta[axis];
+            axisExit = (targetMax[axis] - movingMin[axis]) / delta[axis];
+        } else if (delta[axis] < 0.0f) {
+            axisEntry = (targetMax[axis] - movingMin[axis]) / delta[axis];
+            axisExit = (targetMin[axis] - movingMax[axis]) / delta[axis];
+        } else {
+            // Not moving on this axis: the boxes must already overlap on it
+            if (movingMax[axis] <= targetMin[axis] || movingMin[axis] >= targetMax[axis]) return {};
+            continue;
+        }
+
+        if (axisEntry > entry) {
+            entry = axisEntry;
+            entryAxis = axis;
+        }
+        exit = std::min(exit, axisExit);
+    }
+
+    if (entryAxis < 0 || entry > exit || entry < 0.0f || entry > 1.0f) return {};
+
+    SweepResult result;
+    result.hit = true;
+    result.time = entry;
+    float normal[3] = {0.0f, 0.0f, 0.0f};
+    normal[entryAxis] = delta[entryAxis] > 0.0f ? -1.0f : 1.0f;
+    result.normal = {normal[0], normal[1], normal[2]};
+    return result;
+}
+
+Math::Matrix4 Math::multiply(const Matrix4 &a, const Matrix4 &b) {
+    Matrix4 result{};
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int i = 0; i < 4; i++) {
+                sum += a[i * 4 + row] * b[column * 4 + i];
+            }
+            result[column * 4 + row] = sum;
+        }
+    }
+    return result;
+}
+
+Math::Matrix4 Math::perspectiveMatrix(float fov, float aspectRatio, float nearPlane, float farPlane) {
+    // glFrustum with a symmetric box, same bounds as Projection::setPerspectiveMatrix
+    float top = nearPlane * std::tan(fov * static_cast<float>(M_PI) / 360.0f);
+    float right = top * aspectRatio;
+
+    Matrix4 matrix{};
+    matrix[0] = nearPlane / right;
+    matrix[5] = nearPlane / top;
+    matrix[10] = -(farPlane + nearPlane) / (farPlane - nearPlane);
+    matrix[11] = -1.0f;
+    matrix[14] = -2.0f * farPlane * nearPlane / (farPlane - nearPlane);
+    return matrix;
+}
+
+Math::Matrix4 Math::viewMatrix(const sf::Vector3f &position, float yaw, float pitch) {
+    // Rotation around x by pitch, then around y by yaw, then the translation (the glRotatef/glTranslatef order)
+    float pitchRadians = pitch * static_cast<float>(M_PI) / 180.0f;
+    float yawRadians = yaw * static_cast<float>(M_PI) / 180.0f;
+    float cp = std::cos(pitchRadians), sp = std::sin(pitchRadians);
+    float cy = std::cos(yawRadians), sy = std::sin(yawRadians);
+
+    Matrix4 rotateX = {1, 0, 0, 0,  0, cp, sp, 0,  0, -sp, cp, 0,  0, 0, 0, 1};
+    Matrix4 rotateY = {cy, 0, -sy, 0,  0, 1, 0, 0,  sy, 0, cy, 0,  0, 0, 0, 1};
+    Matrix4 translate = {1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  -position.x, -position.y, -position.z, 1};
+    return multiply(multiply(rotateX, rotateY), translate);
+}
+
+Math::Frustum Math::Frustum::fromMatrix(const Matrix4 &viewProjection) {
+    // Each plane is the last row of the matrix plus or minus one of the other rows (Gribb and Hartmann)
+    auto row = [&](int index) {
+        return std::array<float, 4>{viewProjection[index], viewProjection[4 + index], viewProjection[8 + index],
+                                    viewProjection[12 + index]};
+    };
+    const std::array<float, 4> w = row(3);
+
+    Frustum frustum;
+    for (int i = 0; i < 6; i++) {
+        std::array<float, 4> axis = row(i / 2);
+        float sign = i % 2 == 0 ? 1.0f : -1.0f;
+        sf::Vector3f normal(w[0] + sign * axis[0], w[1] + sign * axis[1], w[2] + sign * axis[2]);
+        float distance = w[3] + sign * axis[3];
+
+        // Normalized so the plane equation gives the distance to the plane
+        float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        frustum.planes[i] = {normal / length, distance / length};
+    }
+    return frustum;
+}
+
+bool Math::Frustum::intersects(const AABB &box) const {
+    for (const Plane &plane : planes) {
+        // The corner furthest along the normal is the last one to leave the inside of the plane
+        sf::Vector3f corner(plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                            plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                            plane.normal.z >= 0.0f ? box.max.z : box.min.z);
+        if (plane.normal.x * corner.x + plane.normal.y * corner.y + plane.normal.z * corner.z + plane.distance < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
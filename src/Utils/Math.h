@@ -2,25 +2,16 @@
 #define MINECRAFTCLONE_UTILS_H
 
 
-#include <SFML/OpenGL.hpp>
 #include <SFML/System/Vector3.hpp>
+#include <array>
 #include <functional>
 #include <cmath>
 #include <SFML/System/Vector2.hpp>
 
 namespace Math {
-    // Custom gluPerspective function
-    void static setPerspectiveMatrix(float fov, float aspectRatio, float nearPlane, float farPlane) {
-        float top = nearPlane * tan(fov * M_PI / 360.0);
-        float bottom = -top;
-        float right = top * aspectRatio;
-        float left = -right;
-
-        glMatrixMode(GL_PROJECTION);
-        glLoadIdentity();
-        glFrustum(left, right, bottom, top, nearPlane, farPlane);
-        glMatrixMode(GL_MODELVIEW);
-        glLoadIdentity();
+    // Integer division rounding towards negative infinity (block to chunk coordinates)
+    inline int floorDiv(int value, int divisor) {
+        return (value < 0) ? (value - divisor + 1) / divisor : value / divisor;
     }
 
     // Axis-aligned bounding box (AABB) for collision detection
@@ -36,6 +27,46 @@ namespace Math {
 
         [[nodiscard]] bool intersects(const AABB &other) const;
     };
+
+    // Result of sweeping an AABB along a displacement
+    struct SweepResult {
+        bool hit = false;
+        float time = 1.0f;                  // Fraction of the displacement travelled before the contact
+        sf::Vector3f normal = {0, 0, 0};    // Normal of the face that was hit
+    };
+
+    // Sweep a moving AABB along a displacement against a static AABB (boxes that already overlap do not hit)
+    SweepResult sweepAABB(const AABB &moving, const sf::Vector3f &displacement, const AABB &target);
+
+    // 4x4 matrix in column-major order, the layout OpenGL uses
+    using Matrix4 = std::array<float, 16>;
+
+    // Multiply two matrices (a * b, b is applied first)
+    Matrix4 multiply(const Matrix4 &a, const Matrix4 &b);
+
+    // Projection matrix of glFrustum for a vertical field of view in degrees (as set by Projection::setPerspectiveMatrix)
+    Matrix4 perspectiveMatrix(float fov, float aspectRatio, float nearPlane, float farPlane);
+
+    // View matrix of a camera at a position turned by yaw then pitch in degrees (as set by Player::apply)
+    Matrix4 viewMatrix(const sf::Vector3f &position, float yaw, float pitch);
+
+    // Plane of the points p with dot(normal, p) + distance = 0, the normal points to the inside
+    struct Plane {
+        sf::Vector3f normal;
+        float distance = 0.0f;
+    };
+
+    // View frustum as six inward facing planes: left, right, bottom, top, near, far
+    struct Frustum {
+        std::array<Plane, 6> planes;
+
+        // Extract the planes of a projection * view matrix
+        static Frustum fromMatrix(const Matrix4 &viewProjection);
+
+        // Check if a box is at least partly inside. Conservative: a box just outside a corner of the
+        // frustum can still pass, a box inside never fails.
+        [[nodiscard]] bool intersects(const AABB &box) const;
+    };
 }
 
 namespace std {
@@ -1,13 +1,200 @@
 #include "PerlinNoise.h"
 
-// Initialize the permutation vector with the reference values
+#if defined(__AVX2__)
+#define PERLIN_NOISE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PERLIN_NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Float versions of the helpers, written in the same order as the vector code below so every path
+    // rounds the same way
+    float fadeFloat(float t) {
+        return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+    }
+
+    float lerpFloat(float t, float a, float b) {
+        return a + t * (b - a);
+    }
+
+    float gradFloat(int hash, float x, float y, float z) {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    // Lattice position and fade of the coordinates that are the same for a whole row of samples
+    struct RowCoordinates {
+        int Y, Z;
+        float y, z;  // Relative position in the unit cube
+        float v, w;  // Fade curves
+    };
+
+#if defined(PERLIN_NOISE_AVX2)
+    __m256i gather(const int* table, __m256i index) {
+        return _mm256_i32gather_epi32(table, index, 4);
+    }
+
+    __m256 select(__m256 mask, __m256 a, __m256 b) {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+
+    __m256 fade(__m256 t) {
+        __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    __m256 lerp(__m256 t, __m256 a, __m256 b) {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    __m256 grad(__m256i hash, __m256 x, __m256 y, __m256 z) {
+        __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+        __m256 below8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+        __m256 below4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+        __m256 useX = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                          _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+        __m256 u = select(below8, x, y);
+        __m256 v = select(below4, y, select(useX, x, z));
+
+        // Bits 0 and 1 of the hash flip the signs of u and v
+        __m256 flipU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+        __m256 flipV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+        return _mm256_add_ps(_mm256_xor_ps(u, flipU), _mm256_xor_ps(v, flipV));
+    }
+
+    // Fill as many samples of a row as fit in whole vectors, return how many were written
+    int noiseRow(const int* p, int startX, int count, float frequency, const RowCoordinates& row, float* out) {
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256 oneF = _mm256_set1_ps(1.0f);
+        const __m256i Y = _mm256_set1_epi32(row.Y), Z = _mm256_set1_epi32(row.Z);
+        const __m256 y0 = _mm256_set1_ps(row.y), y1 = _mm256_set1_ps(row.y - 1.0f);
+        const __m256 z0 = _mm256_set1_ps(row.z), z1 = _mm256_set1_ps(row.z - 1.0f);
+        const __m256 v = _mm256_set1_ps(row.v), w = _mm256_set1_ps(row.w);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256i sample = _mm256_add_epi32(_mm256_set1_epi32(startX + i), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+            __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(sample), _mm256_set1_ps(frequency));
+            __m256 xFloor = _mm256_floor_ps(x);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(xFloor), _mm256_set1_epi32(255));
+            __m256 x0 = _mm256_sub_ps(x, xFloor);
+            __m256 x1 = _mm256_sub_ps(x0, oneF);
+            __m256 u = fade(x0);
+
+            __m256i A = _mm256_add_epi32(gather(p, X), Y);
+            __m256i AA = _mm256_add_epi32(gather(p, A), Z);
+            __m256i AB = _mm256_add_epi32(gather(p, _mm256_add_epi32(A, one)), Z);
+            __m256i B = _mm256_add_epi32(gather(p, _mm256_add_epi32(X, one)), Y);
+            __m256i BA = _mm256_add_epi32(gather(p, B), Z);
+            __m256i BB = _mm256_add_epi32(gather(p, _mm256_add_epi32(B, one)), Z);
+
+            __m256 res = lerp(w, lerp(v, lerp(u, grad(gather(p, AA), x0, y0, z0),
+                                                 grad(gather(p, BA), x1, y0, z0)),
+                                         lerp(u, grad(gather(p, AB), x0, y1, z0),
+                                                 grad(gather(p, BB), x1, y1, z0))),
+                                 lerp(v, lerp(u, grad(gather(p, _mm256_add_epi32(AA, one)), x0, y0, z1),
+                                                 grad(gather(p, _mm256_add_epi32(BA, one)), x1, y0, z1)),
+                                         lerp(u, grad(gather(p, _mm256_add_epi32(AB, one)), x0, y1, z1),
+                                                 grad(gather(p, _mm256_add_epi32(BB, one)), x1, y1, z1))));
+            _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_add_ps(res, oneF), _mm256_set1_ps(0.5f)));
+        }
+        return i;
+    }
+#elif defined(PERLIN_NOISE_SSE2)
+    // SSE2 has no gather instruction, the table is read one lane at a time
+    __m128i gather(const int* table, __m128i index) {
+        alignas(16) int lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), index);
+        return _mm_setr_epi32(table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]]);
+    }
+
+    __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // SSE2 has no floor instruction: truncate, then step down where that rounded up (negative values)
+    __m128 floorVector(__m128 x) {
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, x), _mm_set1_ps(1.0f)));
+    }
+
+    __m128 fade(__m128 t) {
+        __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    __m128 lerp(__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    __m128 grad(__m128i hash, __m128 x, __m128 y, __m128 z) {
+        __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+        __m128 below8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+        __m128 below4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 useX = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                    _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+        __m128 u = select(below8, x, y);
+        __m128 v = select(below4, y, select(useX, x, z));
+
+        // Bits 0 and 1 of the hash flip the signs of u and v
+        __m128 flipU = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+        __m128 flipV = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+        return _mm_add_ps(_mm_xor_ps(u, flipU), _mm_xor_ps(v, flipV));
+    }
+
+    // Fill as many samples of a row as fit in whole vectors, return how many were written
+    int noiseRow(const int* p, int startX, int count, float frequency, const RowCoordinates& row, float* out) {
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128 oneF = _mm_set1_ps(1.0f);
+        const __m128i Y = _mm_set1_epi32(row.Y), Z = _mm_set1_epi32(row.Z);
+        const __m128 y0 = _mm_set1_ps(row.y), y1 = _mm_set1_ps(row.y - 1.0f);
+        const __m128 z0 = _mm_set1_ps(row.z), z1 = _mm_set1_ps(row.z - 1.0f);
+        const __m128 v = _mm_set1_ps(row.v), w = _mm_set1_ps(row.w);
+
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i sample = _mm_add_epi32(_mm_set1_epi32(startX + i), _mm_setr_epi32(0, 1, 2, 3));
+            __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(sample), _mm_set1_ps(frequency));
+            __m128 xFloor = floorVector(x);
+            __m128i X = _mm_and_si128(_mm_cvttps_epi32(xFloor), _mm_set1_epi32(255));
+            __m128 x0 = _mm_sub_ps(x, xFloor);
+            __m128 x1 = _mm_sub_ps(x0, oneF);
+            __m128 u = fade(x0);
+
+            __m128i A = _mm_add_epi32(gather(p, X), Y);
+            __m128i AA = _mm_add_epi32(gather(p, A), Z);
+            __m128i AB = _mm_add_epi32(gather(p, _mm_add_epi32(A, one)), Z);
+            __m128i B = _mm_add_epi32(gather(p, _mm_add_epi32(X, one)), Y);
+            __m128i BA = _mm_add_epi32(gather(p, B), Z);
+            __m128i BB = _mm_add_epi32(gather(p, _mm_add_epi32(B, one)), Z);
+
+            __m128 res = lerp(w, lerp(v, lerp(u, grad(gather(p, AA), x0, y0, z0),
+                                                 grad(gather(p, BA), x1, y0, z0)),
+                                         lerp(u, grad(gather(p, AB), x0, y1, z0),
+                                                 grad(gather(p, BB), x1, y1, z0))),
+                                 lerp(v, lerp(u, grad(gather(p, _mm_add_epi32(AA, one)), x0, y0, z1),
+                                                 grad(gather(p, _mm_add_epi32(BA, one)), x1, y0, z1)),
+                                         lerp(u, grad(gather(p, _mm_add_epi32(AB, one)), x0, y1, z1),
+                                                 grad(gather(p, _mm_add_epi32(BB, one)), x1, y1, z1))));
+            _mm_storeu_ps(out + i, _mm_mul_ps(_mm_add_ps(res, oneF), _mm_set1_ps(0.5f)));
+        }
+        return i;
+    }
+#else
+    // No vector unit: every sample goes through noiseFloat
+    int noiseRow(const int*, int, int, float, const RowCoordinates&, float*) {
+        return 0;
+    }
+#endif
+}
+
+// Initialize the permutation vector from the seed
 PerlinNoise::PerlinNoise(unsigned int seed) {
-    p.resize(256);
-    std::iota(p.begin(), p.end(), 0);  // Fill with values 0 to 255
-    std::random_device rd;
-    std::mt19937 generator(seed);
-    std::shuffle(p.begin(), p.end(), generator);
-    p.insert(p.end(), p.begin(), p.end());  // Duplicate the vector
+    reseed(seed);
 }
 
 // Perlin noise function
@@ -47,6 +234,62 @@ double PerlinNoise::noise(double x, double y, double z) const {
     return (res + 1.0) / 2.0;  // Normalize the result to the range [0, 1]
 }
 
+// Fill a grid of samples, a row at a time
+void PerlinNoise::noiseGrid(int startX, int startY, int width, int height, float frequency, float z, float* out) const {
+    RowCoordinates row{};
+    float zFloor = std::floor(z);
+    row.Z = static_cast<int>(zFloor) & 255;
+    row.z = z - zFloor;
+    row.w = fadeFloat(row.z);
+
+    for (int j = 0; j < height; j++) {
+        float y = static_cast<float>(startY + j) * frequency;
+        float yFloor = std::floor(y);
+        row.Y = static_cast<int>(yFloor) & 255;
+        row.y = y - yFloor;
+        row.v = fadeFloat(row.y);
+
+        float* rowOut = out + j * width;
+        int i = noiseRow(p.data(), startX, width, frequency, row, rowOut);
+        for (; i < width; i++) {
+            rowOut[i] = noiseFloat(static_cast<float>(startX + i) * frequency, y, z);
+        }
+    }
+}
+
+// Perlin noise function evaluated in float
+float PerlinNoise::noiseFloat(float x, float y, float z) const {
+    float xFloor = std::floor(x), yFloor = std::floor(y), zFloor = std::floor(z);
+    int X = static_cast<int>(xFloor) & 255;
+    int Y = static_cast<int>(yFloor) & 255;
+    int Z = static_cast<int>(zFloor) & 255;
+
+    x -= xFloor;
+    y -= yFloor;
+    z -= zFloor;
+
+    float u = fadeFloat(x);
+    float v = fadeFloat(y);
+    float w = fadeFloat(z);
+
+    int A = p[X] + Y;
+    int AA = p[A] + Z;
+    int AB = p[A + 1] + Z;
+    int B = p[X + 1] + Y;
+    int BA = p[B] + Z;
+    int BB = p[B + 1] + Z;
+
+    float res = lerpFloat(w, lerpFloat(v, lerpFloat(u, gradFloat(p[AA], x, y, z),
+                                                       gradFloat(p[BA], x - 1, y, z)),
+                                          lerpFloat(u, gradFloat(p[AB], x, y - 1, z),
+                                                       gradFloat(p[BB], x - 1, y - 1, z))),
+                             lerpFloat(v, lerpFloat(u, gradFloat(p[AA + 1], x, y, z - 1),
+                                                       gradFloat(p[BA + 1], x - 1, y, z - 1)),
+                                          lerpFloat(u, gradFloat(p[AB + 1], x, y - 1, z - 1),
+                                                       gradFloat(p[BB + 1], x - 1, y - 1, z - 1))));
+    return (res + 1.0f) * 0.5f;
+}
+
 // Fade function as defined by Ken Perlin
 double PerlinNoise::fade(double t) const {
     return t * t * t * (t * (t * 6 - 15) + 10);
@@ -66,9 +309,16 @@ double PerlinNoise::grad(int hash, double x, double y, double z) const {
     return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
 }
 
-// Reseed the permutation vector
+// Reseed the permutation vector. The shuffle is written out instead of using std::shuffle, whose
+// algorithm differs between standard libraries, so a seed gives the same terrain on every compiler.
 void PerlinNoise::reseed(unsigned int newSeed) {
+    p.resize(256);
+    std::iota(p.begin(), p.end(), 0);  // Fill with values 0 to 255
+
     std::mt19937 generator(newSeed);
-    std::shuffle(p.begin(), p.end(), generator);
+    for (int i = 255; i > 0; i--) {
+        int j = static_cast<int>(generator() % static_cast<unsigned int>(i + 1));
+        std::swap(p[i], p[j]);
+    }
     p.insert(p.end(), p.begin(), p.end());  // Duplicate the vector
 }
@@ -16,9 +16,17 @@ public:
     // Noise function
     [[nodiscard]] double noise(double x, double y, double z) const;
 
+    // Fill a grid with noise((startX + i) * frequency, (startY + j) * frequency, z), stored row by row in
+    // out[j * width + i]. Evaluated in float, several samples at a time with SSE2 or AVX2 when available;
+    // matches noise() to within float rounding.
+    void noiseGrid(int startX, int startY, int width, int height, float frequency, float z, float* out) const;
+
 private:
     std::vector<int> p;  // Permutation vector
 
+    // Single float sample, used for the samples of a row that do not fill a whole vector
+    [[nodiscard]] float noiseFloat(float x, float y, float z) const;
+
     [[nodiscard]] double fade(double t) const;
     [[nodiscard]] double lerp(double t, double a, double b) const;
     [[nodiscard]] double grad(int hash, double x, double y, double z) const;
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include "Profiler.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PROFILER_USE_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+    // Raw timestamp of a zone: the time stamp counter on x86-64, about half the cost of reading steady_clock,
+    // nanoseconds of steady_clock elsewhere. Timestamps become nanoseconds when the zones are collected.
+    std::uint64_t timestamp() {
+#ifdef PROFILER_USE_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Both clocks when the profiler started, to turn timestamps into nanoseconds since then
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const std::uint64_t startTimestamp = timestamp();
+
+    // Nanoseconds per timestamp tick, measured against steady_clock since the start (over at least 10 ms)
+    double nanosecondsPerTick() {
+#ifdef PROFILER_USE_TSC
+        std::chrono::duration<double, std::nano> elapsed;
+        std::uint64_t ticks;
+        do {
+            elapsed = std::chrono::steady_clock::now() - startTime;
+            ticks = timestamp() - startTimestamp;
+        } while (elapsed.count() < 1e7 || ticks == 0);
+        return elapsed.count() / static_cast<double>(ticks);
+#else
+        return 1.0;
+#endif
+    }
+
+    // One event of a ring. The fields are relaxed atomics so another thread may copy a slot while its thread
+    // overwrites it; the copy is then thrown away (see ThreadBuffer).
+    struct Slot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> end{0};
+        std::atomic<std::uint32_t> depth{0};
+    };
+
+    // Ring of the zones finished by one thread. Only its thread writes the events, as a sequence lock: writing
+    // is raised before an event is written and written after it, so other threads can copy the ring while it
+    // is being filled and drop the events that were overwritten during the copy. The ring is allocated by the
+    // first zone, threads that are only named cost no more than their name.
+    struct ThreadBuffer {
+        std::uint32_t id = 0;
+        std::string name;                        // Guarded by the registry mutex
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<std::uint64_t> writing{0};   // Events started since the thread started
+        std::atomic<std::uint64_t> written{0};   // Events written since the thread started
+        std::atomic<std::uint64_t> cleared{0};   // Events before this one were cleared
+        std::uint32_t depth = 0;                 // Zones open on the thread
+    };
+
+    // Every thread that recorded a zone, kept after the thread exits so its track can still be exported
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+    // Buffer of the calling thread, registered by its first zone or name. The shared pointer keeps it alive until
+    // the thread exits; the plain pointer needs no initialization guard, so the zones read it cheaply.
+    thread_local std::shared_ptr<ThreadBuffer> ownedBuffer;
+    thread_local ThreadBuffer* currentBuffer = nullptr;
+
+    ThreadBuffer& threadBuffer() {
+        if (currentBuffer) return *currentBuffer;
+
+        ownedBuffer = std::make_shared<ThreadBuffer>();
+        currentBuffer = ownedBuffer.get();
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        currentBuffer->id = static_cast<std::uint32_t>(registry.size() + 1);
+        currentBuffer->name = "thread " + std::to_string(currentBuffer->id);
+        registry.push_back(ownedBuffer);
+        return *currentBuffer;
+    }
+
+    // Write a string as a JSON string literal
+    void writeString(std::ostream& output, const std::string& text) {
+        output << '"';
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                output << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                output << escaped;
+            } else {
+                output << c;
+            }
+        }
+        output << '"';
+    }
+}
+
+// Turn the recording on or off
+void Profiler::setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+// Check if zones are recorded
+bool Profiler::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+// Name the track of the calling thread
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+// Forget the zones recorded so far, on every thread
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry) {
+        buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+// Get a copy of the zones recorded on every thread
+std::vector<Profiler::Track> Profiler::collect() {
+    const double scale = nanosecondsPerTick();
+    auto toNanoseconds = [&](std::uint64_t time) {
+        return time > startTimestamp ? static_cast<std::uint64_t>(static_cast<double>(time - startTimestamp) * scale) : 0;
+    };
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::vector<Track> tracks;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : registry) {
+        Track& track = tracks.emplace_back();
+        track.id = buffer->id;
+        track.name = buffer->name;
+
+        std::uint64_t written = buffer->written.load(std::memory_order_acquire);
+        std::uint64_t first = std::max(buffer->cleared.load(std::memory_order_relaxed),
+                                       written > BUFFER_EVENTS ? written - BUFFER_EVENTS : 0);
+        for (std::uint64_t i = first; i < written; i++) {
+            const Slot& slot = buffer->slots[i % BUFFER_EVENTS];
+            track.events.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                                    slot.end.load(std::memory_order_relaxed), slot.depth.load(std::memory_order_relaxed)});
+        }
+
+        // The thread may have gone round the ring over the oldest events while they were copied. The fence pairs
+        // with the one in end(): if a copy saw any field of a newer event, writing already counts that event.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t after = buffer->writing.load(std::memory_order_relaxed);
+        if (after > BUFFER_EVENTS && after - BUFFER_EVENTS > first) {
+            std::uint64_t overwritten = std::min(after - BUFFER_EVENTS - first, written - first);
+            track.events.erase(track.events.begin(), track.events.begin() + static_cast<std::ptrdiff_t>(overwritten));
+        }
+
+        for (Event& event : track.events) {
+            event.start = toNanoseconds(event.start);
+            event.end = toNanoseconds(event.end);
+        }
+    }
+    return tracks;
+}
+
+// Write the recorded zones as Chrome tracing JSON: a complete event ("X") per zone, with its thread as the
+// track, and a metadata event naming each track. Times are in microseconds.
+void Profiler::writeChromeTrace(std::ostream& output) {
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char times[96];
+    for (const Track& track : collect()) {
+        output << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track.id
+               << ",\"args\":{\"name\":";
+        writeString(output, track.name);
+        output << "}}";
+        first = false;
+
+        for (const Event& event : track.events) {
+            output << ",\n{\"name\":";
+            writeString(output, event.name);
+            std::snprintf(times, sizeof(times), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f", event.start / 1000.0,
+                          (event.end - event.start) / 1000.0);
+            output << times << ",\"pid\":1,\"tid\":" << track.id << "}";
+        }
+    }
+    output << "\n]}\n";
+}
+
+// Write the recorded zones as Chrome tracing JSON to a file
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    writeChromeTrace(file);
+    return static_cast<bool>(file);
+}
+
+// Open a zone on the calling thread and get its start time
+std::uint64_t Profiler::begin() {
+    ThreadBuffer& buffer = threadBuffer();
+    if (!buffer.slots) buffer.slots = std::make_unique<Slot[]>(BUFFER_EVENTS);
+    buffer.depth++;
+    return timestamp();
+}
+
+// Close the innermost zone of the calling thread and record it
+void Profiler::end(const char* name, std::uint64_t start) {
+    std::uint64_t endTime = timestamp();
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.depth--;
+
+    // Announce the event before overwriting its slot, then publish it
+    std::uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.writing.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Slot& slot = buffer.slots[index % BUFFER_EVENTS];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(endTime, std::memory_order_relaxed);
+    slot.depth.store(buffer.depth, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+}
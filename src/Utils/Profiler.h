@@ -0,0 +1,95 @@
+#ifndef MINECRAFTCLONE_PROFILER_H
+#define MINECRAFTCLONE_PROFILER_H
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Scoped zone profiler: a Zone times the scope it lives in and records it, with its nesting depth, in a ring
+// buffer owned by the thread that ran it, so recording takes no lock. Each thread shows up as its own track,
+// named with setThreadName. When the profiler is disabled a zone only loads one flag, so zones can stay in
+// hot code. The recorded zones are exported as Chrome tracing JSON (chrome://tracing or ui.perfetto.dev).
+// A thread keeps its last BUFFER_EVENTS zones; older ones are overwritten.
+class Profiler {
+public:
+    static constexpr std::size_t BUFFER_EVENTS = 1 << 16;
+
+    // A finished zone, times in nanoseconds since the profiler started (the ring keeps raw timestamps, they
+    // are converted when collected)
+    struct Event {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+        std::uint32_t depth;  // Zones open around it on the same thread
+    };
+
+    // The zones recorded by one thread, in the order they finished
+    struct Track {
+        std::uint32_t id;
+        std::string name;
+        std::vector<Event> events;
+    };
+
+    // Times the scope it lives in (name must outlive the export, a string literal)
+    class Zone {
+    public:
+        explicit Zone(const char* name) : name(enabled.load(std::memory_order_relaxed) ? name : nullptr) {
+            if (this->name) start = begin();
+        }
+
+        ~Zone() {
+            if (name) end(name, start);
+        }
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t start = 0;
+    };
+
+    // Turn the recording on or off (zones already open when it is turned off are still recorded)
+    static void setEnabled(bool on);
+
+    // Check if zones are recorded
+    [[nodiscard]] static bool isEnabled();
+
+    // Name the track of the calling thread
+    static void setThreadName(const std::string& name);
+
+    // Forget the zones recorded so far, on every thread
+    static void clear();
+
+    // Get a copy of the zones recorded on every thread, also while they record (zones overwritten while they
+    // are copied are left out)
+    [[nodiscard]] static std::vector<Track> collect();
+
+    // Write the recorded zones as Chrome tracing JSON, one track per thread
+    static void writeChromeTrace(std::ostream& output);
+
+    // Write the recorded zones as Chrome tracing JSON to a file, returns false if it cannot be written
+    static bool writeChromeTrace(const std::string& path);
+
+private:
+    static inline std::atomic<bool> enabled{false};
+
+    // Open a zone on the calling thread and get its start timestamp
+    static std::uint64_t begin();
+
+    // Close the innermost zone of the calling thread and record it
+    static void end(const char* name, std::uint64_t start);
+};
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// Time the rest of the enclosing scope as a zone
+#define PROFILE_ZONE(name) Profiler::Zone PROFILER_CONCAT(profileZone, __LINE__)(name)
+
+
+#endif
@@ -0,0 +1,68 @@
+#include "RingAllocator.h"
+
+RingAllocator::RingAllocator(std::size_t capacity, std::size_t alignment) : capacity(capacity), alignment(alignment) {}
+
+// Allocate size bytes, or nothing if the ring has no room
+std::optional<std::size_t> RingAllocator::allocate(std::size_t size) {
+    std::size_t aligned = (size + alignment - 1) & ~(alignment - 1);
+    if (aligned == 0 || aligned > capacity) return std::nullopt;
+
+    // An empty ring with no fence left starts over at its beginning, so it has room for the largest allocation
+    if (used == 0 && fences.empty()) head = tail = 0;
+
+    std::size_t offset;
+    std::size_t skipped = 0;
+    if (head >= tail && used < capacity) {
+        // The free space is after the head and before the tail
+        if (capacity - head >= aligned) {
+            offset = head;
+        } else if (tail >= aligned) {
+            skipped = capacity - head;  // The end of the ring is too short, wrap around
+            offset = 0;
+        } else {
+            return std::nullopt;
+        }
+    } else {
+        // Wrapped: the free space is between the head and the tail
+        if (used == capacity || tail - head < aligned) return std::nullopt;
+        offset = head;
+    }
+
+    head = offset + aligned;
+    if (head == capacity) head = 0;
+    used += skipped + aligned;
+    unfenced += skipped + aligned;
+    return offset;
+}
+
+// Close the allocations made since the previous fence and get its token
+std::uint64_t RingAllocator::fence() {
+    std::uint64_t token = nextToken++;
+    fences.push_back({token, head, unfenced});
+    unfenced = 0;
+    return token;
+}
+
+// Free the allocations of every fence up to token
+void RingAllocator::retire(std::uint64_t token) {
+    while (!fences.empty() && fences.front().token <= token) {
+        tail = fences.front().end;
+        used -= fences.front().bytes;
+        fences.pop_front();
+    }
+}
+
+// Get the token of the oldest fence not retired yet
+std::optional<std::uint64_t> RingAllocator::getOldestFence() const {
+    if (fences.empty()) return std::nullopt;
+    return fences.front().token;
+}
+
+std::size_t RingAllocator::getCapacity() const {
+    return capacity;
+}
+
+// Get the bytes in use
+std::size_t RingAllocator::getUsed() const {
+    return used;
+}
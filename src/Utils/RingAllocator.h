@@ -0,0 +1,56 @@
+#ifndef MINECRAFTCLONE_RINGALLOCATOR_H
+#define MINECRAFTCLONE_RINGALLOCATOR_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+// Hands out ranges of a fixed size buffer in a ring, for data written once by the CPU and read later by
+// the GPU. Allocations are grouped by fences: fence() closes the allocations made since the previous one
+// and returns its token, and retire(token) frees every allocation up to that fence once the GPU is done
+// with them. Allocations are freed in the order they were made, so the ring only needs a head and a tail.
+// Holds no GL state: the renderer maps the tokens to GL fences.
+class RingAllocator {
+public:
+    // Ring of capacity bytes, allocations start on multiples of alignment (a power of two)
+    explicit RingAllocator(std::size_t capacity, std::size_t alignment = 16);
+
+    // Allocate size bytes, returns the offset or nothing if the ring has no room until a fence is retired
+    std::optional<std::size_t> allocate(std::size_t size);
+
+    // Close the allocations made since the previous fence (none is fine) and get the token of the fence
+    std::uint64_t fence();
+
+    // Free the allocations of every fence up to token
+    void retire(std::uint64_t token);
+
+    // Get the token of the oldest fence not retired yet (nothing if every fence is retired)
+    [[nodiscard]] std::optional<std::uint64_t> getOldestFence() const;
+
+    [[nodiscard]] std::size_t getCapacity() const;
+
+    // Get the bytes in use, including the end of the ring skipped by allocations that wrapped around
+    [[nodiscard]] std::size_t getUsed() const;
+
+private:
+    // Allocations closed by a fence: the ring up to end and the bytes they hold
+    struct Fence {
+        std::uint64_t token;
+        std::size_t end;
+        std::size_t bytes;
+    };
+
+    std::size_t capacity;
+    std::size_t alignment;
+    std::size_t head = 0;          // Offset of the next allocation
+    std::size_t tail = 0;          // Offset of the oldest allocation in use
+    std::size_t used = 0;          // Bytes from tail to head
+    std::size_t unfenced = 0;      // Bytes allocated since the last fence
+    std::uint64_t nextToken = 1;
+    std::deque<Fence> fences;
+};
+
+
+#endif
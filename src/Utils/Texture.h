@@ -3,17 +3,12 @@
 
 
 #include <SFML/Graphics.hpp>
-#include "../Core/Block.h"
 
 class Texture {
 public:
     static sf::Texture atlas;
 
     static void loadTextures();
-
-    static std::pair<std::vector<sf::IntRect>, std::vector<int>> initTextures(BlockType type);
-
-    static sf::IntRect getTextureCoords(const std::string& name);
 };
 
 